@@ -2,9 +2,14 @@
 
 #include "abb.h"
 #include "pila.h"
+#include "pool.h"
 #include <stdlib.h>
 #include <string.h>
 
+// Cota de la altura de un AVL con menos de 2^64 nodos (1.44 * log2(n) + 2), usada para
+// dimensionar los caminos y pilas de los recorridos iterativos.
+#define ALTURA_MAX 96
+
 /* ******************************************************************
  *                DEFINICION DE LOS TIPOS DE DATOS
  * *****************************************************************/
@@ -14,6 +19,7 @@ typedef struct nodo {
 	struct nodo* der;
 	char* clave;
 	void* dato;
+	int altura;  // Altura del subarbol con raiz en este nodo (una hoja tiene altura 1).
 } nodo_t;
 
 struct abb {
@@ -21,6 +27,8 @@ struct abb {
 	size_t cantidad;
 	abb_destruir_dato_t func_dest;
 	abb_comparar_clave_t func_cmp;
+	bool copiar_claves;  // Si es false, las claves son del usuario del abb y no se copian ni liberan.
+	pool_t* nodos;       // De donde se piden los nodos, para liberarlos todos juntos al destruir.
 };
 
 struct abb_iter {
@@ -32,109 +40,136 @@ struct abb_iter {
  *                    FUNCIONES AUXILIARES
  * *****************************************************************/
 
-/* PRE: Recibe la clave y un dato.
- * POST: Devuelve un nodo que contiene una copia de la clave y el dato.
+/* PRE: Recibe el arbol, la clave y un dato.
+ * POST: Devuelve un nodo que contiene una copia de la clave (o la misma clave, si el
+ * arbol usa claves externas) y el dato.
  */
-nodo_t* nodo_crear(const char* clave, void* dato) {
-	nodo_t* nodo = malloc(sizeof(nodo_t));
+nodo_t* nodo_crear(const abb_t* arbol, const char* clave, void* dato) {
+	nodo_t* nodo = pool_pedir(arbol->nodos);
 	if (!nodo) return NULL;
-	nodo->clave = strdup(clave);
+	nodo->clave = arbol->copiar_claves ? strdup(clave) : (char*)clave;
 	if (!nodo->clave) {
-		free(nodo);
+		pool_devolver(arbol->nodos, nodo);
 		return NULL;
 	}
 	nodo->dato = dato;
 	nodo->izq = NULL;
 	nodo->der = NULL;
+	nodo->altura = 1;
 	return nodo;
 }
 
-/* PRE: Recibe un nodo previamente creado.
- * POST: Libera la clave y el nodo.
+/* PRE: Recibe el arbol y un nodo previamente creado.
+ * POST: Libera la clave (si es una copia) y devuelve el nodo al pool.
  */
-void nodo_destruir(nodo_t* nodo) {
-	free(nodo->clave);
-	free(nodo);
+void nodo_destruir(const abb_t* arbol, nodo_t* nodo) {
+	if (arbol->copiar_claves) free(nodo->clave);
+	pool_devolver(arbol->nodos, nodo);
 }
 
 /* PRE: Recibe un nodo, la funcion de comparacion del arbol y la clave a buscar.
- * POST: Busca el elemento en el arbol. Si esta, devuelve el nodo y su padre, o
- * quien deberia serlo si lo queremos guardar. Si no esta, devuelve NULL.
+ * POST: Devuelve el nodo con esa clave en el subarbol, o NULL si no esta.
  */
-nodo_t* abb_buscar(nodo_t* nodo, nodo_t** padre, abb_comparar_clave_t cmp, const char* clave, bool guardar_padre) {
-	if (!nodo) return NULL;
-	int comp = cmp(nodo->clave, clave);
-	if (comp == 0) return nodo;
-	if (guardar_padre) *padre = nodo;
-	if (comp > 0) return abb_buscar(nodo->izq, padre, cmp, clave, guardar_padre);
-	return abb_buscar(nodo->der, padre, cmp, clave, guardar_padre);
+nodo_t* abb_buscar(nodo_t* nodo, abb_comparar_clave_t cmp, const char* clave) {
+	while (nodo) {
+		int comp = cmp(nodo->clave, clave);
+		if (comp == 0) return nodo;
+		nodo = comp > 0 ? nodo->izq : nodo->der;
+	}
+	return NULL;
 }
 
-/* PRE: Recibe un nodo que es hijo derecho.
- * POST: Busca el minimo de los mayores siguientes.
- */  
-nodo_t* abb_buscar_reemplazo(nodo_t* nodo) { 
-	while (nodo->der) {
-		nodo = nodo->der;
-	}
-	return nodo;
+// Devuelve la altura del subarbol (0 si es vacio).
+int nodo_altura(const nodo_t* nodo) {
+	return nodo ? nodo->altura : 0;
+}
+
+// Recalcula la altura del nodo a partir de la de sus hijos.
+void nodo_actualizar_altura(nodo_t* nodo) {
+	int altura_izq = nodo_altura(nodo->izq);
+	int altura_der = nodo_altura(nodo->der);
+	nodo->altura = (altura_izq > altura_der ? altura_izq : altura_der) + 1;
 }
 
-/* PRE: Recibe un arbol, una clave, un nodo y su padre.
- * POST: Borra elemento de 0 o 1 hijos, y devuelve su dato.
+/* PRE: Recibe un nodo con hijo izquierdo.
+ * POST: Rota el subarbol a derecha y devuelve su nueva raiz.
  */
-void* abb_borrar_0_1_hijos(abb_t* arbol, const char* clave, nodo_t* borrado, nodo_t* padre) {
-	if (!padre) {
-		if (borrado->der) arbol->raiz = borrado->der;
-		else arbol->raiz = borrado->izq;
-	} else {
-		if (padre->izq == borrado) {
-			if (borrado->izq) padre->izq = borrado->izq;
-			else padre->izq = borrado->der;
-		} else {
-			if (borrado->der) padre->der = borrado->der;
-			else padre->der = borrado->izq;
-		}
+nodo_t* nodo_rotar_derecha(nodo_t* nodo) {
+	nodo_t* raiz = nodo->izq;
+	nodo->izq = raiz->der;
+	raiz->der = nodo;
+	nodo_actualizar_altura(nodo);
+	nodo_actualizar_altura(raiz);
+	return raiz;
+}
+
+/* PRE: Recibe un nodo con hijo derecho.
+ * POST: Rota el subarbol a izquierda y devuelve su nueva raiz.
+ */
+nodo_t* nodo_rotar_izquierda(nodo_t* nodo) {
+	nodo_t* raiz = nodo->der;
+	nodo->der = raiz->izq;
+	raiz->izq = nodo;
+	nodo_actualizar_altura(nodo);
+	nodo_actualizar_altura(raiz);
+	return raiz;
+}
+
+/* PRE: Recibe un nodo cuyos subarboles son AVL y difieren en altura a lo sumo en 2.
+ * POST: Devuelve la raiz del subarbol rebalanceado (condicion AVL: en todo nodo las
+ * alturas de los hijos difieren a lo sumo en 1), con las alturas actualizadas.
+ */
+nodo_t* nodo_balancear(nodo_t* nodo) {
+	nodo_actualizar_altura(nodo);
+	int balance = nodo_altura(nodo->izq) - nodo_altura(nodo->der);
+	if (balance > 1) {
+		if (nodo_altura(nodo->izq->izq) < nodo_altura(nodo->izq->der)) nodo->izq = nodo_rotar_izquierda(nodo->izq);
+		return nodo_rotar_derecha(nodo);
 	}
-	void* dato = borrado->dato;
-	nodo_destruir(borrado);
-	arbol->cantidad--;
-	return dato;
+	if (balance < -1) {
+		if (nodo_altura(nodo->der->der) < nodo_altura(nodo->der->izq)) nodo->der = nodo_rotar_derecha(nodo->der);
+		return nodo_rotar_izquierda(nodo);
+	}
+	return nodo;
 }
 
-/* PRE: Recibe un arbol, una clave y un nodo.
- * POST: Borra el elemento de 2 hijos, y devuelve su dato.
+/* PRE: Recibe un camino de enlaces (punteros a la raiz o al hijo de un nodo), desde la
+ * raiz hacia abajo, y su largo.
+ * POST: Rebalancea de abajo hacia arriba el subarbol de cada enlace del camino.
  */
-void* abb_borrar_2_hijos(abb_t* arbol, const char* clave, nodo_t* borrado) {
-	void* dato = borrado->dato;
-	nodo_t* reemplazo = abb_buscar_reemplazo(borrado->izq);
-	void* dato_reemplazo = reemplazo->dato;
-	char* clave_reemplazo = strdup(reemplazo->clave);
-	abb_borrar(arbol,reemplazo->clave);
-	free(borrado->clave);
-	borrado->dato = dato_reemplazo;
-	borrado->clave = clave_reemplazo;
-	return dato;
+void camino_balancear(nodo_t** camino[], size_t largo) {
+	while (largo) {
+		largo--;
+		*camino[largo] = nodo_balancear(*camino[largo]);
+	}
 }
 
-/* PRE: Recibe un nodo y la funcion para destruir los datos del arbol (si la tiene).
- * POST: Se llama recursivamente hasta destruir todos los nodos.
+/* PRE: Recibe el arbol y un nodo.
+ * POST: Llama a la funcion de destruccion del arbol para cada dato y libera las claves
+ * copiadas, sin devolver los nodos al pool. Recorre el arbol rotando a derecha hasta que
+ * cada nodo no tiene hijo izquierdo, por lo que no usa memoria adicional y deja el arbol
+ * inutilizable.
  */
-void destruir_nodos(nodo_t* nodo, abb_destruir_dato_t func_dest) {
-	if (!nodo) return;
-	destruir_nodos(nodo->izq, func_dest);
-	destruir_nodos(nodo->der, func_dest);
-	if (func_dest) func_dest(nodo->dato);
-	nodo_destruir(nodo);
+void destruir_nodos(const abb_t* arbol, nodo_t* nodo) {
+	while (nodo) {
+		if (nodo->izq) {
+			nodo_t* izq = nodo->izq;
+			nodo->izq = izq->der;
+			izq->der = nodo;
+			nodo = izq;
+			continue;
+		}
+		if (arbol->func_dest) arbol->func_dest(nodo->dato);
+		if (arbol->copiar_claves) free(nodo->clave);
+		nodo = nodo->der;
+	}
 }
 
 /* PRE: Recibe un iterador y un nodo actual.
- * POST: Se llama recursivamente apilando todos los hijos izquierdos hasta que no haya.
+ * POST: Apila el nodo y todos sus descendientes izquierdos.
  */
 void apilar(abb_iter_t* iter, nodo_t* nodo) {
-	if (!nodo) return;
-	pila_apilar(iter->pila,nodo);
-	apilar(iter,nodo->izq);
+	for (; nodo; nodo = nodo->izq) pila_apilar(iter->pila, nodo);
 }
 
 
@@ -145,53 +180,95 @@ void apilar(abb_iter_t* iter, nodo_t* nodo) {
 abb_t* abb_crear(abb_comparar_clave_t cmp, abb_destruir_dato_t destruir_dato) {
 	abb_t* arbol = malloc(sizeof(abb_t));
 	if (!arbol) return NULL;
+	arbol->nodos = pool_crear(sizeof(nodo_t));
+	if (!arbol->nodos) {
+		free(arbol);
+		return NULL;
+	}
 	arbol->raiz = NULL;
 	arbol->cantidad = 0;
 	arbol->func_dest = destruir_dato;
 	arbol->func_cmp = cmp;
+	arbol->copiar_claves = true;
+	return arbol;
+}
+
+abb_t* abb_crear_claves_externas(abb_comparar_clave_t cmp, abb_destruir_dato_t destruir_dato) {
+	abb_t* arbol = abb_crear(cmp, destruir_dato);
+	if (!arbol) return NULL;
+	arbol->copiar_claves = false;
 	return arbol;
 }
 
 bool abb_guardar(abb_t *arbol, const char *clave, void *dato) {
-	nodo_t* padre = NULL;
-	nodo_t* nodo = abb_buscar(arbol->raiz, &padre, arbol->func_cmp, clave, true);
-	if (!nodo) {
-		nodo_t* nodo_nuevo = nodo_crear(clave, dato);
-		if (!nodo_nuevo) return false;
-		if (!padre) arbol->raiz = nodo_nuevo;
-		else {
-			if (arbol->func_cmp(padre->clave, clave) > 0) padre->izq = nodo_nuevo;
-			else padre->der = nodo_nuevo;
+	nodo_t** camino[ALTURA_MAX];
+	size_t largo = 0;
+	nodo_t** enlace = &arbol->raiz;
+	while (*enlace) {
+		int comp = arbol->func_cmp((*enlace)->clave, clave);
+		if (comp == 0) {
+			if (arbol->func_dest) arbol->func_dest((*enlace)->dato);
+			(*enlace)->dato = dato;
+			return true;
 		}
-		arbol->cantidad++;
-	} else {
-		if (arbol->func_dest) arbol->func_dest(nodo->dato);
-		nodo->dato = dato;
+		camino[largo++] = enlace;
+		enlace = comp > 0 ? &(*enlace)->izq : &(*enlace)->der;
 	}
+	nodo_t* nodo_nuevo = nodo_crear(arbol, clave, dato);
+	if (!nodo_nuevo) return false;
+	*enlace = nodo_nuevo;
+	arbol->cantidad++;
+	camino_balancear(camino, largo);
 	return true;
 }
 
 void *abb_borrar(abb_t *arbol, const char *clave) {
-	nodo_t* padre = NULL;
-	nodo_t* nodo = abb_buscar(arbol->raiz, &padre, arbol->func_cmp, clave, true);
-	if (!nodo) return NULL;
-	void* dato;
-	if (nodo->izq == NULL || nodo->der == NULL) {
-		dato = abb_borrar_0_1_hijos(arbol, clave, nodo, padre);
+	nodo_t** camino[ALTURA_MAX];
+	size_t largo = 0;
+	nodo_t** enlace = &arbol->raiz;
+	while (*enlace) {
+		int comp = arbol->func_cmp((*enlace)->clave, clave);
+		if (comp == 0) break;
+		camino[largo++] = enlace;
+		enlace = comp > 0 ? &(*enlace)->izq : &(*enlace)->der;
+	}
+	nodo_t* borrado = *enlace;
+	if (!borrado) return NULL;
+
+	if (!borrado->izq || !borrado->der) {
+		*enlace = borrado->izq ? borrado->izq : borrado->der;
 	} else {
-		dato = abb_borrar_2_hijos(arbol, clave, nodo);
+		// Se reemplaza por el maximo del subarbol izquierdo, moviendo el nodo (sin copiar su clave).
+		size_t pos_borrado = largo;
+		camino[largo++] = enlace;
+		nodo_t** enlace_maximo = &borrado->izq;
+		while ((*enlace_maximo)->der) {
+			camino[largo++] = enlace_maximo;
+			enlace_maximo = &(*enlace_maximo)->der;
+		}
+		nodo_t* maximo = *enlace_maximo;
+		*enlace_maximo = maximo->izq;
+		maximo->izq = borrado->izq;
+		maximo->der = borrado->der;
+		*enlace = maximo;
+		// El enlace al subarbol izquierdo ahora es el del nodo que tomo el lugar del borrado.
+		if (largo > pos_borrado + 1) camino[pos_borrado + 1] = &maximo->izq;
 	}
+	void* dato = borrado->dato;
+	nodo_destruir(arbol, borrado);
+	arbol->cantidad--;
+	camino_balancear(camino, largo);
 	return dato;
 }
 
 void *abb_obtener(const abb_t *arbol, const char *clave) {
-	nodo_t* nodo = abb_buscar(arbol->raiz, NULL, arbol->func_cmp, clave, false);
+	nodo_t* nodo = abb_buscar(arbol->raiz, arbol->func_cmp, clave);
 	if (!nodo) return NULL;
 	return nodo->dato;
 }
 
 bool abb_pertenece(const abb_t *arbol, const char *clave) {
-	return abb_buscar(arbol->raiz, NULL, arbol->func_cmp, clave, false);
+	return abb_buscar(arbol->raiz, arbol->func_cmp, clave);
 }
 
 size_t abb_cantidad(const abb_t *arbol) {
@@ -199,7 +276,9 @@ size_t abb_cantidad(const abb_t *arbol) {
 }
 
 void abb_destruir(abb_t *arbol) {
-	destruir_nodos(arbol->raiz, arbol->func_dest);
+	// Si no hay datos ni claves que liberar, basta con liberar los bloques del pool.
+	if (arbol->func_dest || arbol->copiar_claves) destruir_nodos(arbol, arbol->raiz);
+	pool_destruir(arbol->nodos);
 	free(arbol);
 }
 
@@ -208,16 +287,16 @@ void abb_destruir(abb_t *arbol) {
  *                    PRIMITIVA DEL ITERADOR INTERNO
  * *****************************************************************/
 
-bool _abb_in_order(nodo_t* nodo, bool visitar(const char *, void *, void *), void *extra) {
-	if (!nodo) return true;
-	if (!_abb_in_order(nodo->izq, visitar, extra)) return false;
-	if (!visitar(nodo->clave, nodo->dato, extra)) return false;
-	if (!_abb_in_order(nodo->der, visitar, extra)) return false;
-	return true;
-}
-
 void abb_in_order(abb_t *arbol, bool visitar(const char *, void *, void *), void *extra) {
-	_abb_in_order(arbol->raiz, visitar, extra);
+	nodo_t* pila[ALTURA_MAX];
+	size_t tope = 0;
+	nodo_t* nodo = arbol->raiz;
+	while (nodo || tope) {
+		for (; nodo; nodo = nodo->izq) pila[tope++] = nodo;
+		nodo = pila[--tope];
+		if (!visitar(nodo->clave, nodo->dato, extra)) return;
+		nodo = nodo->der;
+	}
 }
 
 
@@ -239,6 +318,22 @@ abb_iter_t *abb_iter_in_crear(const abb_t *arbol) {
 	return iter;
 }
 
+abb_iter_t *abb_iter_in_crear_desde(const abb_t *arbol, const char *clave) {
+	abb_iter_t* iter = abb_iter_in_crear(arbol);
+	if (!iter) return NULL;
+	// Se descarta lo que apilo abb_iter_in_crear y se apila solo el camino de busqueda:
+	// los nodos mayores o iguales a la clave, que son los que faltan visitar por izquierda.
+	while (!pila_esta_vacia(iter->pila)) pila_desapilar(iter->pila);
+	nodo_t* nodo = arbol->raiz;
+	while (nodo) {
+		int comp = arbol->func_cmp(nodo->clave, clave);
+		if (comp >= 0) pila_apilar(iter->pila, nodo);
+		if (comp == 0) break;
+		nodo = comp > 0 ? nodo->izq : nodo->der;
+	}
+	return iter;
+}
+
 bool abb_iter_in_avanzar(abb_iter_t *iter) {
 	if (abb_iter_in_al_final(iter)) return false;
 	nodo_t* actual = pila_desapilar(iter->pila);
@@ -9,6 +9,10 @@
  *                        TIPOS DE DATOS
  * *****************************************************************/
 
+/* Arbol binario de busqueda balanceado (AVL): guardar, borrar, obtener y pertenece
+ * son O(log n) aunque las claves lleguen ordenadas, y los iteradores recorren las
+ * claves en orden segun la funcion de comparacion.
+ */
 typedef struct abb abb_t;
 typedef struct abb_iter abb_iter_t;
 
@@ -23,6 +27,12 @@ typedef void (*abb_destruir_dato_t) (void *);
 /* Crea el abb*/
 abb_t* abb_crear(abb_comparar_clave_t cmp, abb_destruir_dato_t destruir_dato);
 
+/* Crea un abb que no copia las claves: guarda el puntero recibido en abb_guardar
+ * y no lo libera. Quien guarda una clave debe mantenerla valida (y sin modificar)
+ * mientras este en el arbol.
+ */
+abb_t* abb_crear_claves_externas(abb_comparar_clave_t cmp, abb_destruir_dato_t destruir_dato);
+
 /* Guarda un elemento en el abb, si la clave ya se encuentra en la
  * estructura, la reemplaza. De no poder guardarlo devuelve false.
  * Pre: La estructura abb fue inicializada
@@ -83,6 +93,11 @@ void abb_in_order(abb_t *arbol, bool visitar(const char *, void *, void *), void
 // Crea iterador
 abb_iter_t *abb_iter_in_crear(const abb_t *arbol);
 
+/* Crea un iterador que arranca en la primera clave mayor o igual a clave (segun la
+ * funcion de comparacion del arbol), en O(log n). Si no hay ninguna, arranca al final.
+ */
+abb_iter_t *abb_iter_in_crear_desde(const abb_t *arbol, const char *clave);
+
 // Avanza iterador
 bool abb_iter_in_avanzar(abb_iter_t *iter);
 
@@ -1,14 +1,33 @@
 #define _POSIX_C_SOURCE 200809L
 
 #include <stdlib.h>
-#include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
 #include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "algogram.h"
 #include "usuario.h"
 #include "post.h"
 #include "hash.h"
+#include "feed.h"
+#include "tabla_posts.h"
+#include "nombres.h"
+#include "directorio.h"
+#include "salida.h"
+#include "protocolo.h"
+#include "estadisticas.h"
+#include "instantanea.h"
+#include "bitacora.h"
+#include "sesion.h"
+#include "reparto.h"
+#include "padron.h"
+
+#define SUFIJO_TEMPORAL ".tmp"
 
 
 /* ******************************************************************
@@ -16,49 +35,72 @@
  * *****************************************************************/
 
 struct algogram {
-	hash_t* usuarios;
-	hash_t* posts;
-	char* usuario_loggeado;
+	hash_t* usuarios;        // Claves externas: los nombres internados en la tabla de nombres.
+	nombres_t* nombres;
+	directorio_t* directorio;  // Nombre de cada ID de usuario, para mostrar los likes.
+	tabla_posts_t* posts;
+	feed_t* feed;
+	feed_modo_t modo;
+	repartidor_t* repartidor;  // NULL si en modo push los posts se reparten en el mismo hilo.
+	sesion_t* sesion;          // Sesion del cliente que se esta atendiendo (ver algogram_usar_sesion).
+	sesion_t* sesion_inicial;  // La que se usa si no se elige otra.
 	size_t id_usuario;
 	size_t id_post;
+	salida_t* salida;  // Todas las respuestas se acumulan aca (ver algogram_vaciar_salida).
+	bitacora_t* bitacora;  // NULL si los comandos no se registran.
+	uint64_t secuencia;    // Registros de bitacora incluidos en la instantanea cargada.
+	bool carga_completa;   // Ya se agregaron todos los usuarios del archivo (ver algogram_terminar_carga).
 };
 
+// IDs de los usuarios que likearon un post, juntados antes de escribir la respuesta binaria.
+typedef struct ids_likes {
+	size_t* ids;
+	size_t cantidad;
+	size_t capacidad;
+} ids_likes_t;
+
 
 /* *****************************************************************
  *                    FUNCIONES AUXILIARES
  * *****************************************************************/
 
-/* Devuelve una linea ingresada por entrada estandar, sin el ultimo caracter newline, 
- * en una variable en memoria dinamica.
- */
-char* obtener_linea() {
-	char* linea = NULL;
-	size_t capacidad;
-	if (getline(&linea, &capacidad, stdin) == -1) {
-		free(linea);
-		return NULL;
-	}
-	linea[strcspn(linea, "\n")] = 0;
-	return linea;
-}
-
 // Es un wrapper de la primitiva usuario_destruir para utilizar en la creacion del hash de usuarios.
 void usuario_destruir_wrapper(void* usuario) {
 	usuario_destruir(usuario);
 }
 
-// Es un wrapper de la primitiva post_destruir para utilizar en la creacion del hash de posts.
-void post_destruir_wrapper(void* post){
-	post_destruir(post);
+/* PRE: Recibe una linea (o NULL) y donde guardar el ID leido.
+ * POST: Devuelve true si la linea es exactamente la representacion decimal de un ID
+ * (sin signo, espacios ni ceros a izquierda), guardandolo en id. En caso contrario false.
+ */
+bool parsear_id(const char* linea, size_t* id) {
+	if (!linea || *linea < '0' || *linea > '9') return false;
+	if (linea[0] == '0' && linea[1] != '\0') return false;
+	size_t valor = 0;
+	for (; *linea; linea++) {
+		if (*linea < '0' || *linea > '9') return false;
+		size_t digito = (size_t)(*linea - '0');
+		if (valor > (SIZE_MAX - digito) / 10) return false;
+		valor = valor * 10 + digito;
+	}
+	*id = valor;
+	return true;
+}
+
+/* PRE: Recibe un AlgoGram previamente creado y la linea con el ID de un post.
+ * POST: Devuelve el post correspondiente, o NULL si la linea no es un ID valido o el post no existe.
+ */
+post_t* obtener_post(algogram_t* algogram, const char* linea) {
+	size_t id;
+	if (!parsear_id(linea, &id)) return NULL;
+	return tabla_posts_obtener(algogram->posts, id);
 }
 
 /* PRE: Recibe un AlgoGram previamente creado y un Post previamente creado.
- * POST: Devuelve true si el post se pudo guardar en el hash de posts, en caso contrario false.
+ * POST: Devuelve true si el post se pudo guardar en la tabla de posts, en caso contrario false.
  */
 bool publicar_en_posts(algogram_t* algogram, post_t* post) {
-	char id_post[post_ver_id(post) + 2];
-	sprintf(id_post, "%zu", post_ver_id(post));
-	if (!hash_guardar(algogram->posts, id_post, post)) {
+	if (!tabla_posts_guardar(algogram->posts, post)) {
 		post_destruir(post);
 		return false;
 	}
@@ -72,166 +114,776 @@ size_t calcular_afinidad(size_t id_usuario, size_t id_posteador) {
 	return (size_t)abs((int)id_usuario - (int)id_posteador);
 }
 
-/* PRE: Recibe un AlgoGram previamente creado, un post previamente creado y el ID del posteador.
- * POST: Devuelve true si se pudo guardar el post en los feeds de los demas usuarios, en caso contrario devuelve false.
+/* PRE: Recibe un AlgoGram previamente creado, un post ya guardado en la tabla de posts y el ID
+ * del posteador.
+ * POST: Guardo el post en los feeds de los demas usuarios. Si no hay memoria para algun feed,
+ * ese usuario no lo va a ver (el post ya esta publicado y otros feeds pueden apuntarle, asi
+ * que no se destruye).
  */
-bool publicar_en_usuarios(algogram_t* algogram, post_t* post, size_t id_posteador) {
+void publicar_en_usuarios(algogram_t* algogram, post_t* post, size_t id_posteador) {
 	hash_iter_t* usuarios_iter = hash_iter_crear(algogram->usuarios);
+	if (!usuarios_iter) return;
 	while (!hash_iter_al_final(usuarios_iter)) {
 		const char* nombre = hash_iter_ver_actual(usuarios_iter);
 		usuario_t* usuario = hash_obtener(algogram->usuarios, nombre);
-		if (strcmp(nombre, algogram->usuario_loggeado) != 0) {
-			size_t id_usuario = usuario_obtener_id(usuario);
-			size_t afinidad = calcular_afinidad(id_usuario, id_posteador);
-			if (!usuario_guardar_feed(usuario, post, afinidad)) {
-				post_destruir(post);
-				return false;
-			}
-		}
+		size_t id_usuario = usuario_obtener_id(usuario);
+		if (id_usuario != id_posteador) usuario_guardar_feed(usuario, post, calcular_afinidad(id_usuario, id_posteador));
 		hash_iter_avanzar(usuarios_iter);
 	}
 	hash_iter_destruir(usuarios_iter);
+}
+
+
+/* PRE: Recibe un AlgoGram, el usuario que publica y el texto del post (del que pasa a ser dueño).
+ * POST: Devuelve el post publicado por el usuario, o NULL si no se pudo publicar. Una vez en la
+ * tabla de posts el post queda publicado con su ID, aunque falte memoria para repartirlo: como
+ * en el motor, los feeds que no lo recibieron no lo van a ver.
+ */
+post_t* publicar_post(algogram_t* algogram, usuario_t* posteador, char* texto) {
+	size_t id_posteador = usuario_obtener_id(posteador);
+	post_t* post = texto ? post_crear(usuario_ver_nombre(posteador), id_posteador, texto, algogram->id_post) : NULL;
+	if (!post) {
+		free(texto);
+		return NULL;
+	}
+	if (!publicar_en_posts(algogram, post)) return NULL;
+	algogram->id_post++;
+	if (algogram->modo == FEED_PULL) feed_publicar(algogram->feed, post, id_posteador);
+	else if (algogram->repartidor) repartidor_publicar(algogram->repartidor, post);
+	else publicar_en_usuarios(algogram, post, id_posteador);
+	if (algogram->bitacora) bitacora_registrar_post(algogram->bitacora, id_posteador, post_ver_texto(post));
+	return post;
+}
+
+/* PRE: Recibe un AlgoGram y un usuario.
+ * POST: Devuelve el siguiente post del feed del usuario (que queda visto), o NULL si no hay mas.
+ */
+post_t* obtener_siguiente_post(algogram_t* algogram, usuario_t* usuario) {
+	if (algogram->repartidor) repartidor_esperar(algogram->repartidor);
+	post_t* post = algogram->modo == FEED_PULL ? usuario_ver_post_desde(usuario, algogram->feed) : usuario_ver_post(usuario);
+	if (post && algogram->bitacora) bitacora_registrar_visto(algogram->bitacora, usuario_obtener_id(usuario));
+	return post;
+}
+
+/* PRE: Recibe un AlgoGram, un usuario y un post.
+ * POST: El post quedo likeado por el usuario (si ya lo estaba, no cambia).
+ */
+void likear_post(algogram_t* algogram, usuario_t* usuario, post_t* post) {
+	size_t id_usuario = usuario_obtener_id(usuario);
+	if (!post_esta_likeado(post, id_usuario)) {
+		post_likear(post, id_usuario);
+		if (algogram->bitacora) bitacora_registrar_like(algogram->bitacora, id_usuario, post_ver_id(post));
+	}
+}
+
+/* PRE: Recibe un AlgoGram, un nombre de usuario de largo bytes (no necesita terminar en '\0')
+ * y un ID que no este vigente.
+ * POST: Devuelve true si pudo agregar el usuario con ese ID, en caso contrario false (tambien
+ * si el ID supera COLA_FEED_AFINIDAD_MAX).
+ */
+bool agregar_usuario_con_id(algogram_t* algogram, const char* nombre_usuario, size_t largo, size_t id) {
+	padron_t padron = { algogram->nombres, algogram->directorio, algogram->usuarios, algogram->repartidor };
+	return padron_agregar_usuario(&padron, nombre_usuario, largo, id);
+}
+
+/* PRE: Recibe un AlgoGram y un ID de usuario.
+ * POST: Devuelve el usuario vigente con ese ID, o NULL si el ID no esta vigente.
+ */
+usuario_t* usuario_de_id(const algogram_t* algogram, size_t id) {
+	const char* nombre = directorio_nombre(algogram->directorio, id);
+	return nombre ? hash_obtener(algogram->usuarios, nombre) : NULL;
+}
+
+/* PRE: Recibe un AlgoGram y la salida de la instantanea.
+ * POST: Se escribio el estado completo de AlgoGram, salvo la sesion (ver instantanea.h).
+ */
+void volcar_instantanea(const algogram_t* algogram, salida_t* salida) {
+	if (algogram->repartidor) repartidor_esperar(algogram->repartidor);
+	uint32_t marca_orden = INSTANTANEA_MARCA_ORDEN;
+	salida_bytes(salida, INSTANTANEA_MAGICO, INSTANTANEA_LARGO_MAGICO);
+	salida_entero(salida, INSTANTANEA_VERSION, INSTANTANEA_TAM_U32);
+	salida_bytes(salida, &marca_orden, sizeof(marca_orden));
+	salida_entero(salida, sizeof(size_t), INSTANTANEA_TAM_U8);
+	salida_entero(salida, algogram->modo, INSTANTANEA_TAM_U8);
+	salida_entero(salida, algogram->id_usuario, INSTANTANEA_TAM_U64);
+	salida_entero(salida, directorio_cantidad(algogram->directorio), INSTANTANEA_TAM_U64);
+	salida_entero(salida, algogram->id_post, INSTANTANEA_TAM_U64);
+	salida_entero(salida, algogram->bitacora ? bitacora_secuencia(algogram->bitacora) : algogram->secuencia, INSTANTANEA_TAM_U64);
+	for (size_t id = 0; id < algogram->id_usuario; id++) {
+		const char* nombre = directorio_nombre(algogram->directorio, id);
+		if (!nombre) continue;
+		size_t largo = strlen(nombre);
+		salida_entero(salida, id, INSTANTANEA_TAM_U64);
+		salida_entero(salida, largo, INSTANTANEA_TAM_U32);
+		salida_bytes(salida, nombre, largo + 1);
+	}
+	for (size_t id = 0; id < algogram->id_post; id++) {
+		post_volcar(tabla_posts_obtener(algogram->posts, id), salida);
+	}
+	for (size_t id = 0; id < algogram->id_usuario; id++) {
+		usuario_t* usuario = usuario_de_id(algogram, id);
+		if (usuario) usuario_volcar(usuario, salida);
+	}
+}
+
+/* PRE: Recibe un lector al comienzo de una instantanea y donde guardar los datos del encabezado.
+ * POST: Devuelve true si el encabezado es de una instantanea que se puede cargar en esta
+ * maquina (version, orden de bytes y tamaño de size_t), en caso contrario false.
+ */
+bool leer_encabezado(lector_instantanea_t* lector, feed_modo_t* modo, uint64_t* id_usuario, uint64_t* cant_usuarios, uint64_t* cant_posts, uint64_t* secuencia) {
+	uint32_t marca_orden = INSTANTANEA_MARCA_ORDEN;
+	const char* magico = instantanea_leer_arreglo(lector, INSTANTANEA_LARGO_MAGICO, 1);
+	uint64_t version, tam_size_t, modo_leido;
+	if (!magico || memcmp(magico, INSTANTANEA_MAGICO, INSTANTANEA_LARGO_MAGICO) != 0) return false;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U32, &version) || version != INSTANTANEA_VERSION) return false;
+	const void* marca = instantanea_leer_arreglo(lector, 1, sizeof(marca_orden));
+	if (!marca || memcmp(marca, &marca_orden, sizeof(marca_orden)) != 0) return false;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U8, &tam_size_t) || tam_size_t != sizeof(size_t)) return false;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U8, &modo_leido) || (modo_leido != FEED_PUSH && modo_leido != FEED_PULL)) return false;
+	*modo = modo_leido == FEED_PUSH ? FEED_PUSH : FEED_PULL;
+	return instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, id_usuario) &&
+		instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, cant_usuarios) &&
+		instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, cant_posts) &&
+		instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, secuencia);
+}
+
+/* PRE: Recibe un AlgoGram recien creado en el modo de la instantanea, un lector posicionado
+ * despues del encabezado y los datos del encabezado.
+ * POST: Devuelve true si se restauraron los usuarios, los posts y los feeds, y la instantanea
+ * termina justo despues, en caso contrario false (el AlgoGram queda a medio restaurar).
+ */
+bool restaurar_instantanea(algogram_t* algogram, lector_instantanea_t* lector, uint64_t id_usuario, uint64_t cant_usuarios, uint64_t cant_posts) {
+	if (cant_usuarios > id_usuario || !algogram_reservar_usuarios(algogram, cant_usuarios)) return false;
+	for (uint64_t i = 0; i < cant_usuarios; i++) {
+		uint64_t id, largo;
+		if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, &id)) return false;
+		if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U32, &largo)) return false;
+		const char* nombre = instantanea_leer_arreglo(lector, largo + 1, 1);
+		if (!nombre || nombre[largo] != '\0' || id >= id_usuario || directorio_nombre(algogram->directorio, id)) return false;
+		if (!agregar_usuario_con_id(algogram, nombre, (size_t)largo, id)) return false;
+	}
+	// Si habia nombres repetidos, alguno reemplazo a otro y quedan menos usuarios vigentes.
+	if (directorio_cantidad(algogram->directorio) != cant_usuarios) return false;
+	algogram->id_usuario = id_usuario;
+
+	for (uint64_t id = 0; id < cant_posts; id++) {
+		post_t* post = post_restaurar(lector, id, algogram->directorio);
+		if (!post || !publicar_en_posts(algogram, post)) return false;
+		if (algogram->modo == FEED_PULL && !feed_publicar(algogram->feed, post, post_ver_id_posteador(post))) return false;
+		algogram->id_post++;
+	}
+	for (size_t id = 0; id < algogram->id_usuario; id++) {
+		usuario_t* usuario = usuario_de_id(algogram, id);
+		if (usuario && !usuario_restaurar(usuario, lector, algogram->posts, algogram->id_usuario)) return false;
+	}
+	return lector->actual == lector->fin;
+}
+
+/* PRE: Recibe un registro de la bitacora y un AlgoGram, como funcion aplicar de bitacora_abrir.
+ * POST: Devuelve true si se aplico el comando registrado, false si el registro no es valido.
+ */
+bool aplicar_registro(const registro_bitacora_t* registro, void* extra) {
+	algogram_t* algogram = extra;
+	if (registro->tipo == BITACORA_USUARIO) return algogram_agregar_usuario(algogram, registro->texto);
+	if (registro->tipo == BITACORA_CARGA) {
+		algogram->carga_completa = true;
+		return true;
+	}
+	usuario_t* usuario = usuario_de_id(algogram, registro->id_usuario);
+	if (!usuario) return false;
+	if (registro->tipo == BITACORA_POST) return publicar_post(algogram, usuario, strndup(registro->texto, registro->largo)) != NULL;
+	if (registro->tipo == BITACORA_VISTO) return obtener_siguiente_post(algogram, usuario) != NULL;
+	post_t* post = tabla_posts_obtener(algogram->posts, registro->id_post);
+	if (!post) return false;
+	likear_post(algogram, usuario, post);
+	return true;
+}
+
+/* PRE: Recibe un AlgoGram con bitacora, como funcion de salida_antes_de_escribir.
+ * POST: Confirma los registros de la bitacora antes de que se escriban las respuestas de esos
+ * comandos. Si la bitacora fallo, devuelve false y las respuestas se descartan: un comando que
+ * no quedo registrado nunca se confirma.
+ */
+bool confirmar_bitacora(void* extra) {
+	algogram_t* algogram = extra;
+	if (bitacora_confirmar(algogram->bitacora)) return true;
+	if (!salida_hubo_error(algogram->salida)) fprintf(stderr, "%s", "Error: no se pudo escribir la bitacora\n");
+	return false;
+}
+
+/* PRE: Recibe el ID de un usuario que likeo un post y un ids_likes_t, como funcion visitar del
+ * recorrido de los likes (el nombre no se usa).
+ * POST: Se agrego el ID a los juntados. Devuelve false (y corta el recorrido) si no habia lugar.
+ */
+bool guardar_id_like(size_t id, const char* nombre, void* extra) {
+	(void)nombre;
+	ids_likes_t* ids = extra;
+	if (ids->cantidad == ids->capacidad) return false;
+	ids->ids[ids->cantidad++] = id;
 	return true;
 }
 
+#ifdef ESTADISTICAS
+/* PRE: Recibe una salida, el nombre de un histograma y el histograma.
+ * POST: Escribe una linea con la cantidad de valores, el promedio, el maximo y, para cada
+ * rango no vacio, su inicio y su cantidad (por ejemplo "4-7:12").
+ */
+void escribir_histograma(salida_t* salida, const char* nombre, const histograma_t* histograma) {
+	size_t centesimas = histograma->cantidad ? histograma->suma * 100 / histograma->cantidad : 0;
+	salida_texto(salida, nombre);
+	salida_texto(salida, ": cantidad=");
+	salida_numero(salida, histograma->cantidad);
+	salida_texto(salida, " promedio=");
+	salida_numero(salida, centesimas / 100);
+	salida_texto(salida, centesimas % 100 < 10 ? ".0" : ".");
+	salida_numero(salida, centesimas % 100);
+	salida_texto(salida, " maximo=");
+	salida_numero(salida, histograma->maximo);
+	for (size_t i = 0; i < HISTOGRAMA_RANGOS; i++) {
+		if (!histograma->rangos[i]) continue;
+		size_t inicio = histograma_inicio_rango(i);
+		salida_texto(salida, " ");
+		salida_numero(salida, inicio);
+		if (i == HISTOGRAMA_RANGOS - 1) {
+			salida_texto(salida, "+");
+		} else if (i > 1) {
+			salida_texto(salida, "-");
+			salida_numero(salida, histograma_inicio_rango(i + 1) - 1);
+		}
+		salida_texto(salida, ":");
+		salida_numero(salida, histograma->rangos[i]);
+	}
+	salida_texto(salida, "\n");
+}
+
+/* PRE: Recibe una salida y las latencias de un comando que se ejecuto al menos una vez.
+ * POST: Escribe una linea con la cantidad de ejecuciones y los percentiles 50, 99 y 99.9 y
+ * el maximo de la latencia, en nanosegundos.
+ */
+void escribir_latencias(salida_t* salida, const histograma_latencias_t* latencias) {
+	salida_texto(salida, "latencia_");
+	salida_texto(salida, latencias->nombre);
+	salida_texto(salida, ": cantidad=");
+	salida_numero(salida, latencias->cantidad);
+	salida_texto(salida, " p50=");
+	salida_numero(salida, latencias_percentil(latencias, 0.5));
+	salida_texto(salida, " p99=");
+	salida_numero(salida, latencias_percentil(latencias, 0.99));
+	salida_texto(salida, " p999=");
+	salida_numero(salida, latencias_percentil(latencias, 0.999));
+	salida_texto(salida, " max=");
+	salida_numero(salida, latencias->maximo);
+	salida_texto(salida, "\n");
+}
+
+/* PRE: Recibe un AlgoGram y una salida.
+ * POST: Escribe los contadores acumulados de las estructuras, el estado actual de la tabla
+ * de usuarios, de los feeds del modo push y de los likes de los posts, y las latencias de los
+ * comandos. Los contadores se copian antes de recorrer los usuarios, para que el recorrido no
+ * se cuente a si mismo.
+ */
+void escribir_estadisticas(const algogram_t* algogram, salida_t* salida) {
+	if (algogram->repartidor) repartidor_esperar(algogram->repartidor);
+	estadisticas_t actuales = estadisticas;
+	histograma_t tamanios_feed = { 0 }, likes_por_post = { 0 };
+	hash_iter_t* iter = hash_iter_crear(algogram->usuarios);
+	for (; iter && !hash_iter_al_final(iter); hash_iter_avanzar(iter)) {
+		usuario_t* usuario = hash_obtener(algogram->usuarios, hash_iter_ver_actual(iter));
+		histograma_agregar(&tamanios_feed, usuario_cantidad_feed(usuario));
+	}
+	if (iter) hash_iter_destruir(iter);
+	for (size_t id = 0; id < algogram->id_post; id++) {
+		histograma_agregar(&likes_por_post, post_cantidad_likes(tabla_posts_obtener(algogram->posts, id)));
+	}
+	size_t capacidad, borrados;
+	hash_ver_ocupacion(algogram->usuarios, &capacidad, &borrados);
+
+	escribir_histograma(salida, "hash_sondeos", &actuales.sondeos_hash);
+	salida_texto(salida, "hash_redimensiones: ");
+	salida_numero(salida, actuales.redimensiones_hash);
+	salida_texto(salida, "\nhash_usuarios: cantidad=");
+	salida_numero(salida, hash_cantidad(algogram->usuarios));
+	salida_texto(salida, " capacidad=");
+	salida_numero(salida, capacidad);
+	salida_texto(salida, " borrados=");
+	salida_numero(salida, borrados);
+	salida_texto(salida, "\n");
+	escribir_histograma(salida, "feed_tamanios", &tamanios_feed);
+	escribir_histograma(salida, "feed_subidas", &actuales.subidas_feed);
+	escribir_histograma(salida, "feed_bajadas", &actuales.bajadas_feed);
+	escribir_histograma(salida, "pull_distancias", &actuales.distancias_pull);
+	escribir_histograma(salida, "likes_por_post", &likes_por_post);
+	for (size_t i = 0; i < ESTADISTICAS_COMANDOS; i++) {
+		if (latencias_comandos[i].nombre) escribir_latencias(salida, &latencias_comandos[i]);
+	}
+}
+#endif
+
 
 /* ******************************************************************
  *                    PRIMITIVAS DE ALGOGRAM
  * *****************************************************************/
 
 algogram_t* algogram_crear() {
+	return algogram_crear_con_modo(FEED_PUSH);
+}
+
+algogram_t* algogram_crear_con_modo(feed_modo_t modo) {
 	algogram_t* algogram = malloc(sizeof(algogram_t));
 	if (!algogram) return NULL;
-	hash_t* usuarios = hash_crear(usuario_destruir_wrapper);
+	nombres_t* nombres = nombres_crear();
+	if (!nombres) {
+		free(algogram);
+		return NULL;
+	}
+	algogram->nombres = nombres;
+	hash_t* usuarios = hash_crear_con_opciones(usuario_destruir_wrapper, HASH_INCREMENTAL | HASH_CLAVES_EXTERNAS);
 	if (!usuarios) {
+		nombres_destruir(nombres);
 		free(algogram);
 		return NULL;
 	}
 	algogram->usuarios = usuarios;
-	hash_t* posts = hash_crear(post_destruir_wrapper);
+	tabla_posts_t* posts = tabla_posts_crear();
 	if (!posts) {
+		hash_destruir(usuarios);
+		nombres_destruir(nombres);
 		free(algogram);
-		free(usuarios);
 		return NULL;
 	}
 	algogram->posts = posts;
-	algogram->usuario_loggeado = NULL;
+	directorio_t* directorio = directorio_crear();
+	if (!directorio) {
+		tabla_posts_destruir(posts);
+		hash_destruir(usuarios);
+		nombres_destruir(nombres);
+		free(algogram);
+		return NULL;
+	}
+	algogram->directorio = directorio;
+	feed_t* feed = feed_crear();
+	if (!feed) {
+		directorio_destruir(directorio);
+		tabla_posts_destruir(posts);
+		hash_destruir(usuarios);
+		nombres_destruir(nombres);
+		free(algogram);
+		return NULL;
+	}
+	algogram->feed = feed;
+	salida_t* salida = salida_crear(STDOUT_FILENO);
+	if (!salida) {
+		feed_destruir(feed);
+		directorio_destruir(directorio);
+		tabla_posts_destruir(posts);
+		hash_destruir(usuarios);
+		nombres_destruir(nombres);
+		free(algogram);
+		return NULL;
+	}
+	algogram->salida = salida;
+	sesion_t* sesion = sesion_crear();
+	if (!sesion) {
+		salida_destruir(salida);
+		feed_destruir(feed);
+		directorio_destruir(directorio);
+		tabla_posts_destruir(posts);
+		hash_destruir(usuarios);
+		nombres_destruir(nombres);
+		free(algogram);
+		return NULL;
+	}
+	algogram->sesion = sesion;
+	algogram->sesion_inicial = sesion;
+	algogram->modo = modo;
+	algogram->repartidor = NULL;
 	algogram->id_usuario = 0;
 	algogram->id_post = 0;
+	algogram->bitacora = NULL;
+	algogram->secuencia = 0;
+	algogram->carga_completa = false;
 	return algogram;
 }
 
 bool algogram_agregar_usuario(algogram_t* algogram, const char* nombre_usuario) {
-	usuario_t* usuario = usuario_crear(nombre_usuario, algogram->id_usuario); 
-	if (!usuario) return false;
-	if (!hash_guardar(algogram->usuarios, nombre_usuario, usuario)) {
-		usuario_destruir(usuario);
+	return algogram_agregar_usuario_largo(algogram, nombre_usuario, strlen(nombre_usuario));
+}
+
+bool algogram_agregar_usuario_largo(algogram_t* algogram, const char* nombre_usuario, size_t largo) {
+	size_t id = algogram->id_usuario;
+	if (!agregar_usuario_con_id(algogram, nombre_usuario, largo, id)) return false;
+	algogram->id_usuario++;
+	// Se registra la copia canonica, que si termina en '\0'.
+	if (algogram->bitacora) bitacora_registrar_usuario(algogram->bitacora, directorio_nombre(algogram->directorio, id));
+	return true;
+}
+
+bool algogram_reservar_usuarios(algogram_t* algogram, size_t cantidad) {
+	size_t total = hash_cantidad(algogram->usuarios) + cantidad;
+	return nombres_reservar(algogram->nombres, total) && hash_reservar(algogram->usuarios, total);
+}
+
+bool algogram_repartir_en_paralelo(algogram_t* algogram, size_t cant_hilos, bool relajado) {
+	if (algogram->modo != FEED_PUSH || algogram->repartidor) return false;
+	repartidor_t* repartidor = repartidor_crear(cant_hilos, relajado);
+	if (!repartidor) return false;
+	hash_iter_t* iter = hash_iter_crear(algogram->usuarios);
+	bool ok = iter != NULL;
+	for (; ok && !hash_iter_al_final(iter); hash_iter_avanzar(iter)) {
+		ok = repartidor_agregar_usuario(repartidor, hash_obtener(algogram->usuarios, hash_iter_ver_actual(iter)));
+	}
+	if (iter) hash_iter_destruir(iter);
+	if (!ok) {
+		repartidor_destruir(repartidor);
 		return false;
 	}
-	algogram->id_usuario++;
+	algogram->repartidor = repartidor;
 	return true;
 }
 
-bool algogram_login(algogram_t* algogram) {
-	if (algogram->usuario_loggeado) {
-		fprintf(stdout, "Error: Ya habia un usuario loggeado\n");
+bool algogram_hay_usuario_loggeado(const algogram_t* algogram) {
+	return sesion_ver_usuario(algogram->sesion);
+}
+
+void algogram_usar_sesion(algogram_t* algogram, sesion_t* sesion) {
+	algogram->sesion = sesion ? sesion : algogram->sesion_inicial;
+}
+
+bool algogram_login(algogram_t* algogram, const char* nombre) {
+	if (sesion_ver_usuario(algogram->sesion)) {
+		salida_texto(algogram->salida, "Error: Ya habia un usuario loggeado\n");
 		return false;
 	}
-	size_t capacidad;
-	if (getline(&algogram->usuario_loggeado, &capacidad, stdin) == -1) return false;
-	algogram->usuario_loggeado[strcspn(algogram->usuario_loggeado, "\n")] = 0;
-	if (!hash_pertenece(algogram->usuarios, algogram->usuario_loggeado)) {
-		fprintf(stdout, "Error: usuario no existente\n");
-		free(algogram->usuario_loggeado);
-		algogram->usuario_loggeado = NULL;
+	if (!nombre) return false;
+	usuario_t* usuario = hash_obtener(algogram->usuarios, nombre);
+	if (!usuario) {
+		salida_texto(algogram->salida, "Error: usuario no existente\n");
 		return false;
 	}
-	fprintf(stdout, "Hola %s\n", algogram->usuario_loggeado);
+	sesion_login(algogram->sesion, usuario);
+	salida_texto(algogram->salida, "Hola ");
+	salida_texto(algogram->salida, usuario_ver_nombre(usuario));
+	salida_texto(algogram->salida, "\n");
 	return true;
 }
 
 bool algogram_logout(algogram_t* algogram) {
-	if (!algogram->usuario_loggeado) {
-		fprintf(stdout, "Error: no habia usuario loggeado\n");
+	if (!sesion_logout(algogram->sesion)) {
+		salida_texto(algogram->salida, "Error: no habia usuario loggeado\n");
 		return false;
 	}
-	free(algogram->usuario_loggeado);
-	algogram->usuario_loggeado = NULL;
-	fprintf(stdout, "Adios\n");
+	salida_texto(algogram->salida, "Adios\n");
 	return true;
 }
 
-bool algogram_publicar_post(algogram_t* algogram) {
-	if (!algogram->usuario_loggeado) { 
-		fprintf(stdout, "Error: no habia usuario loggeado\n");
+bool algogram_publicar_post(algogram_t* algogram, const char* texto) {
+	usuario_t* usuario = sesion_ver_usuario(algogram->sesion);
+	if (!usuario) { 
+		salida_texto(algogram->salida, "Error: no habia usuario loggeado\n");
 		return false;
 	}
-	char* texto = obtener_linea();
-	post_t* post = post_crear(strdup(algogram->usuario_loggeado), texto, algogram->id_post);
-	if (!post) {
-		fprintf(stdout, "Error: no se pudo crear el post\n");	
+	if (!publicar_post(algogram, usuario, strdup(texto ? texto : ""))) {
+		salida_texto(algogram->salida, "Error: no se pudo crear el post\n");	
 		return false;
 	}
-	
-	usuario_t* usuario_posteador = hash_obtener(algogram->usuarios, algogram->usuario_loggeado);
-	size_t id_posteador = usuario_obtener_id(usuario_posteador);
-	if (!publicar_en_posts(algogram, post)) return false;
-	if (!publicar_en_usuarios(algogram, post, id_posteador)) return false;
-	
-	algogram->id_post++;
-	fprintf(stdout, "Post publicado\n");
+	salida_texto(algogram->salida, "Post publicado\n");
 	return true;
 }
 
 bool algogram_ver_post(algogram_t* algogram) {
-	if (!algogram->usuario_loggeado) {
-		fprintf(stdout, "Usuario no loggeado o no hay mas posts para ver\n");
+	usuario_t* usuario = sesion_ver_usuario(algogram->sesion);
+	if (!usuario) {
+		salida_texto(algogram->salida, "Usuario no loggeado o no hay mas posts para ver\n");
 		return false;
 	}
-	usuario_t* usuario = hash_obtener(algogram->usuarios, algogram->usuario_loggeado);
-	post_t* post = usuario_ver_post(usuario);
-	if (!usuario || !post) {
-		fprintf(stdout, "Usuario no loggeado o no hay mas posts para ver\n");
+	post_t* post = obtener_siguiente_post(algogram, usuario);
+	if (!post) {
+		salida_texto(algogram->salida, "Usuario no loggeado o no hay mas posts para ver\n");
 		return false;
 	}
-	fprintf(stdout, "Post ID %zu\n", post_ver_id(post));
-	fprintf(stdout, "%s dijo: %s\n", post_ver_posteador(post), post_ver_texto(post));
-	fprintf(stdout, "Likes: %zu\n", post_cantidad_likes(post));
+	salida_texto(algogram->salida, "Post ID ");
+	salida_numero(algogram->salida, post_ver_id(post));
+	salida_texto(algogram->salida, "\n");
+	salida_texto(algogram->salida, post_ver_posteador(post));
+	salida_texto(algogram->salida, " dijo: ");
+	salida_texto(algogram->salida, post_ver_texto(post));
+	salida_texto(algogram->salida, "\nLikes: ");
+	salida_numero(algogram->salida, post_cantidad_likes(post));
+	salida_texto(algogram->salida, "\n");
 	return true;
 }
 
-bool algogram_likear_post(algogram_t* algogram) {
-	char* id_post = obtener_linea(); 
-	post_t* post = hash_obtener(algogram->posts, id_post);
-	if (!algogram->usuario_loggeado || !post) {
-		fprintf(stdout, "Error: Usuario no loggeado o Post inexistente\n");
-		free(id_post);
+bool algogram_likear_post(algogram_t* algogram, const char* id_post) {
+	usuario_t* usuario = sesion_ver_usuario(algogram->sesion);
+	post_t* post = obtener_post(algogram, id_post);
+	if (!usuario || !post) {
+		salida_texto(algogram->salida, "Error: Usuario no loggeado o Post inexistente\n");
 		return false;
 	}
-	if (!post_esta_likeado(post, algogram->usuario_loggeado)) {
-		post_likear(post, algogram->usuario_loggeado);
+	likear_post(algogram, usuario, post);
+	salida_texto(algogram->salida, "Post likeado\n");
+	return true;
+}
+
+bool algogram_ver_likes(algogram_t* algogram, const char* id_post) {
+	post_t* post = obtener_post(algogram, id_post);
+	if (!post || !post_cantidad_likes(post)) {
+		salida_texto(algogram->salida, "Error: Post inexistente o sin likes\n");
+		return false;
 	}
-	free(id_post);
-	fprintf(stdout, "Post likeado\n");
+	post_ver_likes(post, algogram->directorio, algogram->salida);
 	return true;
 }
 
-bool algogram_ver_likes(algogram_t* algogram) {
-	char* id_post = obtener_linea();
-	post_t* post = hash_obtener(algogram->posts, id_post);
+bool algogram_ver_likes_desde(algogram_t* algogram, const char* id_post, const char* desde, const char* linea_limite) {
+	post_t* post = obtener_post(algogram, id_post);
+	size_t limite;
+	bool ok = true;
 	if (!post || !post_cantidad_likes(post)) {
-		fprintf(stdout, "Error: Post inexistente o sin likes\n");
-		free(id_post);
+		salida_texto(algogram->salida, "Error: Post inexistente o sin likes\n");
+		ok = false;
+	} else if (!parsear_id(linea_limite, &limite) || !limite) {
+		salida_texto(algogram->salida, "Error: limite invalido\n");
+		ok = false;
+	} else {
+		post_ver_likes_desde(post, algogram->directorio, desde ? desde : "", limite, algogram->salida);
+	}
+	return ok;
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL PROTOCOLO BINARIO
+ * *****************************************************************/
+
+bool algogram_bin_login(algogram_t* algogram, size_t id_usuario) {
+	if (sesion_ver_usuario(algogram->sesion)) {
+		salida_entero(algogram->salida, PROTOCOLO_YA_LOGGEADO, PROTOCOLO_TAM_U8);
+		return false;
+	}
+	const char* nombre = directorio_nombre(algogram->directorio, id_usuario);
+	usuario_t* usuario = nombre ? hash_obtener(algogram->usuarios, nombre) : NULL;
+	if (!usuario) {
+		salida_entero(algogram->salida, PROTOCOLO_USUARIO_INEXISTENTE, PROTOCOLO_TAM_U8);
+		return false;
+	}
+	sesion_login(algogram->sesion, usuario);
+	salida_entero(algogram->salida, PROTOCOLO_OK, PROTOCOLO_TAM_U8);
+	return true;
+}
+
+bool algogram_bin_logout(algogram_t* algogram) {
+	if (!sesion_logout(algogram->sesion)) {
+		salida_entero(algogram->salida, PROTOCOLO_NO_LOGGEADO, PROTOCOLO_TAM_U8);
+		return false;
+	}
+	salida_entero(algogram->salida, PROTOCOLO_OK, PROTOCOLO_TAM_U8);
+	return true;
+}
+
+bool algogram_bin_publicar_post(algogram_t* algogram, const char* texto, size_t largo) {
+	usuario_t* usuario = sesion_ver_usuario(algogram->sesion);
+	if (!usuario) {
+		salida_entero(algogram->salida, PROTOCOLO_NO_LOGGEADO, PROTOCOLO_TAM_U8);
+		return false;
+	}
+	post_t* post = publicar_post(algogram, usuario, strndup(texto, largo));
+	if (!post) {
+		salida_entero(algogram->salida, PROTOCOLO_ERROR_INTERNO, PROTOCOLO_TAM_U8);
+		return false;
+	}
+	salida_entero(algogram->salida, PROTOCOLO_OK, PROTOCOLO_TAM_U8);
+	salida_entero(algogram->salida, post_ver_id(post), PROTOCOLO_TAM_U64);
+	return true;
+}
+
+bool algogram_bin_ver_post(algogram_t* algogram) {
+	usuario_t* usuario = sesion_ver_usuario(algogram->sesion);
+	if (!usuario) {
+		salida_entero(algogram->salida, PROTOCOLO_NO_LOGGEADO, PROTOCOLO_TAM_U8);
+		return false;
+	}
+	post_t* post = obtener_siguiente_post(algogram, usuario);
+	if (!post) {
+		salida_entero(algogram->salida, PROTOCOLO_SIN_POSTS, PROTOCOLO_TAM_U8);
+		return false;
+	}
+	const char* texto = post_ver_texto(post);
+	size_t largo = strlen(texto);
+	salida_entero(algogram->salida, PROTOCOLO_OK, PROTOCOLO_TAM_U8);
+	salida_entero(algogram->salida, post_ver_id(post), PROTOCOLO_TAM_U64);
+	salida_entero(algogram->salida, post_ver_id_posteador(post), PROTOCOLO_TAM_U32);
+	salida_entero(algogram->salida, post_cantidad_likes(post), PROTOCOLO_TAM_U64);
+	salida_entero(algogram->salida, largo, PROTOCOLO_TAM_U32);
+	salida_bytes(algogram->salida, texto, largo);
+	return true;
+}
+
+bool algogram_bin_likear_post(algogram_t* algogram, size_t id_post) {
+	usuario_t* usuario = sesion_ver_usuario(algogram->sesion);
+	if (!usuario) {
+		salida_entero(algogram->salida, PROTOCOLO_NO_LOGGEADO, PROTOCOLO_TAM_U8);
+		return false;
+	}
+	post_t* post = tabla_posts_obtener(algogram->posts, id_post);
+	if (!post) {
+		salida_entero(algogram->salida, PROTOCOLO_POST_INEXISTENTE, PROTOCOLO_TAM_U8);
+		return false;
+	}
+	likear_post(algogram, usuario, post);
+	salida_entero(algogram->salida, PROTOCOLO_OK, PROTOCOLO_TAM_U8);
+	return true;
+}
+
+bool algogram_bin_ver_likes(algogram_t* algogram, size_t id_post) {
+	post_t* post = tabla_posts_obtener(algogram->posts, id_post);
+	if (!post) {
+		salida_entero(algogram->salida, PROTOCOLO_POST_INEXISTENTE, PROTOCOLO_TAM_U8);
+		return false;
+	}
+	if (!post_cantidad_likes(post)) {
+		salida_entero(algogram->salida, PROTOCOLO_SIN_LIKES, PROTOCOLO_TAM_U8);
 		return false;
 	}
-	free(id_post);
-	post_ver_likes(post);
+	// Los IDs se juntan antes de escribir el estado: si el recorrido falla a la mitad, la
+	// respuesta es un error y no un OK con menos IDs que los anunciados.
+	ids_likes_t ids = { malloc(post_cantidad_likes(post) * sizeof(size_t)), 0, post_cantidad_likes(post) };
+	if (!ids.ids || !post_recorrer_likes(post, algogram->directorio, guardar_id_like, &ids)) {
+		free(ids.ids);
+		salida_entero(algogram->salida, PROTOCOLO_ERROR_INTERNO, PROTOCOLO_TAM_U8);
+		return false;
+	}
+	salida_entero(algogram->salida, PROTOCOLO_OK, PROTOCOLO_TAM_U8);
+	salida_entero(algogram->salida, ids.cantidad, PROTOCOLO_TAM_U64);
+	for (size_t i = 0; i < ids.cantidad; i++) salida_entero(algogram->salida, ids.ids[i], PROTOCOLO_TAM_U32);
+	free(ids.ids);
 	return true;
 }
 
+void algogram_bin_operacion_invalida(algogram_t* algogram) {
+	salida_entero(algogram->salida, PROTOCOLO_OPERACION_INVALIDA, PROTOCOLO_TAM_U8);
+}
+
+void algogram_bin_texto_muy_largo(algogram_t* algogram) {
+	salida_entero(algogram->salida, PROTOCOLO_TEXTO_MUY_LARGO, PROTOCOLO_TAM_U8);
+}
+
+bool algogram_guardar_instantanea(algogram_t* algogram, const char* ruta) {
+	// Al cargarla se da la carga por completa: no puede faltarle ningun usuario del archivo.
+	if (!algogram->carga_completa) return false;
+	size_t largo = strlen(ruta);
+	char* temporal = malloc(largo + sizeof(SUFIJO_TEMPORAL));
+	if (!temporal) return false;
+	memcpy(temporal, ruta, largo);
+	memcpy(temporal + largo, SUFIJO_TEMPORAL, sizeof(SUFIJO_TEMPORAL));
+	int fd = open(temporal, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+	salida_t* salida = fd == -1 ? NULL : salida_crear(fd);
+	bool ok = salida != NULL;
+	if (salida) {
+		volcar_instantanea(algogram, salida);
+		ok = salida_vaciar(salida) && !salida_hubo_error(salida);
+		salida_destruir(salida);
+	}
+	// La instantanea anterior solo se reemplaza por una completa y ya escrita en el disco.
+	ok = ok && fsync(fd) == 0;
+	if (fd != -1 && close(fd) == -1) ok = false;
+	ok = ok && rename(temporal, ruta) == 0;
+	if (!ok && fd != -1) unlink(temporal);
+	free(temporal);
+	// Los registros de la bitacora quedaron incluidos en la instantanea.
+	if (ok && algogram->bitacora) {
+		algogram->secuencia = bitacora_secuencia(algogram->bitacora);
+		ok = bitacora_reiniciar(algogram->bitacora);
+	}
+	return ok;
+}
+
+bool algogram_terminar_carga(algogram_t* algogram) {
+	algogram->carga_completa = true;
+	if (!algogram->bitacora) return true;
+	// Se sincroniza ya: si no, una caida antes del primer comando obligaria a repetir la carga.
+	bitacora_registrar_carga(algogram->bitacora);
+	return bitacora_confirmar(algogram->bitacora);
+}
+
+bool algogram_carga_completa(const algogram_t* algogram) {
+	return algogram->carga_completa;
+}
+
+bool algogram_abrir_bitacora(algogram_t* algogram, const char* ruta, size_t ventana) {
+	// Se reproduce sin bitacora, para no volver a registrar los comandos reproducidos.
+	bitacora_t* bitacora = bitacora_abrir(ruta, algogram->secuencia, ventana, aplicar_registro, algogram);
+	if (!bitacora) return false;
+	algogram->bitacora = bitacora;
+	salida_antes_de_escribir(algogram->salida, confirmar_bitacora, algogram);
+	return true;
+}
+
+algogram_t* algogram_cargar_instantanea(const char* ruta) {
+	int fd = open(ruta, O_RDONLY);
+	if (fd == -1) return NULL;
+	struct stat estado;
+	if (fstat(fd, &estado) == -1 || estado.st_size == 0) {
+		close(fd);
+		return NULL;
+	}
+	size_t tam = (size_t)estado.st_size;
+	void* datos = mmap(NULL, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (datos == MAP_FAILED) return NULL;
+	posix_madvise(datos, tam, POSIX_MADV_SEQUENTIAL);
+
+	lector_instantanea_t lector = { datos, (const char*)datos + tam };
+	feed_modo_t modo;
+	uint64_t id_usuario, cant_usuarios, cant_posts, secuencia;
+	algogram_t* algogram = NULL;
+	if (leer_encabezado(&lector, &modo, &id_usuario, &cant_usuarios, &cant_posts, &secuencia)) algogram = algogram_crear_con_modo(modo);
+	// Las instantaneas se guardan con la carga de usuarios terminada.
+	if (algogram) {
+		algogram->secuencia = secuencia;
+		algogram->carga_completa = true;
+	}
+	if (algogram && !restaurar_instantanea(algogram, &lector, id_usuario, cant_usuarios, cant_posts)) {
+		algogram_destruir(algogram);
+		algogram = NULL;
+	}
+	munmap(datos, tam);
+	return algogram;
+}
+
+#ifdef ESTADISTICAS
+void algogram_mostrar_estadisticas(algogram_t* algogram) {
+	escribir_estadisticas(algogram, algogram->salida);
+}
+
+void algogram_volcar_estadisticas(algogram_t* algogram, int fd) {
+	salida_t* salida = salida_crear(fd);
+	if (!salida) return;
+	escribir_estadisticas(algogram, salida);
+	salida_destruir(salida);
+}
+#endif
+
+void algogram_vaciar_salida(algogram_t* algogram) {
+	salida_vaciar(algogram->salida);
+}
+
+int algogram_demora_salida(const algogram_t* algogram) {
+	return algogram->bitacora ? bitacora_demora(algogram->bitacora) : 0;
+}
+
 void algogram_destruir(algogram_t* algogram) {
+	if (algogram->repartidor) repartidor_destruir(algogram->repartidor);
+	sesion_destruir(algogram->sesion_inicial);
+	// La salida se vacia antes de cerrar la bitacora, ya que confirma sus registros.
+	salida_destruir(algogram->salida);
+	if (algogram->bitacora && !bitacora_cerrar(algogram->bitacora)) {
+		fprintf(stderr, "%s", "Error: no se pudo escribir la bitacora\n");
+	}
 	hash_destruir(algogram->usuarios);
-	hash_destruir(algogram->posts);
-	free(algogram->usuario_loggeado);
+	tabla_posts_destruir(algogram->posts);
+	feed_destruir(algogram->feed);
+	directorio_destruir(algogram->directorio);
+	nombres_destruir(algogram->nombres);
 	free(algogram);
 }
@@ -2,6 +2,9 @@
 #define ALGOGRAM_H
 
 #include <stdbool.h>
+#include <stddef.h>
+
+#include "sesion.h"
 
 
 /* ******************************************************************
@@ -10,34 +13,85 @@
 
 typedef struct algogram algogram_t;
 
+/* Modo de distribucion de los posts en los feeds:
+ * FEED_PUSH: al publicar, el post se encola en el feed de cada usuario (O(U log F) por post).
+ * FEED_PULL: al publicar, el post se guarda una sola vez en el registro de su autor, y cada
+ * usuario calcula su feed al leerlo (O(1) por post). Cada lector guarda cuantos posts leyo solo
+ * de los autores que leyo, pero una lectura recorre los IDs por distancia hasta el autor con
+ * posts sin leer mas cercano, que puede estar a O(U) de distancia.
+ * Ambos modos muestran los posts en el mismo orden.
+ */
+typedef enum { FEED_PUSH, FEED_PULL } feed_modo_t;
+
 
 /* ******************************************************************
  *                    PRIMITIVAS DE ALGOGRAM
  * *****************************************************************/
 
-// Crea la estructura AlgoGram sin usuarios.
+// Crea la estructura AlgoGram sin usuarios, con los feeds en modo FEED_PUSH.
 algogram_t* algogram_crear();
 
+// Crea la estructura AlgoGram sin usuarios, con los feeds en el modo indicado.
+algogram_t* algogram_crear_con_modo(feed_modo_t modo);
+
 /* PRE: Recibe un AlgoGram previamente creado y un nombre de usuario. 
- * POST: Devuelve true si pudo agregar el usuario a AlgoGram, en caso contrario false.
+ * POST: Devuelve true si pudo agregar el usuario a AlgoGram, en caso contrario false. Los IDs
+ * llegan hasta COLA_FEED_AFINIDAD_MAX (2^28 - 1): pasado ese limite no se agregan mas usuarios.
  */
 bool algogram_agregar_usuario(algogram_t* algogram, const char* usuario);
 
+/* PRE: Recibe un AlgoGram previamente creado y un nombre de usuario de largo bytes, que no
+ * necesita terminar en '\0' (por ejemplo, una linea de un archivo mapeado en memoria).
+ * POST: Igual que algogram_agregar_usuario.
+ */
+bool algogram_agregar_usuario_largo(algogram_t* algogram, const char* usuario, size_t largo);
+
+/* PRE: Recibe un AlgoGram previamente creado y la cantidad de usuarios que se van a agregar.
+ * POST: Devuelve true si se pudo reservar lugar para todos, de modo que agregarlos no
+ * redimensione las tablas de usuarios y de nombres, en caso contrario false.
+ */
+bool algogram_reservar_usuarios(algogram_t* algogram, size_t cantidad);
+
+/* PRE: Recibe un AlgoGram en modo FEED_PUSH, la cantidad de hilos y si el reparto es relajado.
+ * POST: Desde ahora cada post se reparte en los feeds con cant_hilos hilos, cada uno a cargo de
+ * un rango de usuarios (ver reparto.h). En modo relajado, publicar no espera a que termine el
+ * reparto, que sigue mientras se atienden los comandos siguientes hasta que alguno necesita
+ * los feeds; las respuestas son las mismas. Devuelve false si no se pudo, si el modo es
+ * FEED_PULL o si ya se repartia en paralelo.
+ */
+bool algogram_repartir_en_paralelo(algogram_t* algogram, size_t cant_hilos, bool relajado);
+
 /* PRE: Recibe un AlgoGram previamente creado.
+ * POST: Devuelve true si hay un usuario loggeado, en caso contrario false. Sirve para saber si
+ * login y publicar van a usar su argumento (ver algogram_login y algogram_publicar_post).
+ */
+bool algogram_hay_usuario_loggeado(const algogram_t* algogram);
+
+/* PRE: Recibe un AlgoGram previamente creado y una sesion (o NULL).
+ * POST: Los comandos siguientes (login, logout, publicar, ver y likear) usan el usuario
+ * loggeado en esa sesion, hasta que se elija otra. Con NULL se vuelve a la sesion propia de
+ * AlgoGram, que es la que se usa desde que se crea. AlgoGram no es dueño de las sesiones que
+ * recibe, que deben seguir existiendo mientras esten en uso.
+ */
+void algogram_usar_sesion(algogram_t* algogram, sesion_t* sesion);
+
+/* PRE: Recibe un AlgoGram previamente creado y el nombre del usuario (NULL si no hay mas entrada).
  * POST: Devuelve true si se pudo loggear el usuario, en caso contrario false.
  * Se puede loggear si no hay usuario loggeado y si el usuario se encuentra en el archivo de usuarios.
+ * Si ya habia un usuario loggeado, el nombre no se usa.
  */
-bool algogram_login(algogram_t* algogram);
+bool algogram_login(algogram_t* algogram, const char* nombre);
 
 /* PRE: Recibe un AlgoGram previamente creado.
  * POST: Devuelve true si se pudo realizar el logout, en caso de no haber un usuario loggeado devuelve false.
  */
 bool algogram_logout(algogram_t* algogram);
 
-/* PRE: Recibe un AlgoGram previamente creado.
- * POST: Publica un post y lo agrega al feed de los demás usuarios y al hash de posts.
+/* PRE: Recibe un AlgoGram previamente creado y el texto del post (NULL equivale a un texto vacio).
+ * POST: Publica un post y lo agrega al feed de los demás usuarios y al hash de posts. El texto se
+ * copia. Si no habia usuario loggeado, el texto no se usa.
  */
-bool algogram_publicar_post(algogram_t* algogram);
+bool algogram_publicar_post(algogram_t* algogram, const char* texto);
 
 /* PRE: Recibe un AlgoGram previamente creado.
  * POST: Devuelve true si se pudo mostrar el post, en caso de no haber más posts por ver o no haber 
@@ -45,17 +99,143 @@ bool algogram_publicar_post(algogram_t* algogram);
  */
 bool algogram_ver_post(algogram_t* algogram);
 
-/* PRE: Recibe un AlgoGram previamente creado.
- * POST: Devuelve true si se likeo el post correspondiente al ID que se recibe por consola, en caso de 
+/* PRE: Recibe un AlgoGram previamente creado y la linea con el ID de un post (o NULL).
+ * POST: Devuelve true si se likeo el post correspondiente a ese ID, en caso de 
  * no existir el post de dicho ID o no haber usuario loggeado devuelve false.
  */
-bool algogram_likear_post(algogram_t* algogram);
+bool algogram_likear_post(algogram_t* algogram, const char* id_post);
 
-/* PRE: Recibe un AlgoGram previamente creado
- * POST: Devuelve true y muestra los likes del post correspondiente al ID que recibe por consola,
+/* PRE: Recibe un AlgoGram previamente creado y la linea con el ID de un post (o NULL).
+ * POST: Devuelve true y muestra los likes del post correspondiente a ese ID,
  * o false si no existe el post o no tiene likes.
  */
-bool algogram_ver_likes(algogram_t* algogram);
+bool algogram_ver_likes(algogram_t* algogram, const char* id_post);
+
+/* PRE: Recibe un AlgoGram previamente creado y las lineas con el ID de un post, un nombre desde
+ * el cual mostrar y un limite (cualquiera puede ser NULL).
+ * POST: Devuelve true y muestra, en orden alfabetico, hasta limite usuarios que likearon el post
+ * a partir de ese nombre (ver post_ver_likes_desde), o false si no existe el post, no tiene likes
+ * o el limite no es un numero positivo.
+ */
+bool algogram_ver_likes_desde(algogram_t* algogram, const char* id_post, const char* desde, const char* linea_limite);
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL PROTOCOLO BINARIO
+ * *****************************************************************/
+
+/* Equivalentes a las primitivas anteriores, pero reciben los IDs ya decodificados y
+ * responden en el formato binario descripto en protocolo.h.
+ */
+
+/* PRE: Recibe un AlgoGram previamente creado y el ID de un usuario.
+ * POST: Devuelve true si se pudo loggear ese usuario, en caso contrario false.
+ */
+bool algogram_bin_login(algogram_t* algogram, size_t id_usuario);
+
+/* PRE: Recibe un AlgoGram previamente creado.
+ * POST: Devuelve true si se pudo realizar el logout, en caso contrario false.
+ */
+bool algogram_bin_logout(algogram_t* algogram);
+
+/* PRE: Recibe un AlgoGram previamente creado, el texto del post y su largo.
+ * POST: Devuelve true si se pudo publicar el post, en caso contrario false. El texto se copia
+ * hasta el primer '\0' o hasta largo.
+ */
+bool algogram_bin_publicar_post(algogram_t* algogram, const char* texto, size_t largo);
+
+/* PRE: Recibe un AlgoGram previamente creado.
+ * POST: Devuelve true si se pudo mostrar el siguiente post del feed, en caso contrario false.
+ */
+bool algogram_bin_ver_post(algogram_t* algogram);
+
+/* PRE: Recibe un AlgoGram previamente creado y el ID de un post.
+ * POST: Devuelve true si se likeo el post, en caso contrario false.
+ */
+bool algogram_bin_likear_post(algogram_t* algogram, size_t id_post);
+
+/* PRE: Recibe un AlgoGram previamente creado y el ID de un post.
+ * POST: Devuelve true y muestra los IDs de los usuarios que likearon el post, o false si no
+ * existe el post o no tiene likes.
+ */
+bool algogram_bin_ver_likes(algogram_t* algogram, size_t id_post);
+
+/* PRE: Recibe un AlgoGram previamente creado.
+ * POST: Responde que la operacion pedida no existe.
+ */
+void algogram_bin_operacion_invalida(algogram_t* algogram);
+
+/* PRE: Recibe un AlgoGram previamente creado.
+ * POST: Responde que el texto a publicar supera PROTOCOLO_LARGO_MAX.
+ */
+void algogram_bin_texto_muy_largo(algogram_t* algogram);
+
+
+/* PRE: Recibe un AlgoGram con la carga de usuarios completa y la ruta de un archivo.
+ * POST: Devuelve true si se guardo en el archivo una instantanea con todo el estado de AlgoGram
+ * (usuarios, posts, likes y feeds pendientes; no la sesion), en caso contrario false. Se escribe
+ * primero en la ruta con el sufijo ".tmp" y despues se renombra, de modo que el archivo siempre
+ * tiene una instantanea completa.
+ */
+bool algogram_guardar_instantanea(algogram_t* algogram, const char* ruta);
+
+/* PRE: Recibe la ruta de una instantanea guardada con algogram_guardar_instantanea.
+ * POST: Devuelve un AlgoGram con el estado de la instantanea y sin usuario loggeado, o NULL si
+ * no se pudo leer o no es valida. La instantanea se mapea en memoria, y la carga es lineal en
+ * su tamaño (no depende de cuantos comandos generaron el estado).
+ */
+algogram_t* algogram_cargar_instantanea(const char* ruta);
+
+/* PRE: Recibe un AlgoGram recien creado o cargado de una instantanea, la ruta de una bitacora y
+ * la ventana de group commit en milisegundos.
+ * POST: Reprodujo los comandos de la bitacora posteriores a la instantanea (si existe), y desde
+ * ahora registra en ella cada usuario agregado, post publicado, like nuevo y post visto en un feed. Las respuestas se
+ * escriben recien despues de escribir y sincronizar con el disco los registros de sus comandos.
+ * Con ventana, quien vacia la salida puede demorarla hasta la ventana para que mas comandos
+ * compartan la sincronizacion (ver algogram_demora_salida). Guardar una instantanea vacia la
+ * bitacora. Devuelve false si la bitacora no se pudo abrir o reproducir.
+ */
+bool algogram_abrir_bitacora(algogram_t* algogram, const char* ruta, size_t ventana);
+
+/* PRE: Recibe un AlgoGram al que ya se le agregaron todos los usuarios del archivo de usuarios.
+ * POST: Marca la carga como completa y, si hay bitacora, lo registra y sincroniza. Devuelve
+ * false si la bitacora no se pudo escribir.
+ */
+bool algogram_terminar_carga(algogram_t* algogram);
+
+/* PRE: Recibe un AlgoGram previamente creado.
+ * POST: Devuelve true si la carga de usuarios esta completa: se cargo de una instantanea, se
+ * reprodujo una bitacora que llega al registro de carga o se llamo a algogram_terminar_carga.
+ */
+bool algogram_carga_completa(const algogram_t* algogram);
+
+#ifdef ESTADISTICAS
+/* PRE: Recibe un AlgoGram previamente creado.
+ * POST: Muestra los contadores internos de las estructuras (ver estadisticas.h), el estado
+ * de la tabla de usuarios, de los feeds y de los likes, y las latencias de los comandos
+ * ejecutados, una linea por estadistica.
+ */
+void algogram_mostrar_estadisticas(algogram_t* algogram);
+
+/* PRE: Recibe un AlgoGram previamente creado y un descriptor abierto para escritura.
+ * POST: Escribe lo mismo que algogram_mostrar_estadisticas en ese descriptor, sin pasar
+ * por las respuestas pendientes.
+ */
+void algogram_volcar_estadisticas(algogram_t* algogram, int fd);
+#endif
+
+/* PRE: Recibe un AlgoGram previamente creado.
+ * POST: Se escribieron por salida estandar todas las respuestas pendientes. Las respuestas
+ * se acumulan en un buffer y solo se escriben al vaciarlo, al llenarse o al destruir el AlgoGram.
+ */
+void algogram_vaciar_salida(algogram_t* algogram);
+
+/* PRE: Recibe un AlgoGram previamente creado.
+ * POST: Devuelve cuantos milisegundos se puede demorar el vaciado de la salida esperando mas
+ * comandos cuyos registros compartan la sincronizacion de la bitacora, o 0 si hay que vaciarla
+ * ya (no hay bitacora, no hay registros sin sincronizar o vencio la ventana).
+ */
+int algogram_demora_salida(const algogram_t* algogram);
 
 /* PRE: Recibe un AlgoGram previamente creado.
  * POST: Se destruyo el AlgoGram.
@@ -0,0 +1,349 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "algogram.h"
+
+#define USUARIOS_DEFAULT 5000
+#define POSTS_DEFAULT 20000
+#define LIKES_DEFAULT 100000
+#define LECTURAS_DEFAULT 100000
+#define CONSULTAS_DEFAULT 10000
+#define SESGO_DEFAULT 1.0
+#define LARGO_MAX_LINEA 64
+#define SEMILLA 88172645463325252ULL
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+// Tipos de comando que se miden por separado.
+typedef enum {
+	OP_LOGIN,
+	OP_LOGOUT,
+	OP_PUBLICAR,
+	OP_VER_SIGUIENTE_FEED,
+	OP_LIKEAR_POST,
+	OP_MOSTRAR_LIKES,
+	CANT_OPS
+} operacion_t;
+
+static const char* NOMBRES_OPS[CANT_OPS] = {
+	"login", "logout", "publicar", "ver_siguiente_feed", "likear_post", "mostrar_likes"
+};
+
+// Distribucion de Zipf sobre los rangos 0..cant-1: el rango k tiene peso 1 / (k+1)^sesgo.
+typedef struct zipf {
+	double* acumulada;
+	size_t cant;
+} zipf_t;
+
+// Latencias (en nanosegundos) de todas las ejecuciones de un tipo de comando.
+typedef struct latencias {
+	uint64_t* muestras;
+	size_t cant;
+	size_t tam;
+	size_t fallidos;
+} latencias_t;
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Generador xorshift64, para que la carga sea la misma en todas las corridas.
+unsigned long long bench_aleatorio(unsigned long long* estado) {
+	*estado ^= *estado << 13;
+	*estado ^= *estado >> 7;
+	*estado ^= *estado << 17;
+	return *estado;
+}
+
+// Devuelve un numero aleatorio uniforme en [0, 1).
+double bench_uniforme(unsigned long long* estado) {
+	return (double)(bench_aleatorio(estado) >> 11) / 9007199254740992.0;
+}
+
+// Devuelve el tiempo actual en nanosegundos, con un reloj monotono.
+uint64_t nanosegundos_actuales(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* PRE: Recibe la cantidad de rangos (mayor a cero) y el sesgo (0 es una distribucion uniforme).
+ * POST: Devuelve la distribucion con su funcion acumulada precalculada, o NULL si no hay memoria.
+ */
+zipf_t* zipf_crear(size_t cant, double sesgo) {
+	zipf_t* zipf = malloc(sizeof(zipf_t));
+	if (!zipf) return NULL;
+	zipf->acumulada = malloc(cant * sizeof(double));
+	if (!zipf->acumulada) {
+		free(zipf);
+		return NULL;
+	}
+	double total = 0;
+	for (size_t k = 0; k < cant; k++) {
+		total += pow((double)(k + 1), -sesgo);
+		zipf->acumulada[k] = total;
+	}
+	for (size_t k = 0; k < cant; k++) zipf->acumulada[k] /= total;
+	zipf->cant = cant;
+	return zipf;
+}
+
+/* PRE: Recibe una distribucion y el estado del generador.
+ * POST: Devuelve un rango, por busqueda binaria sobre la funcion acumulada.
+ */
+size_t zipf_muestra(const zipf_t* zipf, unsigned long long* estado) {
+	double u = bench_uniforme(estado);
+	size_t inicio = 0, fin = zipf->cant - 1;
+	while (inicio < fin) {
+		size_t medio = inicio + (fin - inicio) / 2;
+		if (zipf->acumulada[medio] <= u) inicio = medio + 1;
+		else fin = medio;
+	}
+	return inicio;
+}
+
+// Libera una distribucion.
+void zipf_destruir(zipf_t* zipf) {
+	free(zipf->acumulada);
+	free(zipf);
+}
+
+/* PRE: Recibe una cantidad y el estado del generador.
+ * POST: Devuelve una permutacion aleatoria de 0..cant-1, para que los usuarios mas activos
+ * no sean siempre los de IDs mas bajos (la afinidad depende de los IDs).
+ */
+size_t* generar_permutacion(size_t cant, unsigned long long* estado) {
+	size_t* permutacion = malloc(cant * sizeof(size_t));
+	if (!permutacion) return NULL;
+	for (size_t i = 0; i < cant; i++) permutacion[i] = i;
+	for (size_t i = cant - 1; i > 0; i--) {
+		size_t j = bench_aleatorio(estado) % (i + 1);
+		size_t aux = permutacion[i];
+		permutacion[i] = permutacion[j];
+		permutacion[j] = aux;
+	}
+	return permutacion;
+}
+
+// Escribe en nombre el nombre del usuario de ID id.
+void nombre_usuario(char* nombre, size_t id) {
+	snprintf(nombre, LARGO_MAX_LINEA, "usuario%zu", id);
+}
+
+// Reserva lugar para tam muestras; devuelve false si no hay memoria.
+bool latencias_crear(latencias_t* latencias, size_t tam) {
+	latencias->muestras = malloc((tam ? tam : 1) * sizeof(uint64_t));
+	latencias->cant = 0;
+	latencias->tam = tam;
+	latencias->fallidos = 0;
+	return latencias->muestras != NULL;
+}
+
+// Registra la latencia de un comando que empezo en inicio y si fallo.
+void latencias_agregar(latencias_t* latencias, uint64_t inicio, bool ok) {
+	uint64_t fin = nanosegundos_actuales();
+	if (latencias->cant < latencias->tam) latencias->muestras[latencias->cant++] = fin - inicio;
+	if (!ok) latencias->fallidos++;
+}
+
+int comparar_latencias(const void* a, const void* b) {
+	uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+	return (x > y) - (x < y);
+}
+
+// Devuelve el percentil p (entre 0 y 1) de muestras ordenadas, en microsegundos.
+double percentil(const latencias_t* latencias, double p) {
+	size_t pos = (size_t)(p * (double)(latencias->cant - 1) + 0.5);
+	return (double)latencias->muestras[pos] / 1e3;
+}
+
+/* PRE: Recibe el archivo del reporte, el nombre del comando y sus latencias.
+ * POST: Imprime la cantidad de ejecuciones, cuantas fallaron, las ejecuciones por segundo
+ * (sobre el tiempo pasado dentro del comando) y los percentiles de latencia.
+ */
+void reportar_latencias(FILE* reporte, const char* nombre, latencias_t* latencias) {
+	if (!latencias->cant) {
+		fprintf(reporte, "%-20s %10d\n", nombre, 0);
+		return;
+	}
+	qsort(latencias->muestras, latencias->cant, sizeof(uint64_t), comparar_latencias);
+	uint64_t total = 0;
+	for (size_t i = 0; i < latencias->cant; i++) total += latencias->muestras[i];
+	fprintf(reporte, "%-20s %10zu %9zu %12.0f %9.2f %9.2f %9.2f %9.2f %9.2f\n",
+		nombre, latencias->cant, latencias->fallidos, (double)latencias->cant / ((double)total / 1e9),
+		percentil(latencias, 0.5), percentil(latencias, 0.9), percentil(latencias, 0.99),
+		percentil(latencias, 0.999), (double)latencias->muestras[latencias->cant - 1] / 1e3);
+}
+
+/* PRE: Recibe la cantidad restante de cada comando de la carga.
+ * POST: Elige el siguiente comando con probabilidad proporcional a lo que resta de cada uno,
+ * de modo que los comandos quedan intercalados a lo largo de toda la corrida.
+ */
+operacion_t elegir_operacion(const size_t restantes[CANT_OPS], size_t total, unsigned long long* estado) {
+	size_t r = bench_aleatorio(estado) % total;
+	operacion_t op = OP_PUBLICAR;
+	while (r >= restantes[op]) r -= restantes[op++];
+	return op;
+}
+
+/* PRE: Recibe un AlgoGram, el usuario loggeado (o cant_usuarios si no hay ninguno), el
+ * usuario que tiene que ejecutar el siguiente comando y las latencias.
+ * POST: Cambia la sesion a ese usuario si hace falta, midiendo el logout y el login.
+ */
+void cambiar_sesion(algogram_t* algogram, size_t* loggeado, size_t usuario, size_t cant_usuarios, latencias_t latencias[CANT_OPS]) {
+	if (*loggeado == usuario) return;
+	char nombre[LARGO_MAX_LINEA];
+	nombre_usuario(nombre, usuario);
+	if (*loggeado != cant_usuarios) {
+		uint64_t inicio = nanosegundos_actuales();
+		bool ok = algogram_logout(algogram);
+		latencias_agregar(&latencias[OP_LOGOUT], inicio, ok);
+	}
+	uint64_t inicio = nanosegundos_actuales();
+	bool ok = algogram_login(algogram, nombre);
+	latencias_agregar(&latencias[OP_LOGIN], inicio, ok);
+	*loggeado = usuario;
+}
+
+
+/* *****************************************************************
+ *                    			MAIN
+ * *****************************************************************/
+
+/* Benchmark de punta a punta de AlgoGram con una carga sintetica determinista: crea los
+ * usuarios y ejecuta, intercalados, los posts, likes, lecturas del feed y consultas de likes
+ * pedidos, llamando a las mismas primitivas que usan los comandos de tp2. Los autores y los
+ * lectores se eligen con una distribucion de Zipf sobre los usuarios, y los posts likeados y
+ * consultados con una de Zipf sobre la antiguedad (los mas recientes son los mas populares).
+ * Las respuestas se descartan en /dev/null, y el reporte se imprime por salida estandar.
+ * En modo push, si se pasa una cantidad de hilos los posts se reparten en paralelo (y sin
+ * esperar a que termine el reparto si ademas se pasa relajado).
+ * Uso: ./bench [usuarios] [posts] [likes] [lecturas] [consultas] [sesgo] [push|pull] [hilos] [relajado]
+ */
+int main(int argc, char* argv[]) {
+	size_t cant_usuarios = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : USUARIOS_DEFAULT;
+	size_t cant_posts = argc > 2 ? (size_t)strtoul(argv[2], NULL, 10) : POSTS_DEFAULT;
+	size_t cant_likes = argc > 3 ? (size_t)strtoul(argv[3], NULL, 10) : LIKES_DEFAULT;
+	size_t cant_lecturas = argc > 4 ? (size_t)strtoul(argv[4], NULL, 10) : LECTURAS_DEFAULT;
+	size_t cant_consultas = argc > 5 ? (size_t)strtoul(argv[5], NULL, 10) : CONSULTAS_DEFAULT;
+	double sesgo = argc > 6 ? strtod(argv[6], NULL) : SESGO_DEFAULT;
+	feed_modo_t modo = argc > 7 && !strcmp(argv[7], "pull") ? FEED_PULL : FEED_PUSH;
+	size_t cant_hilos = argc > 8 ? (size_t)strtoul(argv[8], NULL, 10) : 0;
+	bool relajado = argc > 9 && !strcmp(argv[9], "relajado");
+	if (!cant_usuarios || !cant_posts || sesgo < 0) {
+		fprintf(stderr, "Error: parametros invalidos\n");
+		return -1;
+	}
+
+	// Las respuestas de AlgoGram van a salida estandar: se redirige a /dev/null y el
+	// reporte se escribe en una copia de la salida original.
+	int fd_reporte = dup(STDOUT_FILENO);
+	int fd_nulo = open("/dev/null", O_WRONLY);
+	FILE* reporte = fd_reporte < 0 ? NULL : fdopen(fd_reporte, "w");
+	if (!reporte || fd_nulo < 0 || dup2(fd_nulo, STDOUT_FILENO) < 0) {
+		fprintf(stderr, "Error: no se pudo redirigir la salida\n");
+		return -1;
+	}
+	close(fd_nulo);
+
+	unsigned long long estado = SEMILLA;
+	zipf_t* zipf_usuarios = zipf_crear(cant_usuarios, sesgo);
+	zipf_t* zipf_posts = zipf_crear(cant_posts, sesgo);
+	size_t* autores = generar_permutacion(cant_usuarios, &estado);
+	size_t* lectores = generar_permutacion(cant_usuarios, &estado);
+	size_t total = cant_posts + cant_likes + cant_lecturas + cant_consultas;
+	latencias_t latencias[CANT_OPS];
+	bool ok = zipf_usuarios && zipf_posts && autores && lectores;
+	ok &= latencias_crear(&latencias[OP_LOGIN], total);
+	ok &= latencias_crear(&latencias[OP_LOGOUT], total);
+	ok &= latencias_crear(&latencias[OP_PUBLICAR], cant_posts);
+	ok &= latencias_crear(&latencias[OP_VER_SIGUIENTE_FEED], cant_lecturas);
+	ok &= latencias_crear(&latencias[OP_LIKEAR_POST], cant_likes);
+	ok &= latencias_crear(&latencias[OP_MOSTRAR_LIKES], cant_consultas);
+	algogram_t* algogram = algogram_crear_con_modo(modo);
+	if (algogram && cant_hilos) ok &= algogram_repartir_en_paralelo(algogram, cant_hilos, relajado);
+	if (!ok || !algogram) {
+		fprintf(stderr, "Error: no hay memoria suficiente\n");
+		return -1;
+	}
+
+	char linea[LARGO_MAX_LINEA];
+	uint64_t inicio = nanosegundos_actuales();
+	algogram_reservar_usuarios(algogram, cant_usuarios);
+	for (size_t i = 0; i < cant_usuarios; i++) {
+		nombre_usuario(linea, i);
+		algogram_agregar_usuario(algogram, linea);
+	}
+	double tiempo_usuarios = (double)(nanosegundos_actuales() - inicio) / 1e9;
+
+	size_t restantes[CANT_OPS] = {0};
+	restantes[OP_PUBLICAR] = cant_posts;
+	restantes[OP_LIKEAR_POST] = cant_likes;
+	restantes[OP_VER_SIGUIENTE_FEED] = cant_lecturas;
+	restantes[OP_MOSTRAR_LIKES] = cant_consultas;
+	size_t publicados = 0, loggeado = cant_usuarios;
+	inicio = nanosegundos_actuales();
+	for (size_t quedan = total; quedan; quedan--) {
+		operacion_t op = elegir_operacion(restantes, quedan, &estado);
+		restantes[op]--;
+		size_t rango = zipf_muestra(zipf_usuarios, &estado);
+		size_t usuario = op == OP_PUBLICAR ? autores[rango] : lectores[rango];
+		if (op != OP_MOSTRAR_LIKES) cambiar_sesion(algogram, &loggeado, usuario, cant_usuarios, latencias);
+		if (op == OP_PUBLICAR) {
+			snprintf(linea, sizeof(linea), "post %zu de %zu", publicados, usuario);
+		} else if (op == OP_LIKEAR_POST || op == OP_MOSTRAR_LIKES) {
+			size_t antiguedad = publicados ? zipf_muestra(zipf_posts, &estado) % publicados : 0;
+			snprintf(linea, sizeof(linea), "%zu", publicados ? publicados - 1 - antiguedad : 0);
+		}
+		uint64_t inicio_op = nanosegundos_actuales();
+		bool ok_op;
+		switch (op) {
+			case OP_PUBLICAR: ok_op = algogram_publicar_post(algogram, linea); break;
+			case OP_VER_SIGUIENTE_FEED: ok_op = algogram_ver_post(algogram); break;
+			case OP_LIKEAR_POST: ok_op = algogram_likear_post(algogram, linea); break;
+			default: ok_op = algogram_ver_likes(algogram, linea); break;
+		}
+		latencias_agregar(&latencias[op], inicio_op, ok_op);
+		if (op == OP_PUBLICAR && ok_op) publicados++;
+	}
+	algogram_vaciar_salida(algogram);
+	double tiempo_carga = (double)(nanosegundos_actuales() - inicio) / 1e9;
+
+	size_t ejecutados = 0;
+	for (size_t op = 0; op < CANT_OPS; op++) ejecutados += latencias[op].cant;
+	fprintf(reporte, "usuarios=%zu posts=%zu likes=%zu lecturas=%zu consultas=%zu sesgo=%.2f modo=%s\n",
+		cant_usuarios, cant_posts, cant_likes, cant_lecturas, cant_consultas, sesgo, modo == FEED_PUSH ? "push" : "pull");
+	fprintf(reporte, "carga de usuarios: %.3f s (%.0f/s)\n", tiempo_usuarios, (double)cant_usuarios / tiempo_usuarios);
+	fprintf(reporte, "comandos: %zu en %.3f s (%.0f/s)\n\n", ejecutados, tiempo_carga, (double)ejecutados / tiempo_carga);
+	fprintf(reporte, "%-20s %10s %9s %12s %9s %9s %9s %9s %9s\n",
+		"comando", "ops", "fallidos", "ops/s", "p50(us)", "p90(us)", "p99(us)", "p999(us)", "max(us)");
+	for (size_t op = 0; op < CANT_OPS; op++) {
+		reportar_latencias(reporte, NOMBRES_OPS[op], &latencias[op]);
+		free(latencias[op].muestras);
+	}
+#ifdef ESTADISTICAS
+	fprintf(reporte, "\n");
+	fflush(reporte);
+	algogram_volcar_estadisticas(algogram, fileno(reporte));
+#endif
+	fclose(reporte);
+
+	algogram_destruir(algogram);
+	zipf_destruir(zipf_usuarios);
+	zipf_destruir(zipf_posts);
+	free(autores);
+	free(lectores);
+	return 0;
+}
@@ -0,0 +1,363 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "abb.h"
+#include "hash.h"
+#include "heap.h"
+#include "pila.h"
+
+#define CANT_DEFAULT 200000
+#define RONDAS 5
+#define MAX_RESULTADOS 128
+#define LARGO_ESCENARIO 32
+#define RAFAGA_MAX 16
+#define FACTOR_CARGA_HASH 0.65
+#define SEMILLA 2463534242ULL
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+// Resultado de una medicion: el mejor tiempo de RONDAS corridas de cant operaciones.
+typedef struct resultado {
+	const char* estructura;
+	const char* operacion;
+	char escenario[LARGO_ESCENARIO];
+	size_t cant;
+	double segundos;
+} resultado_t;
+
+typedef struct resultados {
+	resultado_t datos[MAX_RESULTADOS];
+	size_t cant;
+} resultados_t;
+
+// Orden de los elementos que se le pasan al heap y al abb.
+typedef enum { ORDEN_ALEATORIO, ORDEN_ASCENDENTE, ORDEN_DESCENDENTE, ORDEN_IGUALES } orden_t;
+
+static const char* NOMBRES_ORDENES[] = { "aleatorio", "ascendente", "descendente", "iguales" };
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Generador xorshift64, para que las entradas sean las mismas en todas las corridas.
+unsigned long long micro_aleatorio(unsigned long long* estado) {
+	*estado ^= *estado << 13;
+	*estado ^= *estado >> 7;
+	*estado ^= *estado << 17;
+	return *estado;
+}
+
+// Devuelve el tiempo actual en segundos, con un reloj monotono.
+double micro_segundos(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* PRE: Recibe los resultados, la estructura, la operacion, el escenario, la cantidad de
+ * operaciones de una ronda y el tiempo de esa ronda.
+ * POST: Se guardo el tiempo si es el primero o el mejor para esa medicion.
+ */
+void registrar(resultados_t* resultados, const char* estructura, const char* operacion, const char* escenario, size_t cant, double segundos) {
+	for (size_t i = 0; i < resultados->cant; i++) {
+		resultado_t* r = &resultados->datos[i];
+		if (r->estructura == estructura && r->operacion == operacion && !strcmp(r->escenario, escenario)) {
+			if (segundos < r->segundos) r->segundos = segundos;
+			return;
+		}
+	}
+	if (resultados->cant == MAX_RESULTADOS) return;
+	resultado_t* r = &resultados->datos[resultados->cant++];
+	r->estructura = estructura;
+	r->operacion = operacion;
+	snprintf(r->escenario, LARGO_ESCENARIO, "%s", escenario);
+	r->cant = cant;
+	r->segundos = segundos;
+}
+
+/* PRE: Recibe la cantidad de claves, su largo y el estado del generador.
+ * POST: Devuelve un arreglo de claves distintas de exactamente ese largo (al menos 8).
+ */
+char** micro_generar_claves(size_t cant, size_t largo, unsigned long long* estado) {
+	static const char alfabeto[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+	char** claves = malloc(cant * sizeof(char*));
+	if (!claves) return NULL;
+	for (size_t i = 0; i < cant; i++) {
+		claves[i] = malloc(largo + 1);
+		// Los ultimos 8 caracteres codifican el indice en base 36, para que no se repitan.
+		size_t resto = i;
+		for (size_t j = largo; j > largo - 8; j--) {
+			claves[i][j - 1] = alfabeto[resto % 36];
+			resto /= 36;
+		}
+		for (size_t j = 0; j < largo - 8; j++) {
+			claves[i][j] = alfabeto[micro_aleatorio(estado) % 36];
+		}
+		claves[i][largo] = '\0';
+	}
+	return claves;
+}
+
+// Libera un arreglo de claves.
+void micro_destruir_claves(char** claves, size_t cant) {
+	for (size_t i = 0; i < cant; i++) free(claves[i]);
+	free(claves);
+}
+
+// Devuelve una permutacion aleatoria de 0..cant-1.
+size_t* micro_permutacion(size_t cant, unsigned long long* estado) {
+	size_t* orden = malloc(cant * sizeof(size_t));
+	if (!orden) return NULL;
+	for (size_t i = 0; i < cant; i++) orden[i] = i;
+	for (size_t i = cant; i > 1; i--) {
+		size_t j = micro_aleatorio(estado) % i;
+		size_t aux = orden[i - 1];
+		orden[i - 1] = orden[j];
+		orden[j] = aux;
+	}
+	return orden;
+}
+
+// Llena valores con 0..cant-1 en el orden pedido.
+void generar_valores(size_t* valores, size_t cant, orden_t orden, unsigned long long* estado) {
+	for (size_t i = 0; i < cant; i++) {
+		switch (orden) {
+			case ORDEN_ASCENDENTE: valores[i] = i; break;
+			case ORDEN_DESCENDENTE: valores[i] = cant - 1 - i; break;
+			case ORDEN_IGUALES: valores[i] = 0; break;
+			default: valores[i] = micro_aleatorio(estado) % cant; break;
+		}
+	}
+}
+
+int comparar_valores(const void* a, const void* b) {
+	size_t x = *(const size_t*)a, y = *(const size_t*)b;
+	return (x > y) - (x < y);
+}
+
+bool visitar_contando(const char* clave, void* dato, void* extra) {
+	(void)clave;
+	(void)dato;
+	(*(size_t*)extra)++;
+	return true;
+}
+
+/* PRE: Recibe los resultados, la cantidad de claves, su largo y un factor de carga final
+ * (0 para dejar que el hash se redimensione solo, negativo para el hash incremental).
+ * POST: Mide guardar todas las claves, obtenerlas en orden aleatorio y borrarlas en otro orden.
+ */
+void medir_hash(resultados_t* resultados, size_t cant, size_t largo, double carga, unsigned long long* estado) {
+	char escenario[LARGO_ESCENARIO];
+	if (carga > 0) snprintf(escenario, LARGO_ESCENARIO, "clave%zu_carga%.2f", largo, carga);
+	else snprintf(escenario, LARGO_ESCENARIO, "clave%zu_%s", largo, carga < 0 ? "incremental" : "sin_reserva");
+	char** claves = micro_generar_claves(cant, largo, estado);
+	size_t* orden_obtener = micro_permutacion(cant, estado);
+	size_t* orden_borrar = micro_permutacion(cant, estado);
+	if (!claves || !orden_obtener || !orden_borrar) return;
+
+	size_t encontrados = 0;
+	for (size_t r = 0; r < RONDAS; r++) {
+		hash_t* hash = carga < 0 ? hash_crear_incremental(NULL) : hash_crear(NULL);
+		if (carga > 0) hash_reservar(hash, (size_t)((double)cant * FACTOR_CARGA_HASH / carga));
+		double inicio = micro_segundos();
+		for (size_t i = 0; i < cant; i++) hash_guardar(hash, claves[i], claves[i]);
+		registrar(resultados, "hash", "guardar", escenario, cant, micro_segundos() - inicio);
+
+		inicio = micro_segundos();
+		for (size_t i = 0; i < cant; i++) {
+			if (hash_obtener(hash, claves[orden_obtener[i]])) encontrados++;
+		}
+		registrar(resultados, "hash", "obtener", escenario, cant, micro_segundos() - inicio);
+
+		inicio = micro_segundos();
+		for (size_t i = 0; i < cant; i++) {
+			if (hash_borrar(hash, claves[orden_borrar[i]])) encontrados--;
+		}
+		registrar(resultados, "hash", "borrar", escenario, cant, micro_segundos() - inicio);
+		hash_destruir(hash);
+	}
+	if (encontrados) fprintf(stderr, "Advertencia: el hash perdio %zu claves\n", encontrados);
+	free(orden_obtener);
+	free(orden_borrar);
+	micro_destruir_claves(claves, cant);
+}
+
+/* PRE: Recibe los resultados, la cantidad de elementos y su orden.
+ * POST: Mide encolar todos los elementos uno por uno, desencolarlos, crear el heap de
+ * una vez (heap_crear_arr) y ordenarlos con heap_sort.
+ */
+void medir_heap(resultados_t* resultados, size_t cant, orden_t orden, unsigned long long* estado) {
+	const char* escenario = NOMBRES_ORDENES[orden];
+	size_t* valores = malloc(cant * sizeof(size_t));
+	void** punteros = malloc(cant * sizeof(void*));
+	void** copia = malloc(cant * sizeof(void*));
+	if (!valores || !punteros || !copia) return;
+	generar_valores(valores, cant, orden, estado);
+	for (size_t i = 0; i < cant; i++) punteros[i] = &valores[i];
+
+	for (size_t r = 0; r < RONDAS; r++) {
+		heap_t* heap = heap_crear(comparar_valores);
+		double inicio = micro_segundos();
+		for (size_t i = 0; i < cant; i++) heap_encolar(heap, punteros[i]);
+		registrar(resultados, "heap", "encolar", escenario, cant, micro_segundos() - inicio);
+
+		inicio = micro_segundos();
+		while (!heap_esta_vacio(heap)) heap_desencolar(heap);
+		registrar(resultados, "heap", "desencolar", escenario, cant, micro_segundos() - inicio);
+		heap_destruir(heap, NULL);
+
+		inicio = micro_segundos();
+		heap = heap_crear_arr(punteros, cant, comparar_valores);
+		registrar(resultados, "heap", "crear_arr", escenario, cant, micro_segundos() - inicio);
+		heap_destruir(heap, NULL);
+
+		memcpy(copia, punteros, cant * sizeof(void*));
+		inicio = micro_segundos();
+		heap_sort(copia, cant, comparar_valores);
+		registrar(resultados, "heap", "heap_sort", escenario, cant, micro_segundos() - inicio);
+	}
+	free(valores);
+	free(punteros);
+	free(copia);
+}
+
+/* PRE: Recibe los resultados, la cantidad de claves y si se guardan en orden o al azar.
+ * POST: Mide guardar todas las claves, buscarlas en orden aleatorio y recorrer el arbol in order.
+ */
+void medir_abb(resultados_t* resultados, size_t cant, bool ordenadas, unsigned long long* estado) {
+	const char* escenario = NOMBRES_ORDENES[ordenadas ? ORDEN_ASCENDENTE : ORDEN_ALEATORIO];
+	char** claves = malloc(cant * sizeof(char*));
+	size_t* orden_guardar = micro_permutacion(cant, estado);
+	size_t* orden_buscar = micro_permutacion(cant, estado);
+	if (!claves || !orden_guardar || !orden_buscar) return;
+	// Con ceros a la izquierda el orden alfabetico coincide con el numerico.
+	for (size_t i = 0; i < cant; i++) {
+		claves[i] = malloc(LARGO_ESCENARIO);
+		snprintf(claves[i], LARGO_ESCENARIO, "%012zu", ordenadas ? i : orden_guardar[i]);
+	}
+
+	size_t encontrados = 0, visitados = 0;
+	for (size_t r = 0; r < RONDAS; r++) {
+		abb_t* abb = abb_crear(strcmp, NULL);
+		double inicio = micro_segundos();
+		for (size_t i = 0; i < cant; i++) abb_guardar(abb, claves[i], NULL);
+		registrar(resultados, "abb", "guardar", escenario, cant, micro_segundos() - inicio);
+
+		inicio = micro_segundos();
+		for (size_t i = 0; i < cant; i++) {
+			if (abb_pertenece(abb, claves[orden_buscar[i]])) encontrados++;
+		}
+		registrar(resultados, "abb", "pertenece", escenario, cant, micro_segundos() - inicio);
+
+		inicio = micro_segundos();
+		abb_in_order(abb, visitar_contando, &visitados);
+		registrar(resultados, "abb", "in_order", escenario, cant, micro_segundos() - inicio);
+		abb_destruir(abb);
+	}
+	if (encontrados != visitados) fprintf(stderr, "Advertencia: el abb encontro %zu claves y recorrio %zu\n", encontrados, visitados);
+	free(orden_guardar);
+	free(orden_buscar);
+	micro_destruir_claves(claves, cant);
+}
+
+/* PRE: Recibe los resultados y la cantidad de elementos.
+ * POST: Mide apilar y desapilar todos los elementos de una vez, y un vaiven de rafagas
+ * de hasta RAFAGA_MAX apilados seguidos de otros tantos desapilados (cant operaciones en total).
+ */
+void medir_pila(resultados_t* resultados, size_t cant, unsigned long long* estado) {
+	unsigned char* rafagas = malloc(cant);
+	if (!rafagas) return;
+	for (size_t i = 0; i < cant; i++) rafagas[i] = (unsigned char)(1 + micro_aleatorio(estado) % RAFAGA_MAX);
+
+	for (size_t r = 0; r < RONDAS; r++) {
+		pila_t* pila = pila_crear();
+		double inicio = micro_segundos();
+		for (size_t i = 0; i < cant; i++) pila_apilar(pila, rafagas + i);
+		registrar(resultados, "pila", "apilar", "llenar", cant, micro_segundos() - inicio);
+
+		inicio = micro_segundos();
+		while (!pila_esta_vacia(pila)) pila_desapilar(pila);
+		registrar(resultados, "pila", "desapilar", "vaciar", cant, micro_segundos() - inicio);
+
+		inicio = micro_segundos();
+		size_t hechas = 0;
+		for (size_t i = 0; hechas < cant; i++) {
+			size_t rafaga = rafagas[i];
+			for (size_t j = 0; j < rafaga; j++) pila_apilar(pila, rafagas + i);
+			for (size_t j = 0; j < rafaga; j++) pila_desapilar(pila);
+			hechas += 2 * rafaga;
+		}
+		registrar(resultados, "pila", "apilar_desapilar", "rafagas", hechas, micro_segundos() - inicio);
+		pila_destruir(pila);
+	}
+	free(rafagas);
+}
+
+// Imprime los resultados en CSV, con una fila por medicion.
+void imprimir_csv(const resultados_t* resultados) {
+	printf("estructura,operacion,escenario,cantidad,ns_por_op,ops_por_seg\n");
+	for (size_t i = 0; i < resultados->cant; i++) {
+		const resultado_t* r = &resultados->datos[i];
+		printf("%s,%s,%s,%zu,%.2f,%.0f\n", r->estructura, r->operacion, r->escenario, r->cant,
+			r->segundos * 1e9 / (double)r->cant, (double)r->cant / r->segundos);
+	}
+}
+
+// Imprime los resultados como un arreglo JSON, con un objeto por medicion.
+void imprimir_json(const resultados_t* resultados) {
+	printf("[\n");
+	for (size_t i = 0; i < resultados->cant; i++) {
+		const resultado_t* r = &resultados->datos[i];
+		printf("  {\"estructura\": \"%s\", \"operacion\": \"%s\", \"escenario\": \"%s\", \"cantidad\": %zu, "
+			"\"ns_por_op\": %.2f, \"ops_por_seg\": %.0f}%s\n", r->estructura, r->operacion, r->escenario, r->cant,
+			r->segundos * 1e9 / (double)r->cant, (double)r->cant / r->segundos, i + 1 < resultados->cant ? "," : "");
+	}
+	printf("]\n");
+}
+
+
+/* *****************************************************************
+ *                    			MAIN
+ * *****************************************************************/
+
+/* Microbenchmarks de las primitivas de hash, heap, abb y pila, cada una aislada. Cada
+ * medicion es la mejor de RONDAS corridas, y las entradas son deterministas, para poder
+ * comparar la salida entre commits o entre implementaciones alternativas.
+ * Uso: ./bench_estructuras [cantidad] [csv|json]
+ */
+int main(int argc, char* argv[]) {
+	size_t cant = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : CANT_DEFAULT;
+	bool json = argc > 2 && !strcmp(argv[2], "json");
+	if (!cant || (argc > 2 && !json && strcmp(argv[2], "csv"))) {
+		fprintf(stderr, "Uso: %s [cantidad] [csv|json]\n", argv[0]);
+		return -1;
+	}
+	resultados_t* resultados = calloc(1, sizeof(resultados_t));
+	if (!resultados) return -1;
+	unsigned long long estado = SEMILLA;
+
+	static const size_t largos[] = { 8, 32, 128 };
+	static const double cargas[] = { 0, -1, 0.15, 0.35, 0.6 };
+	for (size_t i = 0; i < sizeof(largos) / sizeof(largos[0]); i++) {
+		for (size_t j = 0; j < sizeof(cargas) / sizeof(cargas[0]); j++) {
+			medir_hash(resultados, cant, largos[i], cargas[j], &estado);
+		}
+	}
+	for (orden_t orden = ORDEN_ALEATORIO; orden <= ORDEN_IGUALES; orden++) medir_heap(resultados, cant, orden, &estado);
+	medir_abb(resultados, cant, false, &estado);
+	medir_abb(resultados, cant, true, &estado);
+	medir_pila(resultados, cant, &estado);
+
+	if (json) imprimir_json(resultados);
+	else imprimir_csv(resultados);
+	free(resultados);
+	return 0;
+}
@@ -0,0 +1,150 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "hash.h"
+
+#define CANT_CLAVES_DEFAULT 1000000
+#define RONDAS 10
+#define LARGO_MIN_NOMBRE 4
+#define LARGO_MAX_NOMBRE 16
+#define LARGO_MAX_ID 24
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Generador xorshift64, para que las claves sean las mismas en todas las corridas.
+unsigned long long siguiente_aleatorio(unsigned long long* estado) {
+	*estado ^= *estado << 13;
+	*estado ^= *estado >> 7;
+	*estado ^= *estado << 17;
+	return *estado;
+}
+
+// Devuelve el tiempo actual en segundos, con un reloj monotono.
+double segundos_actuales(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* PRE: Recibe la cantidad de claves.
+ * POST: Devuelve un arreglo de nombres de usuario alfanumericos distintos, de largo variable.
+ */
+char** generar_nombres(size_t cant) {
+	static const char alfabeto[] = "abcdefghijklmnopqrstuvwxyz0123456789_";
+	char** claves = malloc(cant * sizeof(char*));
+	if (!claves) return NULL;
+	unsigned long long estado = 88172645463325252ULL;
+	for (size_t i = 0; i < cant; i++) {
+		size_t largo = LARGO_MIN_NOMBRE + siguiente_aleatorio(&estado) % (LARGO_MAX_NOMBRE - LARGO_MIN_NOMBRE + 1);
+		claves[i] = malloc(largo + LARGO_MAX_ID + 1);
+		for (size_t j = 0; j < largo; j++) {
+			claves[i][j] = alfabeto[siguiente_aleatorio(&estado) % (sizeof(alfabeto) - 1)];
+		}
+		// El sufijo con el indice garantiza que no haya nombres repetidos.
+		sprintf(claves[i] + largo, "%zu", i);
+	}
+	return claves;
+}
+
+/* PRE: Recibe la cantidad de claves.
+ * POST: Devuelve un arreglo con la representacion decimal de los IDs de post 0..cant-1.
+ */
+char** generar_ids(size_t cant) {
+	char** claves = malloc(cant * sizeof(char*));
+	if (!claves) return NULL;
+	for (size_t i = 0; i < cant; i++) {
+		claves[i] = malloc(LARGO_MAX_ID);
+		sprintf(claves[i], "%zu", i);
+	}
+	return claves;
+}
+
+// Libera un arreglo de claves.
+void destruir_claves(char** claves, size_t cant) {
+	for (size_t i = 0; i < cant; i++) free(claves[i]);
+	free(claves);
+}
+
+/* PRE: Recibe el nombre del conjunto de claves, las claves y su cantidad.
+ * POST: Guarda todas las claves en un hash, las busca RONDAS veces en orden aleatorio
+ * (y otras tantas claves ausentes, con un '#' agregado al final) e imprime las busquedas
+ * por segundo de la ronda mas rapida, para que el ruido de la maquina afecte lo menos posible.
+ */
+void medir_busquedas(const char* nombre, char** claves, size_t cant) {
+	hash_t* hash = hash_crear(NULL);
+	double inicio = segundos_actuales();
+	for (size_t i = 0; i < cant; i++) hash_guardar(hash, claves[i], claves[i]);
+	double tiempo_guardar = segundos_actuales() - inicio;
+
+	size_t* orden = malloc(cant * sizeof(size_t));
+	unsigned long long estado = 2463534242ULL;
+	for (size_t i = 0; i < cant; i++) orden[i] = siguiente_aleatorio(&estado) % cant;
+
+	size_t encontrados = 0;
+	double tiempo_aciertos = 0;
+	for (size_t r = 0; r < RONDAS; r++) {
+		inicio = segundos_actuales();
+		for (size_t i = 0; i < cant; i++) {
+			if (hash_obtener(hash, claves[orden[i]])) encontrados++;
+		}
+		double tiempo = segundos_actuales() - inicio;
+		if (!r || tiempo < tiempo_aciertos) tiempo_aciertos = tiempo;
+	}
+
+	char** ausentes = malloc(cant * sizeof(char*));
+	for (size_t i = 0; i < cant; i++) {
+		ausentes[i] = malloc(strlen(claves[i]) + 2);
+		sprintf(ausentes[i], "%s#", claves[i]);
+	}
+	double tiempo_fallos = 0;
+	for (size_t r = 0; r < RONDAS; r++) {
+		inicio = segundos_actuales();
+		for (size_t i = 0; i < cant; i++) {
+			if (hash_pertenece(hash, ausentes[orden[i]])) encontrados++;
+		}
+		double tiempo = segundos_actuales() - inicio;
+		if (!r || tiempo < tiempo_fallos) tiempo_fallos = tiempo;
+	}
+	destruir_claves(ausentes, cant);
+
+	double busquedas = (double)cant;
+	printf("%-8s claves=%zu guardar=%.0f/s aciertos=%.0f/s fallos=%.0f/s (encontrados=%zu)\n",
+		nombre, cant, (double)cant / tiempo_guardar, busquedas / tiempo_aciertos, busquedas / tiempo_fallos, encontrados);
+	free(orden);
+	hash_destruir(hash);
+}
+
+
+/* *****************************************************************
+ *                    			MAIN
+ * *****************************************************************/
+
+/* Microbenchmark de busquedas en hash_t sobre los dos conjuntos de claves de AlgoGram:
+ * nombres de usuario y representaciones decimales de IDs de post.
+ * Uso: ./bench_hash [cantidad_de_claves]
+ */
+int main(int argc, char* argv[]) {
+	size_t cant = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : CANT_CLAVES_DEFAULT;
+	if (!cant) {
+		fprintf(stderr, "Error: cantidad de claves invalida\n");
+		return -1;
+	}
+	char** nombres = generar_nombres(cant);
+	char** ids = generar_ids(cant);
+	if (!nombres || !ids) {
+		fprintf(stderr, "Error: no se pudieron generar las claves\n");
+		return -1;
+	}
+	medir_busquedas("usuarios", nombres, cant);
+	medir_busquedas("posts", ids, cant);
+	destruir_claves(nombres, cant);
+	destruir_claves(ids, cant);
+	return 0;
+}
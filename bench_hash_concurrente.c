@@ -0,0 +1,212 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hash.h"
+#include "hash_concurrente.h"
+
+#define CANT_CLAVES_DEFAULT 200000
+#define OPERACIONES_DEFAULT 2000000
+#define HILOS_MAX_DEFAULT 64
+#define LARGO_MAX_CLAVE 32
+#define SEMILLA 88172645463325252ULL
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+// Hash que se mide: el concurrente, o hash_t protegido por un unico lock de lectura/escritura.
+typedef struct tabla_medida {
+	hash_concurrente_t* concurrente;
+	hash_t* hash;
+	pthread_rwlock_t lock;
+} tabla_medida_t;
+
+/* Trabajo de un hilo: cant operaciones sobre claves al azar, de las cuales escrituras por mil
+ * son guardados o borrados (mitad y mitad) y el resto busquedas.
+ */
+typedef struct trabajo {
+	tabla_medida_t* tabla;
+	char** claves;
+	size_t cant_claves;
+	size_t cant;
+	size_t escrituras;
+	unsigned long long estado;
+	size_t encontradas;
+	pthread_t hilo;
+} trabajo_t;
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Generador xorshift64, uno por hilo para que no compartan estado.
+unsigned long long concurrente_aleatorio(unsigned long long* estado) {
+	*estado ^= *estado << 13;
+	*estado ^= *estado >> 7;
+	*estado ^= *estado << 17;
+	return *estado;
+}
+
+// Devuelve el tiempo actual en segundos, con un reloj monotono.
+double concurrente_segundos(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* PRE: Recibe la cantidad de claves.
+ * POST: Devuelve un arreglo de nombres de usuario distintos, o NULL si no hay memoria.
+ */
+char** generar_claves_concurrente(size_t cant) {
+	char** claves = malloc(cant * sizeof(char*));
+	if (!claves) return NULL;
+	for (size_t i = 0; i < cant; i++) {
+		claves[i] = malloc(LARGO_MAX_CLAVE);
+		if (!claves[i]) return NULL;
+		snprintf(claves[i], LARGO_MAX_CLAVE, "usuario%zu", i);
+	}
+	return claves;
+}
+
+/* PRE: Recibe la tabla medida y una clave.
+ * POST: Devuelve true si la clave esta, tomando el lock de lectura si es hash_t.
+ */
+bool tabla_medida_buscar(tabla_medida_t* tabla, const char* clave) {
+	if (tabla->concurrente) return hash_concurrente_pertenece(tabla->concurrente, clave);
+	pthread_rwlock_rdlock(&tabla->lock);
+	bool esta = hash_pertenece(tabla->hash, clave);
+	pthread_rwlock_unlock(&tabla->lock);
+	return esta;
+}
+
+/* PRE: Recibe la tabla medida, una clave y si hay que guardarla o borrarla.
+ * POST: Se guardo o borro la clave, tomando el lock de escritura si es hash_t.
+ */
+void tabla_medida_escribir(tabla_medida_t* tabla, const char* clave, bool guardar) {
+	if (tabla->concurrente) {
+		if (guardar) hash_concurrente_guardar(tabla->concurrente, clave, (void*)clave);
+		else hash_concurrente_borrar(tabla->concurrente, clave);
+		return;
+	}
+	pthread_rwlock_wrlock(&tabla->lock);
+	if (guardar) hash_guardar(tabla->hash, clave, (void*)clave);
+	else hash_borrar(tabla->hash, clave);
+	pthread_rwlock_unlock(&tabla->lock);
+}
+
+// Funcion de cada hilo: ejecuta las operaciones de su trabajo.
+void* ejecutar_trabajo(void* extra) {
+	trabajo_t* trabajo = extra;
+	for (size_t i = 0; i < trabajo->cant; i++) {
+		unsigned long long aleatorio = concurrente_aleatorio(&trabajo->estado);
+		const char* clave = trabajo->claves[aleatorio % trabajo->cant_claves];
+		size_t tipo = (size_t)(aleatorio >> 40) % 1000;
+		if (tipo < trabajo->escrituras) tabla_medida_escribir(trabajo->tabla, clave, tipo & 1);
+		else if (tabla_medida_buscar(trabajo->tabla, clave)) trabajo->encontradas++;
+	}
+	return NULL;
+}
+
+/* PRE: Recibe si se mide el hash concurrente, las claves, la cantidad de hilos, la de
+ * operaciones en total y las escrituras por mil.
+ * POST: Carga la mitad de las claves, mide las operaciones repartidas entre los hilos y
+ * escribe una linea CSV. Devuelve false si no se pudo hacer.
+ */
+bool medir_hash_concurrente(bool concurrente, char** claves, size_t cant_claves, size_t hilos, size_t cant, size_t escrituras) {
+	// El lock solo se inicializa (con pthread_rwlock_init) si se mide hash_t.
+	tabla_medida_t tabla;
+	tabla.concurrente = NULL;
+	tabla.hash = NULL;
+	if (concurrente) tabla.concurrente = hash_concurrente_crear(NULL);
+	else tabla.hash = hash_crear(NULL);
+	if (!tabla.concurrente && !tabla.hash) return false;
+	if (!concurrente && pthread_rwlock_init(&tabla.lock, NULL) != 0) {
+		hash_destruir(tabla.hash);
+		return false;
+	}
+	for (size_t i = 0; i < cant_claves; i += 2) tabla_medida_escribir(&tabla, claves[i], true);
+
+	trabajo_t* trabajos = calloc(hilos, sizeof(trabajo_t));
+	bool ok = trabajos != NULL;
+	size_t lanzados = 0;
+	double inicio = concurrente_segundos();
+	for (; ok && lanzados < hilos; lanzados++) {
+		trabajo_t* trabajo = &trabajos[lanzados];
+		trabajo->tabla = &tabla;
+		trabajo->claves = claves;
+		trabajo->cant_claves = cant_claves;
+		trabajo->cant = cant / hilos;
+		trabajo->escrituras = escrituras;
+		trabajo->estado = SEMILLA + lanzados * 2654435761ULL;
+		ok = pthread_create(&trabajo->hilo, NULL, ejecutar_trabajo, trabajo) == 0;
+		if (!ok) break;
+	}
+	size_t encontradas = 0;
+	for (size_t i = 0; i < lanzados; i++) {
+		pthread_join(trabajos[i].hilo, NULL);
+		encontradas += trabajos[i].encontradas;
+	}
+	double segundos = concurrente_segundos() - inicio;
+	if (ok) {
+		size_t total = cant / hilos * hilos;
+		printf("%s,%zu,%zu,%zu,%.6f,%.0f,%zu\n", concurrente ? "hash_concurrente" : "hash_rwlock", escrituras, hilos,
+			total, segundos, (double)total / segundos, encontradas);
+	}
+	free(trabajos);
+	if (concurrente) {
+		hash_concurrente_destruir(tabla.concurrente);
+	} else {
+		pthread_rwlock_destroy(&tabla.lock);
+		hash_destruir(tabla.hash);
+	}
+	return ok;
+}
+
+
+/* *****************************************************************
+ *                    			MAIN
+ * *****************************************************************/
+
+/* Mide como escala hash_concurrente_t con la cantidad de hilos (1, 2, 4, ... hasta el maximo),
+ * comparado con hash_t protegido por un lock de lectura/escritura, para cargas de solo
+ * busquedas, 1% y 10% de escrituras. La cantidad total de operaciones es la misma para
+ * todas las cantidades de hilos.
+ * Uso: ./bench_hash_concurrente [claves] [operaciones] [hilos maximos]
+ */
+int main(int argc, char* argv[]) {
+	size_t cant_claves = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : CANT_CLAVES_DEFAULT;
+	size_t cant = argc > 2 ? (size_t)strtoul(argv[2], NULL, 10) : OPERACIONES_DEFAULT;
+	size_t hilos_max = argc > 3 ? (size_t)strtoul(argv[3], NULL, 10) : HILOS_MAX_DEFAULT;
+	if (!cant_claves || !cant || !hilos_max) {
+		fprintf(stderr, "Uso: %s [claves] [operaciones] [hilos maximos]\n", argv[0]);
+		return -1;
+	}
+	char** claves = generar_claves_concurrente(cant_claves);
+	if (!claves) {
+		fprintf(stderr, "Error: no se pudieron generar las claves\n");
+		return -1;
+	}
+	static const size_t escrituras[] = { 0, 10, 100 };
+	printf("estructura,escrituras_por_mil,hilos,operaciones,segundos,operaciones_por_segundo,encontradas\n");
+	for (size_t i = 0; i < sizeof(escrituras) / sizeof(escrituras[0]); i++) {
+		for (size_t hilos = 1; hilos <= hilos_max; hilos *= 2) {
+			bool ok = medir_hash_concurrente(true, claves, cant_claves, hilos, cant, escrituras[i]);
+			ok = ok && medir_hash_concurrente(false, claves, cant_claves, hilos, cant, escrituras[i]);
+			if (!ok) {
+				fprintf(stderr, "Error: no se pudo medir con %zu hilos\n", hilos);
+				return -1;
+			}
+			fflush(stdout);
+		}
+	}
+	for (size_t i = 0; i < cant_claves; i++) free(claves[i]);
+	free(claves);
+	return 0;
+}
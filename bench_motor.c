@@ -0,0 +1,183 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "motor.h"
+#include "sesion.h"
+
+#define USUARIOS_DEFAULT 2000
+#define OPERACIONES_DEFAULT 20000
+#define CLIENTES_DEFAULT 8
+#define PARTICIONES_MAX_DEFAULT 8
+#define LARGO_MAX_LINEA 64
+#define SEMILLA 88172645463325252ULL
+
+// Porcentaje de cada operacion (el resto hasta 100 son consultas de likes).
+#define PORCENTAJE_PUBLICAR 20
+#define PORCENTAJE_VER 50
+#define PORCENTAJE_LIKEAR 25
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+// Trabajo de un hilo cliente.
+typedef struct cliente {
+	motor_t* motor;
+	size_t cant_usuarios;
+	size_t cant_operaciones;
+	unsigned long long estado;
+	size_t fallidos;
+	pthread_t hilo;
+} cliente_t;
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Generador xorshift64, uno por cliente para que no compartan estado.
+unsigned long long motor_aleatorio(unsigned long long* estado) {
+	*estado ^= *estado << 13;
+	*estado ^= *estado >> 7;
+	*estado ^= *estado << 17;
+	return *estado;
+}
+
+// Devuelve el tiempo actual en segundos, con un reloj monotono.
+double motor_segundos(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+void nombre_usuario_motor(char* nombre, size_t id) {
+	snprintf(nombre, LARGO_MAX_LINEA, "usuario%zu", id);
+}
+
+// Cuenta los likes de un post, como funcion visitar de motor_ver_likes.
+bool contar_likes_motor(size_t id, const char* nombre, void* extra) {
+	(void)id;
+	(void)nombre;
+	(*(size_t*)extra)++;
+	return true;
+}
+
+/* PRE: Recibe un cliente.
+ * POST: Ejecuta sus operaciones con su propia sesion: cada una loggea a un usuario al azar,
+ * hace una operacion (publicar, ver el feed, likear o ver los likes de un post conocido por
+ * el cliente) y cierra la sesion. Cuenta las que fallaron por un error interno (o porque no
+ * se pudo loggear).
+ */
+void* ejecutar_cliente(void* extra) {
+	cliente_t* cliente = extra;
+	sesion_t* sesion = sesion_crear();
+	if (!sesion) {
+		cliente->fallidos = cliente->cant_operaciones;
+		return NULL;
+	}
+	char linea[LARGO_MAX_LINEA];
+	size_t conocidos = 0;  // Los posts con ID menor ya existen (los vio o publico el cliente).
+	for (size_t i = 0; i < cliente->cant_operaciones; i++) {
+		nombre_usuario_motor(linea, motor_aleatorio(&cliente->estado) % cliente->cant_usuarios);
+		protocolo_estado_t estado = motor_login(cliente->motor, sesion, linea);
+		unsigned long long tipo = motor_aleatorio(&cliente->estado) % 100;
+		size_t id_post = conocidos ? motor_aleatorio(&cliente->estado) % conocidos : 0;
+		if (estado != PROTOCOLO_OK) {
+			cliente->fallidos++;
+			continue;
+		}
+		if (tipo < PORCENTAJE_PUBLICAR) {
+			snprintf(linea, sizeof(linea), "post %zu", i);
+			estado = motor_publicar(cliente->motor, sesion, linea, &id_post);
+			if (estado == PROTOCOLO_OK && id_post >= conocidos) conocidos = id_post + 1;
+		} else if (tipo < PORCENTAJE_PUBLICAR + PORCENTAJE_VER) {
+			vista_post_t vista;
+			estado = motor_ver_siguiente(cliente->motor, sesion, &vista);
+			if (estado == PROTOCOLO_OK && vista.id >= conocidos) conocidos = vista.id + 1;
+		} else if (tipo < PORCENTAJE_PUBLICAR + PORCENTAJE_VER + PORCENTAJE_LIKEAR) {
+			if (conocidos) estado = motor_likear(cliente->motor, sesion, id_post);
+		} else if (conocidos) {
+			size_t likes = 0;
+			estado = motor_ver_likes(cliente->motor, id_post, contar_likes_motor, &likes);
+		}
+		if (estado == PROTOCOLO_ERROR_INTERNO) cliente->fallidos++;
+		motor_logout(cliente->motor, sesion);
+	}
+	sesion_destruir(sesion);
+	return NULL;
+}
+
+/* PRE: Recibe la cantidad de particiones, de usuarios, de clientes y de operaciones por cliente.
+ * POST: Mide la corrida completa (con los clientes a la vez) y escribe una linea CSV. Devuelve
+ * false si no se pudo hacer.
+ */
+bool medir_motor(size_t cant_particiones, size_t cant_usuarios, size_t cant_clientes, size_t cant_operaciones) {
+	motor_t* motor = motor_crear(cant_particiones);
+	cliente_t* clientes = calloc(cant_clientes, sizeof(cliente_t));
+	bool ok = motor && clientes;
+	char nombre[LARGO_MAX_LINEA];
+	for (size_t i = 0; ok && i < cant_usuarios; i++) {
+		nombre_usuario_motor(nombre, i);
+		ok = motor_agregar_usuario(motor, nombre);
+	}
+	ok = ok && motor_iniciar(motor);
+	size_t lanzados = 0;
+	double inicio = motor_segundos();
+	for (; ok && lanzados < cant_clientes; lanzados++) {
+		cliente_t* cliente = &clientes[lanzados];
+		cliente->motor = motor;
+		cliente->cant_usuarios = cant_usuarios;
+		cliente->cant_operaciones = cant_operaciones;
+		cliente->estado = SEMILLA + lanzados * 2654435761ULL;
+		ok = pthread_create(&cliente->hilo, NULL, ejecutar_cliente, cliente) == 0;
+		if (!ok) break;
+	}
+	size_t fallidos = 0;
+	for (size_t i = 0; i < lanzados; i++) {
+		pthread_join(clientes[i].hilo, NULL);
+		fallidos += clientes[i].fallidos;
+	}
+	double segundos = motor_segundos() - inicio;
+	if (motor) motor_destruir(motor);
+	free(clientes);
+	if (!ok) return false;
+	size_t total = cant_clientes * cant_operaciones;
+	printf("%zu,%zu,%zu,%.6f,%.0f,%zu\n", cant_particiones, cant_clientes, total, segundos, (double)total / segundos, fallidos);
+	return true;
+}
+
+
+/* *****************************************************************
+ *                    			MAIN
+ * *****************************************************************/
+
+/* Mide el rendimiento del motor concurrente (ver motor.h) con varios clientes a la vez, para
+ * 1, 2, 4, ... particiones hasta el maximo pedido. Cada corrida empieza con un motor nuevo, y
+ * las entradas son deterministas por cliente (el intercalado entre hilos no lo es).
+ * Uso: ./bench_motor [usuarios] [operaciones por cliente] [clientes] [particiones maximas]
+ */
+int main(int argc, char* argv[]) {
+	size_t cant_usuarios = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : USUARIOS_DEFAULT;
+	size_t cant_operaciones = argc > 2 ? (size_t)strtoul(argv[2], NULL, 10) : OPERACIONES_DEFAULT;
+	size_t cant_clientes = argc > 3 ? (size_t)strtoul(argv[3], NULL, 10) : CLIENTES_DEFAULT;
+	size_t particiones_max = argc > 4 ? (size_t)strtoul(argv[4], NULL, 10) : PARTICIONES_MAX_DEFAULT;
+	if (!cant_usuarios || !cant_operaciones || !cant_clientes || !particiones_max) {
+		fprintf(stderr, "Uso: %s [usuarios] [operaciones por cliente] [clientes] [particiones maximas]\n", argv[0]);
+		return -1;
+	}
+	printf("particiones,clientes,operaciones,segundos,operaciones_por_segundo,fallidas\n");
+	for (size_t particiones = 1; particiones <= particiones_max; particiones *= 2) {
+		if (!medir_motor(particiones, cant_usuarios, cant_clientes, cant_operaciones)) {
+			fprintf(stderr, "Error: no se pudo medir con %zu particiones\n", particiones);
+			return -1;
+		}
+		fflush(stdout);
+	}
+	return 0;
+}
@@ -0,0 +1,332 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "bitacora.h"
+#include "instantanea.h"
+#include "salida.h"
+
+#define BITACORA_MAGICO "BITACORA"
+#define BITACORA_LARGO_MAGICO 8
+#define BITACORA_VERSION 2
+#define BITACORA_SUFIJO_TEMPORAL ".tmp"
+
+#define SUMA_INICIAL 2166136261U
+#define SUMA_PRIMO 16777619U
+#define NANOSEGUNDOS_POR_MILISEGUNDO 1000000
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+struct bitacora {
+	char* ruta;
+	int fd;
+	salida_t* salida;             // Buffer de los registros que todavia no se escribieron.
+	uint64_t secuencia;           // Secuencia del proximo registro.
+	uint32_t suma;                // Suma de control del registro que se esta agregando.
+	uint64_t ventana;             // En nanosegundos.
+	uint64_t primer_pendiente;    // Cuando se agrego el registro sin sincronizar mas antiguo.
+	bool sin_escribir;            // Hay registros en el buffer.
+	bool sin_sincronizar;         // Hay registros escritos que no se sincronizaron con el disco.
+	bool error;                   // Fallo alguna sincronizacion.
+};
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Devuelve el tiempo actual en nanosegundos, con un reloj monotono.
+uint64_t reloj_bitacora(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+// Devuelve la suma de control (FNV-1a) de los datos, continuando desde otra suma.
+uint32_t sumar_bytes(uint32_t suma, const void* datos, size_t largo) {
+	const unsigned char* bytes = datos;
+	for (size_t i = 0; i < largo; i++) suma = (suma ^ bytes[i]) * SUMA_PRIMO;
+	return suma;
+}
+
+/* PRE: Recibe una bitacora y datos de un registro.
+ * POST: Agrego los datos al buffer y a la suma de control del registro actual.
+ */
+void agregar_bytes(bitacora_t* bitacora, const void* datos, size_t largo) {
+	bitacora->suma = sumar_bytes(bitacora->suma, datos, largo);
+	salida_bytes(bitacora->salida, datos, largo);
+}
+
+/* PRE: Recibe una bitacora, un entero y su ancho en bytes.
+ * POST: Agrego el entero (little-endian) al buffer y a la suma de control del registro actual.
+ */
+void agregar_entero(bitacora_t* bitacora, uint64_t valor, size_t bytes) {
+	unsigned char codificado[sizeof(uint64_t)];
+	for (size_t i = 0; i < bytes; i++) {
+		codificado[i] = (unsigned char)(valor & 0xff);
+		valor >>= 8;
+	}
+	agregar_bytes(bitacora, codificado, bytes);
+}
+
+// Comienza un registro del tipo dado.
+void comenzar_registro(bitacora_t* bitacora, tipo_registro_t tipo) {
+	if (!bitacora->sin_escribir && !bitacora->sin_sincronizar) bitacora->primer_pendiente = reloj_bitacora();
+	bitacora->suma = SUMA_INICIAL;
+	agregar_entero(bitacora, tipo, INSTANTANEA_TAM_U8);
+}
+
+// Termina el registro actual con su suma de control.
+void terminar_registro(bitacora_t* bitacora) {
+	salida_entero(bitacora->salida, bitacora->suma, INSTANTANEA_TAM_U32);
+	bitacora->secuencia++;
+	bitacora->sin_escribir = true;
+}
+
+/* PRE: Recibe un lector posicionado al comienzo de un registro y donde guardarlo.
+ * POST: Devuelve true si hay un registro completo y con su suma de control correcta, dejando
+ * el lector despues de el. En caso contrario devuelve false.
+ */
+bool leer_registro(lector_instantanea_t* lector, registro_bitacora_t* registro) {
+	const char* inicio = lector->actual;
+	uint64_t tipo, id_usuario = 0, id_post = 0, largo = 0, suma;
+	const char* texto = NULL;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U8, &tipo)) return false;
+	if (tipo == BITACORA_USUARIO) {
+		if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U32, &largo)) return false;
+		texto = instantanea_leer_arreglo(lector, largo + 1, 1);
+		if (!texto || texto[largo] != '\0') return false;
+	} else if (tipo == BITACORA_POST) {
+		if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U32, &id_usuario)) return false;
+		if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U32, &largo)) return false;
+		texto = instantanea_leer_arreglo(lector, largo, 1);
+		if (!texto) return false;
+	} else if (tipo == BITACORA_LIKE) {
+		if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U32, &id_usuario)) return false;
+		if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, &id_post)) return false;
+	} else if (tipo == BITACORA_VISTO) {
+		if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U32, &id_usuario)) return false;
+	} else if (tipo != BITACORA_CARGA) {
+		return false;
+	}
+	uint32_t calculada = sumar_bytes(SUMA_INICIAL, inicio, (size_t)(lector->actual - inicio));
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U32, &suma) || suma != calculada) return false;
+	registro->tipo = (tipo_registro_t)tipo;
+	registro->id_usuario = id_usuario;
+	registro->id_post = id_post;
+	registro->texto = texto;
+	registro->largo = largo;
+	return true;
+}
+
+/* PRE: Recibe una bitacora abierta para lectura y escritura, la secuencia desde la que hay que
+ * aplicar los registros, la funcion que los aplica y su extra.
+ * POST: Aplica los registros, trunca el archivo despues del ultimo registro completo y guarda
+ * en secuencia la del proximo registro. Devuelve false si el archivo no es una bitacora, le
+ * faltan registros anteriores a desde o algun registro no se pudo aplicar.
+ */
+bool reproducir_bitacora(int fd, uint64_t desde, aplicar_registro_t aplicar, void* extra, uint64_t* secuencia) {
+	struct stat estado;
+	if (fstat(fd, &estado) == -1 || estado.st_size == 0) return false;
+	size_t tam = (size_t)estado.st_size;
+	void* datos = mmap(NULL, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (datos == MAP_FAILED) return false;
+	posix_madvise(datos, tam, POSIX_MADV_SEQUENTIAL);
+
+	lector_instantanea_t lector = { datos, (const char*)datos + tam };
+	const char* magico = instantanea_leer_arreglo(&lector, BITACORA_LARGO_MAGICO, 1);
+	uint64_t version, actual;
+	bool ok = magico && memcmp(magico, BITACORA_MAGICO, BITACORA_LARGO_MAGICO) == 0 &&
+		instantanea_leer_entero(&lector, INSTANTANEA_TAM_U32, &version) && version == BITACORA_VERSION &&
+		instantanea_leer_entero(&lector, INSTANTANEA_TAM_U64, &actual) && actual <= desde;
+	const char* valido = lector.actual;
+	registro_bitacora_t registro;
+	while (ok && leer_registro(&lector, &registro)) {
+		if (actual >= desde) ok = aplicar(&registro, extra);
+		actual++;
+		valido = lector.actual;
+	}
+	size_t largo_valido = (size_t)(valido - (const char*)datos);
+	munmap(datos, tam);
+	if (!ok) return false;
+	// Lo que sigue al ultimo registro completo es una escritura que no llego a confirmarse.
+	if (largo_valido < tam && ftruncate(fd, (off_t)largo_valido) == -1) return false;
+	if (lseek(fd, 0, SEEK_END) == -1) return false;
+	*secuencia = actual;
+	return true;
+}
+
+/* PRE: Recibe la ruta de una bitacora y la secuencia de su primer registro.
+ * POST: Reemplaza el archivo (de forma atomica) por una bitacora vacia, ya sincronizada con el
+ * disco, y devuelve su descriptor abierto para agregar registros, o -1 si no se pudo.
+ */
+int crear_archivo_bitacora(const char* ruta, uint64_t secuencia) {
+	size_t largo = strlen(ruta);
+	char* temporal = malloc(largo + sizeof(BITACORA_SUFIJO_TEMPORAL));
+	if (!temporal) return -1;
+	memcpy(temporal, ruta, largo);
+	memcpy(temporal + largo, BITACORA_SUFIJO_TEMPORAL, sizeof(BITACORA_SUFIJO_TEMPORAL));
+	int fd = open(temporal, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	salida_t* salida = fd == -1 ? NULL : salida_crear(fd);
+	bool ok = salida != NULL;
+	if (salida) {
+		salida_bytes(salida, BITACORA_MAGICO, BITACORA_LARGO_MAGICO);
+		salida_entero(salida, BITACORA_VERSION, INSTANTANEA_TAM_U32);
+		salida_entero(salida, secuencia, INSTANTANEA_TAM_U64);
+		ok = salida_vaciar(salida) && !salida_hubo_error(salida);
+		salida_destruir(salida);
+	}
+	ok = ok && fsync(fd) == 0 && rename(temporal, ruta) == 0;
+	if (!ok && fd != -1) {
+		close(fd);
+		unlink(temporal);
+		fd = -1;
+	}
+	free(temporal);
+	return fd;
+}
+
+/* PRE: Recibe una bitacora con registros escritos.
+ * POST: Los sincronizo con el disco.
+ */
+void sincronizar_bitacora(bitacora_t* bitacora) {
+	if (fdatasync(bitacora->fd) == -1) bitacora->error = true;
+	bitacora->sin_sincronizar = false;
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA BITACORA
+ * *****************************************************************/
+
+bitacora_t* bitacora_abrir(const char* ruta, uint64_t desde, size_t ventana, aplicar_registro_t aplicar, void* extra) {
+	bitacora_t* bitacora = malloc(sizeof(bitacora_t));
+	if (!bitacora) return NULL;
+	bitacora->ruta = strdup(ruta);
+	int fd = bitacora->ruta ? open(ruta, O_RDWR) : -1;
+	uint64_t secuencia = desde;
+	if (fd != -1 && !reproducir_bitacora(fd, desde, aplicar, extra, &secuencia)) {
+		close(fd);
+		free(bitacora->ruta);
+		free(bitacora);
+		return NULL;
+	}
+	// Una bitacora que no existe, o cuyos registros ya estan todos en la instantanea, empieza de nuevo en desde.
+	if (bitacora->ruta && (fd == -1 ? errno == ENOENT : secuencia < desde)) {
+		if (fd != -1) close(fd);
+		secuencia = desde;
+		fd = crear_archivo_bitacora(ruta, secuencia);
+	}
+	bitacora->salida = fd == -1 ? NULL : salida_crear(fd);
+	if (!bitacora->salida) {
+		if (fd != -1) close(fd);
+		free(bitacora->ruta);
+		free(bitacora);
+		return NULL;
+	}
+	bitacora->fd = fd;
+	bitacora->secuencia = secuencia;
+	bitacora->suma = SUMA_INICIAL;
+	bitacora->ventana = (uint64_t)ventana * NANOSEGUNDOS_POR_MILISEGUNDO;
+	bitacora->primer_pendiente = 0;
+	bitacora->sin_escribir = false;
+	bitacora->sin_sincronizar = false;
+	bitacora->error = false;
+	return bitacora;
+}
+
+void bitacora_registrar_usuario(bitacora_t* bitacora, const char* nombre) {
+	size_t largo = strlen(nombre);
+	comenzar_registro(bitacora, BITACORA_USUARIO);
+	agregar_entero(bitacora, largo, INSTANTANEA_TAM_U32);
+	agregar_bytes(bitacora, nombre, largo + 1);
+	terminar_registro(bitacora);
+}
+
+void bitacora_registrar_post(bitacora_t* bitacora, size_t id_usuario, const char* texto) {
+	size_t largo = strlen(texto);
+	comenzar_registro(bitacora, BITACORA_POST);
+	agregar_entero(bitacora, id_usuario, INSTANTANEA_TAM_U32);
+	agregar_entero(bitacora, largo, INSTANTANEA_TAM_U32);
+	agregar_bytes(bitacora, texto, largo);
+	terminar_registro(bitacora);
+}
+
+void bitacora_registrar_like(bitacora_t* bitacora, size_t id_usuario, size_t id_post) {
+	comenzar_registro(bitacora, BITACORA_LIKE);
+	agregar_entero(bitacora, id_usuario, INSTANTANEA_TAM_U32);
+	agregar_entero(bitacora, id_post, INSTANTANEA_TAM_U64);
+	terminar_registro(bitacora);
+}
+
+void bitacora_registrar_visto(bitacora_t* bitacora, size_t id_usuario) {
+	comenzar_registro(bitacora, BITACORA_VISTO);
+	agregar_entero(bitacora, id_usuario, INSTANTANEA_TAM_U32);
+	terminar_registro(bitacora);
+}
+
+void bitacora_registrar_carga(bitacora_t* bitacora) {
+	comenzar_registro(bitacora, BITACORA_CARGA);
+	terminar_registro(bitacora);
+}
+
+bool bitacora_confirmar(bitacora_t* bitacora) {
+	if (bitacora->sin_escribir) {
+		salida_vaciar(bitacora->salida);
+		bitacora->sin_escribir = false;
+		bitacora->sin_sincronizar = true;
+	}
+	if (bitacora->sin_sincronizar) sincronizar_bitacora(bitacora);
+	return !bitacora->error && !salida_hubo_error(bitacora->salida);
+}
+
+int bitacora_demora(const bitacora_t* bitacora) {
+	if (!bitacora->sin_escribir && !bitacora->sin_sincronizar) return 0;
+	uint64_t transcurrido = reloj_bitacora() - bitacora->primer_pendiente;
+	if (transcurrido >= bitacora->ventana) return 0;
+	// Se redondea para arriba, para no volver antes de que venza la ventana.
+	return (int)((bitacora->ventana - transcurrido + NANOSEGUNDOS_POR_MILISEGUNDO - 1) / NANOSEGUNDOS_POR_MILISEGUNDO);
+}
+
+uint64_t bitacora_secuencia(const bitacora_t* bitacora) {
+	return bitacora->secuencia;
+}
+
+bool bitacora_reiniciar(bitacora_t* bitacora) {
+	// Lo que quede en el buffer ya esta en la instantanea: se escribe en el archivo que se descarta.
+	salida_vaciar(bitacora->salida);
+	int fd = crear_archivo_bitacora(bitacora->ruta, bitacora->secuencia);
+	salida_t* salida = fd == -1 ? NULL : salida_crear(fd);
+	if (!salida) {
+		if (fd != -1) close(fd);
+		return false;
+	}
+	salida_destruir(bitacora->salida);
+	close(bitacora->fd);
+	bitacora->salida = salida;
+	bitacora->fd = fd;
+	bitacora->sin_escribir = false;
+	bitacora->sin_sincronizar = false;
+	bitacora->error = false;
+	return true;
+}
+
+bool bitacora_cerrar(bitacora_t* bitacora) {
+	bool ok = bitacora_confirmar(bitacora);
+	salida_destruir(bitacora->salida);
+	ok = close(bitacora->fd) == 0 && ok;
+	free(bitacora->ruta);
+	free(bitacora);
+	return ok;
+}
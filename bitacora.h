@@ -0,0 +1,129 @@
+#ifndef BITACORA_H
+#define BITACORA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Bitacora de los comandos que modifican AlgoGram, para no perderlos entre instantaneas (ver un
+ * post tambien cuenta, ya que avanza el feed del usuario).
+ * Cada registro se agrega al buffer de la bitacora (una sola copia en memoria), y se escribe
+ * y sincroniza con el disco en bitacora_confirmar, de modo que muchos registros comparten el
+ * mismo fsync (group commit). Quien usa la bitacora no debe responder un comando hasta
+ * confirmarla: bitacora_demora le dice cuanto puede esperar a que lleguen mas comandos.
+ *
+ * Garantia: un comando respondido despues de bitacora_confirmar esta en el disco. Con una
+ * ventana, ninguna respuesta se demora mas que la ventana desde que se registro el primer
+ * comando que todavia no se sincronizo.
+ *
+ * Formato del archivo, con enteros little-endian de ancho fijo:
+ *
+ *   encabezado  "BITACORA", version u32, secuencia del primer registro u64
+ *   registros   tipo u8, los datos del tipo y una suma de control u32 (FNV-1a del tipo y los
+ *               datos), donde los datos son:
+ *                 usuario  largo u32, nombre terminado en '\0'
+ *                 post     ID del posteador u32, largo u32, texto
+ *                 like     ID del usuario u32, ID del post u64
+ *                 visto    ID del usuario u32
+ *                 carga    (sin datos)
+ *
+ * Cada registro tiene un numero de secuencia implicito (el del primero mas su posicion), que
+ * es lo que guarda una instantanea para saber desde que registro hay que reproducir.
+ *
+ * El registro de carga marca que ya se agregaron todos los usuarios del archivo de usuarios. Si
+ * una bitacora sin instantanea no llega a ese registro, la carga se corto por una caida y sus
+ * usuarios no alcanzan: hay que volver a leer el archivo.
+ */
+typedef struct bitacora bitacora_t;
+
+typedef enum { BITACORA_USUARIO = 1, BITACORA_POST, BITACORA_LIKE, BITACORA_VISTO, BITACORA_CARGA } tipo_registro_t;
+
+// Registro leido de la bitacora. Los textos apuntan al archivo mapeado: hay que copiarlos.
+typedef struct registro_bitacora {
+	tipo_registro_t tipo;
+	size_t id_usuario;   // Posteador (post), usuario que likeo (like) o que vio el post (visto).
+	size_t id_post;      // Solo like.
+	const char* texto;   // Nombre (usuario, terminado en '\0') o texto del post (sin terminar).
+	size_t largo;
+} registro_bitacora_t;
+
+// Aplica un registro al reproducir la bitacora. Devuelve false si el registro no es valido.
+typedef bool (*aplicar_registro_t)(const registro_bitacora_t* registro, void* extra);
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA BITACORA
+ * *****************************************************************/
+
+/* PRE: Recibe la ruta de la bitacora, la secuencia del primer registro que no esta incluido
+ * en el estado actual, la ventana de group commit en milisegundos, y la funcion (con su extra)
+ * que aplica cada registro.
+ * POST: Si la bitacora existe, aplica en orden los registros desde esa secuencia y descarta lo
+ * que haya despues del ultimo registro completo (una escritura cortada por una caida). Si no
+ * existe, la crea vacia. Devuelve la bitacora lista para agregar registros, o NULL si no se
+ * pudo abrir, le faltan registros anteriores a los suyos o algun registro no se pudo aplicar.
+ */
+bitacora_t* bitacora_abrir(const char* ruta, uint64_t desde, size_t ventana, aplicar_registro_t aplicar, void* extra);
+
+/* PRE: Recibe una bitacora abierta y el nombre de un usuario agregado.
+ * POST: Agrego el registro al buffer de la bitacora.
+ */
+void bitacora_registrar_usuario(bitacora_t* bitacora, const char* nombre);
+
+/* PRE: Recibe una bitacora abierta, el ID del posteador y el texto de un post publicado.
+ * POST: Agrego el registro al buffer de la bitacora.
+ */
+void bitacora_registrar_post(bitacora_t* bitacora, size_t id_usuario, const char* texto);
+
+/* PRE: Recibe una bitacora abierta, el ID de un usuario y el ID del post que likeo.
+ * POST: Agrego el registro al buffer de la bitacora.
+ */
+void bitacora_registrar_like(bitacora_t* bitacora, size_t id_usuario, size_t id_post);
+
+/* PRE: Recibe una bitacora abierta y el ID de un usuario que vio el siguiente post de su feed.
+ * POST: Agrego el registro al buffer de la bitacora.
+ */
+void bitacora_registrar_visto(bitacora_t* bitacora, size_t id_usuario);
+
+/* PRE: Recibe una bitacora abierta en la que ya se registraron todos los usuarios del archivo.
+ * POST: Agrego el registro de carga completa al buffer de la bitacora.
+ */
+void bitacora_registrar_carga(bitacora_t* bitacora);
+
+/* PRE: Recibe una bitacora abierta.
+ * POST: Escribe los registros pendientes en el archivo y los sincroniza con el disco. Devuelve
+ * false si alguna escritura o sincronizacion fallo desde que se abrio la bitacora.
+ */
+bool bitacora_confirmar(bitacora_t* bitacora);
+
+/* PRE: Recibe una bitacora abierta.
+ * POST: Devuelve cuantos milisegundos faltan para que venza la ventana del registro sin
+ * confirmar mas antiguo, o 0 si no hay registros sin confirmar, la ventana es 0 o ya vencio (en
+ * ese caso hay que confirmar antes de responder).
+ */
+int bitacora_demora(const bitacora_t* bitacora);
+
+/* PRE: Recibe una bitacora abierta.
+ * POST: Devuelve la secuencia que va a tener el proximo registro.
+ */
+uint64_t bitacora_secuencia(const bitacora_t* bitacora);
+
+/* PRE: Recibe una bitacora abierta cuyos registros ya estan incluidos en una instantanea
+ * guardada con su secuencia.
+ * POST: Reemplaza el archivo por uno vacio que empieza en la secuencia actual. Devuelve false
+ * si no se pudo (la bitacora anterior sigue siendo valida).
+ */
+bool bitacora_reiniciar(bitacora_t* bitacora);
+
+/* PRE: Recibe una bitacora abierta.
+ * POST: Escribe y sincroniza los registros pendientes (sin esperar la ventana) y cierra la
+ * bitacora. Devuelve false si alguna escritura o sincronizacion fallo.
+ */
+bool bitacora_cerrar(bitacora_t* bitacora);
+
+#endif  // BITACORA_H
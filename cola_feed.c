@@ -0,0 +1,155 @@
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "cola_feed.h"
+#include "estadisticas.h"
+
+#define TAM_INICIAL 16
+#define FACTOR_REDIMENSION 2
+#define FACTOR_CANT_MIN 4
+#define BITS_ID 36
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+typedef struct entrada {
+	uint64_t clave;
+	post_t* post;
+} entrada_t;
+
+struct cola_feed {
+	entrada_t* entradas;
+	size_t cant;
+	size_t tam;
+};
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+/* PRE: Recibe una cola y un nuevo tamaño.
+ * POST: Devuelve true si se pudo redimensionar el arreglo de entradas, sino false.
+ */
+bool cola_feed_redimensionar(cola_feed_t* cola, size_t tam) {
+	entrada_t* entradas = realloc(cola->entradas, tam * sizeof(entrada_t));
+	if (!entradas) return false;
+	cola->entradas = entradas;
+	cola->tam = tam;
+	return true;
+}
+
+/* PRE: Recibe el arreglo de entradas, la posicion de un hueco y la entrada que debe ocuparlo.
+ * POST: Sube el hueco mientras el padre tenga menor prioridad que la entrada, y la ubica ahi.
+ */
+void cola_feed_upheap(entrada_t entradas[], size_t pos, entrada_t entrada) {
+	ESTADISTICA(size_t niveles = 0);
+	while (pos > 0) {
+		size_t pos_padre = (pos - 1) / 2;
+		if (entradas[pos_padre].clave <= entrada.clave) break;
+		entradas[pos] = entradas[pos_padre];
+		pos = pos_padre;
+		ESTADISTICA(niveles++);
+	}
+	entradas[pos] = entrada;
+	ESTADISTICA(histograma_agregar(&estadisticas.subidas_feed, niveles));
+}
+
+/* PRE: Recibe el arreglo de entradas, su cantidad, la posicion de un hueco y la entrada que debe ocuparlo.
+ * POST: Baja el hueco mientras algun hijo tenga mayor prioridad que la entrada, y la ubica ahi.
+ */
+void cola_feed_downheap(entrada_t entradas[], size_t cant, size_t pos, entrada_t entrada) {
+	ESTADISTICA(size_t niveles = 0);
+	while (2 * pos + 1 < cant) {
+		size_t pos_hijo = 2 * pos + 1;
+		if (pos_hijo + 1 < cant && entradas[pos_hijo + 1].clave < entradas[pos_hijo].clave) pos_hijo++;
+		if (entrada.clave <= entradas[pos_hijo].clave) break;
+		entradas[pos] = entradas[pos_hijo];
+		pos = pos_hijo;
+		ESTADISTICA(niveles++);
+	}
+	entradas[pos] = entrada;
+	ESTADISTICA(histograma_agregar(&estadisticas.bajadas_feed, niveles));
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA COLA DEL FEED
+ * *****************************************************************/
+
+cola_feed_t* cola_feed_crear(void) {
+	cola_feed_t* cola = malloc(sizeof(cola_feed_t));
+	if (!cola) return NULL;
+	cola->entradas = NULL;
+	cola->cant = 0;
+	cola->tam = 0;
+	return cola;
+}
+
+bool cola_feed_encolar(cola_feed_t* cola, post_t* post, size_t afinidad) {
+	size_t id = post_ver_id(post);
+	if (afinidad > COLA_FEED_AFINIDAD_MAX || id > COLA_FEED_ID_MAX) return false;
+	if (cola->cant == cola->tam) {
+		if (!cola_feed_redimensionar(cola, cola->tam ? cola->tam * FACTOR_REDIMENSION : TAM_INICIAL)) return false;
+	}
+	entrada_t entrada = { ((uint64_t)afinidad << BITS_ID) | (uint64_t)id, post };
+	cola_feed_upheap(cola->entradas, cola->cant, entrada);
+	cola->cant++;
+	return true;
+}
+
+post_t* cola_feed_ver_primero(const cola_feed_t* cola) {
+	return cola->cant ? cola->entradas[0].post : NULL;
+}
+
+post_t* cola_feed_desencolar(cola_feed_t* cola) {
+	if (!cola->cant) return NULL;
+	post_t* post = cola->entradas[0].post;
+	cola->cant--;
+	if (cola->cant) cola_feed_downheap(cola->entradas, cola->cant, 0, cola->entradas[cola->cant]);
+	if (cola->cant * FACTOR_CANT_MIN <= cola->tam && cola->tam / FACTOR_REDIMENSION >= TAM_INICIAL) {
+		cola_feed_redimensionar(cola, cola->tam / FACTOR_REDIMENSION);
+	}
+	return post;
+}
+
+size_t cola_feed_cantidad(const cola_feed_t* cola) {
+	return cola->cant;
+}
+
+bool cola_feed_esta_vacia(const cola_feed_t* cola) {
+	return cola->cant == 0;
+}
+
+void cola_feed_volcar(const cola_feed_t* cola, salida_t* salida) {
+	salida_entero(salida, cola->cant, INSTANTANEA_TAM_U64);
+	for (size_t i = 0; i < cola->cant; i++) salida_entero(salida, cola->entradas[i].clave, INSTANTANEA_TAM_U64);
+}
+
+bool cola_feed_restaurar(cola_feed_t* cola, lector_instantanea_t* lector, const tabla_posts_t* posts) {
+	uint64_t cant;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, &cant)) return false;
+	const unsigned char* claves = instantanea_leer_arreglo(lector, cant, INSTANTANEA_TAM_U64);
+	if (!claves) return false;
+	if (!cant) return true;
+	if (!cola_feed_redimensionar(cola, cant)) return false;
+	lector_instantanea_t lector_claves = { (const char*)claves, (const char*)claves + cant * INSTANTANEA_TAM_U64 };
+	for (size_t i = 0; i < cant; i++) {
+		uint64_t clave;
+		instantanea_leer_entero(&lector_claves, INSTANTANEA_TAM_U64, &clave);
+		post_t* post = tabla_posts_obtener(posts, clave & COLA_FEED_ID_MAX);
+		// Ninguna entrada puede tener mas prioridad que su padre en el heap.
+		if (!post || (i > 0 && cola->entradas[(i - 1) / 2].clave > clave)) return false;
+		cola->entradas[i].clave = clave;
+		cola->entradas[i].post = post;
+		cola->cant++;
+	}
+	return true;
+}
+
+void cola_feed_destruir(cola_feed_t* cola) {
+	free(cola->entradas);
+	free(cola);
+}
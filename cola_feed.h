@@ -0,0 +1,81 @@
+#ifndef COLA_FEED_H
+#define COLA_FEED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "post.h"
+#include "tabla_posts.h"
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Cola de prioridad especializada para el feed de un usuario. A diferencia de
+ * heap_t, guarda las entradas por valor en un unico arreglo contiguo y las ordena
+ * por una clave entera de 64 bits (afinidad en los bits altos, ID del post en los
+ * bajos) que se compara directamente, sin funcion de comparacion.
+ * Sale primero el post de menor afinidad y, a igual afinidad, el de menor ID.
+ */
+typedef struct cola_feed cola_feed_t;
+
+// Mayor afinidad y mayor ID de post que se pueden encolar. La afinidad es la distancia entre
+// los IDs de dos usuarios, por eso AlgoGram y el motor no dan IDs de usuario mayores al maximo.
+#define COLA_FEED_AFINIDAD_MAX ((1ULL << 28) - 1)
+#define COLA_FEED_ID_MAX ((1ULL << 36) - 1)
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA COLA DEL FEED
+ * *****************************************************************/
+
+// Crea una cola vacia. No pide memoria para las entradas hasta el primer encolado.
+cola_feed_t* cola_feed_crear(void);
+
+/* PRE: Recibe una cola previamente creada, un post y la afinidad del usuario con su posteador.
+ * POST: Devuelve true si se pudo encolar, en caso contrario false (tambien si la afinidad
+ * o el ID del post superan COLA_FEED_AFINIDAD_MAX o COLA_FEED_ID_MAX).
+ */
+bool cola_feed_encolar(cola_feed_t* cola, post_t* post, size_t afinidad);
+
+/* PRE: Recibe una cola previamente creada.
+ * POST: Devuelve el post de mayor prioridad sin sacarlo, o NULL si la cola esta vacia.
+ */
+post_t* cola_feed_ver_primero(const cola_feed_t* cola);
+
+/* PRE: Recibe una cola previamente creada.
+ * POST: Saca el post de mayor prioridad y lo devuelve, o NULL si la cola esta vacia.
+ */
+post_t* cola_feed_desencolar(cola_feed_t* cola);
+
+/* PRE: Recibe una cola previamente creada.
+ * POST: Devuelve la cantidad de posts encolados.
+ */
+size_t cola_feed_cantidad(const cola_feed_t* cola);
+
+/* PRE: Recibe una cola previamente creada.
+ * POST: Devuelve true si no hay posts encolados, en caso contrario false.
+ */
+bool cola_feed_esta_vacia(const cola_feed_t* cola);
+
+/* PRE: Recibe una cola previamente creada y la salida de una instantanea.
+ * POST: Se escribio la cantidad de entradas u64 y la clave u64 de cada una, en el orden del
+ * arreglo del heap (la clave incluye el ID del post, que se usa para restaurar el puntero).
+ */
+void cola_feed_volcar(const cola_feed_t* cola, salida_t* salida);
+
+/* PRE: Recibe una cola vacia, un lector posicionado donde se escribio una cola con
+ * cola_feed_volcar y la tabla con los posts ya restaurados.
+ * POST: Devuelve true si se restauraron todas las entradas, en el mismo orden (sin volver a
+ * armar el heap), o false si alguna clave no corresponde a un post, las claves no respetan el
+ * orden del heap o no hay memoria.
+ */
+bool cola_feed_restaurar(cola_feed_t* cola, lector_instantanea_t* lector, const tabla_posts_t* posts);
+
+/* PRE: Recibe una cola previamente creada.
+ * POST: Se destruyo la cola (no destruye los posts).
+ */
+void cola_feed_destruir(cola_feed_t* cola);
+
+#endif  // COLA_FEED_H
@@ -1 +1,16 @@
-algogram: tp2.o algogram.o usuario.o post.o hash.o pila.o abb.o heap.o
+algogram: tp2.o entrada.o algogram.o usuario.o post.o salida.o likes.o directorio.o nombres.o padron.o tabla_posts.o feed.o cola_feed.o pool.o instantanea.o bitacora.o sesion.o reparto.o hash.o pila.o abb.o heap.o estadisticas.o
+bench_hash: bench_hash.o hash.o estadisticas.o
+bench: bench.o algogram.o usuario.o post.o salida.o likes.o directorio.o nombres.o padron.o tabla_posts.o feed.o cola_feed.o pool.o instantanea.o bitacora.o sesion.o reparto.o hash.o pila.o abb.o heap.o estadisticas.o
+bench: LDLIBS += -lm -lpthread
+algogram: LDLIBS += -lpthread
+bench_estructuras: bench_estructuras.o abb.o pool.o pila.o hash.o heap.o estadisticas.o
+bench_motor: bench_motor.o motor.o sesion.o usuario.o post.o likes.o directorio.o nombres.o padron.o reparto.o tabla_posts.o feed.o cola_feed.o pool.o instantanea.o salida.o hash.o heap.o estadisticas.o
+bench_motor: LDLIBS += -lpthread
+bench_hash_concurrente: bench_hash_concurrente.o hash_concurrente.o hash.o estadisticas.o
+bench_hash_concurrente: LDLIBS += -lpthread
+estres_hash_concurrente: estres_hash_concurrente.o hash_concurrente.o hash.o estadisticas.o
+estres_hash_concurrente: LDLIBS += -lpthread
+estres_motor: estres_motor.o motor.o sesion.o usuario.o post.o likes.o directorio.o nombres.o padron.o reparto.o tabla_posts.o feed.o cola_feed.o pool.o instantanea.o salida.o hash.o heap.o estadisticas.o
+estres_motor: LDLIBS += -lpthread
+estres_reparto: estres_reparto.o reparto.o usuario.o post.o likes.o directorio.o nombres.o tabla_posts.o feed.o cola_feed.o pool.o instantanea.o salida.o hash.o heap.o estadisticas.o
+estres_reparto: LDLIBS += -lpthread
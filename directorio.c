@@ -0,0 +1,150 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "directorio.h"
+
+#define TAM_INICIAL 8
+#define FACTOR_REDIMENSION 2
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+struct directorio {
+	const char** nombres;  // Nombre de cada ID, o NULL si el ID no esta vigente.
+	size_t tam;            // Los IDs validos son menores a tam.
+	size_t cantidad;
+	size_t* orden;         // orden[r] es el ID del r-esimo nombre en orden alfabetico.
+	size_t* rangos;        // rangos[id] es la posicion de ese ID en orden.
+	size_t tam_rangos;
+	bool ordenado;
+};
+
+typedef struct entrada_orden {
+	const char* nombre;
+	size_t id;
+} entrada_orden_t;
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Compara dos entradas por nombre, para ordenarlas con qsort.
+int comparar_entradas_orden(const void* a, const void* b) {
+	const entrada_orden_t* entrada_a = a;
+	const entrada_orden_t* entrada_b = b;
+	return strcmp(entrada_a->nombre, entrada_b->nombre);
+}
+
+/* PRE: Recibe un directorio y un ID.
+ * POST: Devuelve true si el arreglo de nombres tiene lugar para ese ID, agrandandolo si hace falta.
+ */
+bool directorio_asegurar_id(directorio_t* directorio, size_t id) {
+	if (id < directorio->tam) return true;
+	size_t tam_nuevo = directorio->tam ? directorio->tam : TAM_INICIAL;
+	while (tam_nuevo <= id) tam_nuevo *= FACTOR_REDIMENSION;
+	const char** nombres = realloc(directorio->nombres, tam_nuevo * sizeof(const char*));
+	if (!nombres) return false;
+	memset(nombres + directorio->tam, 0, (tam_nuevo - directorio->tam) * sizeof(const char*));
+	directorio->nombres = nombres;
+	directorio->tam = tam_nuevo;
+	return true;
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL DIRECTORIO
+ * *****************************************************************/
+
+directorio_t* directorio_crear(void) {
+	directorio_t* directorio = calloc(1, sizeof(directorio_t));
+	if (!directorio) return NULL;
+	directorio->ordenado = true;
+	return directorio;
+}
+
+bool directorio_agregar(directorio_t* directorio, size_t id, const char* nombre) {
+	if (!directorio_asegurar_id(directorio, id)) return false;
+	directorio->nombres[id] = nombre;
+	directorio->cantidad++;
+	directorio->ordenado = false;
+	return true;
+}
+
+void directorio_quitar(directorio_t* directorio, size_t id) {
+	if (!directorio_nombre(directorio, id)) return;
+	directorio->nombres[id] = NULL;
+	directorio->cantidad--;
+	directorio->ordenado = false;
+}
+
+const char* directorio_nombre(const directorio_t* directorio, size_t id) {
+	return id < directorio->tam ? directorio->nombres[id] : NULL;
+}
+
+size_t directorio_cantidad(const directorio_t* directorio) {
+	return directorio->cantidad;
+}
+
+bool directorio_ordenar(directorio_t* directorio) {
+	if (directorio->ordenado) return true;
+	if (!directorio->cantidad) {
+		directorio->ordenado = true;
+		return true;
+	}
+	entrada_orden_t* entradas = malloc(directorio->cantidad * sizeof(entrada_orden_t));
+	size_t* orden = realloc(directorio->orden, directorio->cantidad * sizeof(size_t));
+	if (orden) directorio->orden = orden;
+	size_t* rangos = directorio->tam_rangos == directorio->tam ? directorio->rangos : realloc(directorio->rangos, directorio->tam * sizeof(size_t));
+	if (rangos) {
+		directorio->rangos = rangos;
+		directorio->tam_rangos = directorio->tam;
+	}
+	if (!entradas || !orden || !rangos) {
+		free(entradas);
+		return false;
+	}
+	size_t n = 0;
+	for (size_t id = 0; id < directorio->tam; id++) {
+		if (!directorio->nombres[id]) continue;
+		entradas[n].nombre = directorio->nombres[id];
+		entradas[n].id = id;
+		n++;
+	}
+	qsort(entradas, n, sizeof(entrada_orden_t), comparar_entradas_orden);
+	for (size_t r = 0; r < n; r++) {
+		orden[r] = entradas[r].id;
+		rangos[entradas[r].id] = r;
+	}
+	free(entradas);
+	directorio->ordenado = true;
+	return true;
+}
+
+size_t directorio_rango(const directorio_t* directorio, size_t id) {
+	return directorio->rangos[id];
+}
+
+size_t directorio_rango_desde(const directorio_t* directorio, const char* nombre) {
+	size_t inicio = 0;
+	size_t fin = directorio->cantidad;
+	while (inicio < fin) {
+		size_t medio = inicio + (fin - inicio) / 2;
+		if (strcmp(directorio->nombres[directorio->orden[medio]], nombre) < 0) inicio = medio + 1;
+		else fin = medio;
+	}
+	return inicio;
+}
+
+size_t directorio_id_en_rango(const directorio_t* directorio, size_t rango) {
+	return directorio->orden[rango];
+}
+
+void directorio_destruir(directorio_t* directorio) {
+	free(directorio->nombres);
+	free(directorio->orden);
+	free(directorio->rangos);
+	free(directorio);
+}
@@ -0,0 +1,76 @@
+#ifndef DIRECTORIO_H
+#define DIRECTORIO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Directorio de usuarios indexado por ID: guarda el nombre (internado) de cada ID
+ * vigente y la permutacion de los IDs en orden alfabetico de sus nombres. La
+ * permutacion se recalcula una sola vez despues de cada tanda de altas o bajas,
+ * la primera vez que se la consulta. El directorio no es dueño de los nombres.
+ */
+typedef struct directorio directorio_t;
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL DIRECTORIO
+ * *****************************************************************/
+
+// Crea un directorio vacio.
+directorio_t* directorio_crear(void);
+
+/* PRE: Recibe un directorio previamente creado, un ID sin nombre asignado y un nombre
+ * internado distinto al de los demas IDs vigentes.
+ * POST: Devuelve true si se pudo asignar el nombre al ID, en caso contrario false.
+ */
+bool directorio_agregar(directorio_t* directorio, size_t id, const char* nombre);
+
+/* PRE: Recibe un directorio previamente creado y un ID.
+ * POST: El ID dejo de estar vigente (si lo estaba).
+ */
+void directorio_quitar(directorio_t* directorio, size_t id);
+
+/* PRE: Recibe un directorio previamente creado y un ID.
+ * POST: Devuelve el nombre del ID, o NULL si no esta vigente.
+ */
+const char* directorio_nombre(const directorio_t* directorio, size_t id);
+
+/* PRE: Recibe un directorio previamente creado.
+ * POST: Devuelve la cantidad de IDs vigentes.
+ */
+size_t directorio_cantidad(const directorio_t* directorio);
+
+/* PRE: Recibe un directorio previamente creado.
+ * POST: Devuelve true si la permutacion alfabetica esta al dia (recalculandola si hacia
+ * falta), o false si no se pudo calcular. Debe llamarse antes de directorio_rango y
+ * directorio_id_en_rango, que valen hasta la siguiente alta o baja.
+ */
+bool directorio_ordenar(directorio_t* directorio);
+
+/* PRE: Recibe un directorio ordenado y un ID vigente.
+ * POST: Devuelve la posicion del nombre del ID en orden alfabetico (entre 0 y la cantidad - 1).
+ */
+size_t directorio_rango(const directorio_t* directorio, size_t id);
+
+/* PRE: Recibe un directorio ordenado y un nombre (no necesariamente de un usuario).
+ * POST: Devuelve la posicion alfabetica del primer nombre vigente mayor o igual al recibido,
+ * o la cantidad de IDs vigentes si no hay ninguno. Es O(log n).
+ */
+size_t directorio_rango_desde(const directorio_t* directorio, const char* nombre);
+
+/* PRE: Recibe un directorio ordenado y una posicion menor a la cantidad de IDs vigentes.
+ * POST: Devuelve el ID cuyo nombre ocupa esa posicion en orden alfabetico.
+ */
+size_t directorio_id_en_rango(const directorio_t* directorio, size_t rango);
+
+/* PRE: Recibe un directorio previamente creado.
+ * POST: Se destruyo el directorio (no destruye los nombres).
+ */
+void directorio_destruir(directorio_t* directorio);
+
+#endif  // DIRECTORIO_H
@@ -0,0 +1,126 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "entrada.h"
+
+#define TAM_BLOQUE (64 * 1024)
+#define FACTOR_REDIMENSION 2
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+struct entrada {
+	int fd;
+	char* datos;
+	size_t tam;         // Siempre queda un byte libre al final, para el '\0' de una ultima linea sin '\n'.
+	size_t inicio;      // Primer byte sin consumir.
+	size_t fin;         // Fin de los datos leidos.
+	size_t revisado;    // Desde inicio hasta aca ya se sabe que no hay '\n'.
+	bool fin_archivo;
+	bool terminada;
+	entrada_antes_de_leer_t antes_de_leer;
+	void* extra;
+};
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+/* PRE: Recibe una entrada sin ninguna linea completa disponible.
+ * POST: Lee otro bloque del descriptor, moviendo al principio del buffer la linea
+ * incompleta (o agrandandolo, si la linea ya lo ocupa entero). Devuelve false si no se
+ * pudo agrandar el buffer; al llegar al final del archivo marca fin_archivo.
+ */
+bool entrada_leer_bloque(entrada_t* entrada) {
+	if (entrada->inicio) {
+		memmove(entrada->datos, entrada->datos + entrada->inicio, entrada->fin - entrada->inicio);
+		entrada->fin -= entrada->inicio;
+		entrada->revisado -= entrada->inicio;
+		entrada->inicio = 0;
+	}
+	if (entrada->fin == entrada->tam - 1) {
+		char* datos = realloc(entrada->datos, entrada->tam * FACTOR_REDIMENSION);
+		if (!datos) return false;
+		entrada->datos = datos;
+		entrada->tam *= FACTOR_REDIMENSION;
+	}
+	if (entrada->antes_de_leer) entrada->antes_de_leer(entrada->extra);
+	ssize_t leidos;
+	do {
+		leidos = read(entrada->fd, entrada->datos + entrada->fin, entrada->tam - 1 - entrada->fin);
+	} while (leidos == -1 && errno == EINTR);
+	if (leidos <= 0) entrada->fin_archivo = true;
+	else entrada->fin += (size_t)leidos;
+	return true;
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA ENTRADA
+ * *****************************************************************/
+
+entrada_t* entrada_crear(int fd, entrada_antes_de_leer_t antes_de_leer, void* extra) {
+	entrada_t* entrada = malloc(sizeof(entrada_t));
+	if (!entrada) return NULL;
+	entrada->datos = malloc(TAM_BLOQUE);
+	if (!entrada->datos) {
+		free(entrada);
+		return NULL;
+	}
+	entrada->fd = fd;
+	entrada->tam = TAM_BLOQUE;
+	entrada->inicio = 0;
+	entrada->fin = 0;
+	entrada->revisado = 0;
+	entrada->fin_archivo = false;
+	entrada->terminada = false;
+	entrada->antes_de_leer = antes_de_leer;
+	entrada->extra = extra;
+	return entrada;
+}
+
+char* entrada_linea(entrada_t* entrada, size_t* largo) {
+	char* salto;
+	while (!(salto = memchr(entrada->datos + entrada->revisado, '\n', entrada->fin - entrada->revisado))) {
+		entrada->revisado = entrada->fin;
+		if (entrada->fin_archivo || !entrada_leer_bloque(entrada)) {
+			if (entrada->inicio == entrada->fin) return NULL;
+			// Ultima linea sin '\n': se termina en el byte libre reservado al final del buffer.
+			salto = entrada->datos + entrada->fin;
+			break;
+		}
+	}
+	char* linea = entrada->datos + entrada->inicio;
+	entrada->terminada = salto < entrada->datos + entrada->fin;
+	*salto = '\0';
+	if (largo) *largo = (size_t)(salto - linea);
+	entrada->inicio = (size_t)(salto - entrada->datos) + (entrada->terminada ? 1 : 0);
+	entrada->revisado = entrada->inicio;
+	return linea;
+}
+
+const char* entrada_bytes(entrada_t* entrada, size_t largo) {
+	while (entrada->fin - entrada->inicio < largo) {
+		if (entrada->fin_archivo || !entrada_leer_bloque(entrada)) return NULL;
+	}
+	const char* datos = entrada->datos + entrada->inicio;
+	entrada->inicio += largo;
+	if (entrada->revisado < entrada->inicio) entrada->revisado = entrada->inicio;
+	return datos;
+}
+
+bool entrada_linea_terminada(const entrada_t* entrada) {
+	return entrada->terminada;
+}
+
+void entrada_destruir(entrada_t* entrada) {
+	free(entrada->datos);
+	free(entrada);
+}
@@ -0,0 +1,58 @@
+#ifndef ENTRADA_H
+#define ENTRADA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Lector de lineas sobre un descriptor de archivo. Lee de a bloques grandes en un
+ * buffer propio y devuelve cada linea como una vista dentro del buffer (terminada
+ * en '\0' en lugar del '\n'), sin copiarla ni pedir memoria por linea.
+ */
+typedef struct entrada entrada_t;
+
+/* Funcion que se llama justo antes de cada lectura del descriptor, es decir, cuando ya
+ * se consumieron todas las lineas disponibles y la lectura puede bloquearse.
+ */
+typedef void (*entrada_antes_de_leer_t)(void* extra);
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA ENTRADA
+ * *****************************************************************/
+
+/* PRE: Recibe un descriptor de archivo abierto para lectura, y una funcion a llamar antes de
+ * cada lectura (o NULL) junto con el dato que recibe.
+ * POST: Devuelve una entrada que lee de ese descriptor, o NULL si no se pudo crear.
+ */
+entrada_t* entrada_crear(int fd, entrada_antes_de_leer_t antes_de_leer, void* extra);
+
+/* PRE: Recibe una entrada previamente creada y donde guardar el largo de la linea (o NULL).
+ * POST: Devuelve la siguiente linea, sin el '\n' y terminada en '\0', o NULL si no quedan
+ * lineas (o hubo un error de lectura). La linea es valida hasta la siguiente llamada y se
+ * puede modificar sin superar su largo.
+ */
+char* entrada_linea(entrada_t* entrada, size_t* largo);
+
+/* PRE: Recibe una entrada previamente creada y una cantidad de bytes.
+ * POST: Devuelve una vista de los siguientes largo bytes, o NULL si la entrada termina antes
+ * (o no se pudo agrandar el buffer). La vista es valida hasta la siguiente lectura.
+ */
+const char* entrada_bytes(entrada_t* entrada, size_t largo);
+
+/* PRE: Recibe una entrada de la que se obtuvo al menos una linea.
+ * POST: Devuelve true si la ultima linea terminaba en '\n', o false si era el final del
+ * archivo sin '\n'.
+ */
+bool entrada_linea_terminada(const entrada_t* entrada);
+
+/* PRE: Recibe una entrada previamente creada.
+ * POST: Se destruyo la entrada (no cierra el descriptor).
+ */
+void entrada_destruir(entrada_t* entrada);
+
+#endif  // ENTRADA_H
@@ -0,0 +1,104 @@
+#define _POSIX_C_SOURCE 200809L
+#include "estadisticas.h"
+
+#ifdef ESTADISTICAS
+
+#include <time.h>
+
+__thread estadisticas_t estadisticas;
+histograma_latencias_t latencias_comandos[ESTADISTICAS_COMANDOS];
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Devuelve la posicion del bit mas significativo de un valor distinto de cero.
+size_t bit_mas_significativo(uint64_t valor) {
+	size_t bit = 0;
+	for (size_t paso = 32; paso; paso /= 2) {
+		if (valor >> paso) {
+			valor >>= paso;
+			bit += paso;
+		}
+	}
+	return bit;
+}
+
+// Devuelve el rango del histograma de latencias en el que cae un valor.
+size_t latencias_rango(uint64_t valor) {
+	if (valor < LATENCIAS_SUBRANGOS) return (size_t)valor;
+	size_t desplazamiento = bit_mas_significativo(valor) - LATENCIAS_BITS_SUBRANGO;
+	return (desplazamiento + 1) * LATENCIAS_SUBRANGOS + (size_t)(valor >> desplazamiento) - LATENCIAS_SUBRANGOS;
+}
+
+// Devuelve el mayor valor que cae en un rango del histograma de latencias.
+uint64_t latencias_fin_rango(size_t rango) {
+	if (rango < LATENCIAS_SUBRANGOS) return rango;
+	size_t desplazamiento = rango / LATENCIAS_SUBRANGOS - 1;
+	uint64_t inicio = (uint64_t)(LATENCIAS_SUBRANGOS + rango % LATENCIAS_SUBRANGOS) << desplazamiento;
+	return inicio + ((uint64_t)1 << desplazamiento) - 1;
+}
+
+// Suma el histograma de origen al de destino.
+void histograma_sumar(histograma_t* destino, const histograma_t* origen) {
+	for (size_t rango = 0; rango < HISTOGRAMA_RANGOS; rango++) destino->rangos[rango] += origen->rangos[rango];
+	destino->cantidad += origen->cantidad;
+	destino->suma += origen->suma;
+	if (origen->maximo > destino->maximo) destino->maximo = origen->maximo;
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LAS ESTADISTICAS
+ * *****************************************************************/
+
+void histograma_agregar(histograma_t* histograma, size_t valor) {
+	size_t rango = 0;
+	for (size_t v = valor; v && rango < HISTOGRAMA_RANGOS - 1; v >>= 1) rango++;
+	histograma->rangos[rango]++;
+	histograma->cantidad++;
+	histograma->suma += valor;
+	if (valor > histograma->maximo) histograma->maximo = valor;
+}
+
+void estadisticas_transferir(estadisticas_t* destino, estadisticas_t* origen) {
+	histograma_sumar(&destino->sondeos_hash, &origen->sondeos_hash);
+	destino->redimensiones_hash += origen->redimensiones_hash;
+	histograma_sumar(&destino->subidas_feed, &origen->subidas_feed);
+	histograma_sumar(&destino->bajadas_feed, &origen->bajadas_feed);
+	histograma_sumar(&destino->distancias_pull, &origen->distancias_pull);
+	*origen = (estadisticas_t){ { 0 } };
+}
+
+size_t histograma_inicio_rango(size_t rango) {
+	return rango ? (size_t)1 << (rango - 1) : 0;
+}
+
+uint64_t estadisticas_reloj(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void latencias_registrar(histograma_latencias_t* latencias, uint64_t latencia) {
+	latencias->rangos[latencias_rango(latencia)]++;
+	latencias->cantidad++;
+	if (latencia > latencias->maximo) latencias->maximo = latencia;
+}
+
+uint64_t latencias_percentil(const histograma_latencias_t* latencias, double percentil) {
+	double objetivo = percentil * (double)latencias->cantidad;
+	size_t posicion = (size_t)objetivo;
+	if ((double)posicion < objetivo || !posicion) posicion++;
+	size_t acumulado = 0;
+	for (size_t rango = 0; rango < LATENCIAS_RANGOS; rango++) {
+		acumulado += latencias->rangos[rango];
+		if (acumulado < posicion) continue;
+		uint64_t fin = latencias_fin_rango(rango);
+		return fin < latencias->maximo ? fin : latencias->maximo;
+	}
+	return latencias->maximo;
+}
+
+#endif  // ESTADISTICAS
@@ -0,0 +1,111 @@
+#ifndef ESTADISTICAS_H
+#define ESTADISTICAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Contadores internos de las estructuras (sondeos del hash, niveles que recorren las colas
+ * del feed, distancias del feed en modo pull) y latencias de los comandos. Solo existen si se
+ * compila con -DESTADISTICAS: en caso contrario ESTADISTICA(...) no genera codigo, y los lazos
+ * instrumentados quedan exactamente como sin instrumentar.
+ *
+ * Los contadores de las estructuras son por hilo: cada hilo actualiza los suyos sin
+ * sincronizar, y un hilo que trabaja para otro (el reparto en paralelo, las particiones del
+ * motor) se los pasa con estadisticas_transferir en un punto donde ya estan sincronizados. Las
+ * latencias de los comandos las registra solo el hilo que atiende los comandos.
+ */
+#ifdef ESTADISTICAS
+
+// Ejecuta la sentencia solo si las estadisticas estan habilitadas (no puede contener comas).
+#define ESTADISTICA(sentencia) sentencia
+
+// Rangos del histograma: 0, 1, 2-3, 4-7, ..., y el ultimo acumula todo lo que no entra.
+#define HISTOGRAMA_RANGOS 12
+
+/* Histograma de latencias al estilo HDR: los valores menores a LATENCIAS_SUBRANGOS van cada uno
+ * en su rango, y cada potencia de 2 mayor se divide en LATENCIAS_SUBRANGOS rangos iguales, de
+ * modo que el error relativo de cualquier valor es menor a 1 / LATENCIAS_SUBRANGOS (~3%).
+ */
+#define LATENCIAS_BITS_SUBRANGO 5
+#define LATENCIAS_SUBRANGOS (1 << LATENCIAS_BITS_SUBRANGO)
+#define LATENCIAS_RANGOS ((64 - LATENCIAS_BITS_SUBRANGO + 1) * LATENCIAS_SUBRANGOS)
+
+// Cantidad de histogramas de latencia de comandos (uno por posicion de la tabla de comandos).
+#define ESTADISTICAS_COMANDOS 20
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+// Histograma de valores enteros en rangos de potencias de 2.
+typedef struct histograma {
+	size_t cantidad;
+	size_t suma;
+	size_t maximo;
+	size_t rangos[HISTOGRAMA_RANGOS];
+} histograma_t;
+
+// Latencias en nanosegundos de un comando.
+typedef struct histograma_latencias {
+	const char* nombre;  // NULL mientras no se haya registrado ninguna latencia.
+	size_t cantidad;
+	uint64_t maximo;
+	size_t rangos[LATENCIAS_RANGOS];
+} histograma_latencias_t;
+
+typedef struct estadisticas {
+	histograma_t sondeos_hash;      // Celdas que recorre cada busqueda en una tabla de hash.
+	size_t redimensiones_hash;
+	histograma_t subidas_feed;      // Niveles que sube cada post encolado en una cola del feed.
+	histograma_t bajadas_feed;      // Niveles que baja la ultima entrada en cada desencolado.
+	histograma_t distancias_pull;   // Distancias que avanza el cursor en cada lectura del feed (modo pull).
+} estadisticas_t;
+
+// Contadores del hilo actual.
+extern __thread estadisticas_t estadisticas;
+
+// Latencias de cada comando, indexadas igual que la tabla de comandos.
+extern histograma_latencias_t latencias_comandos[ESTADISTICAS_COMANDOS];
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LAS ESTADISTICAS
+ * *****************************************************************/
+
+/* PRE: Recibe un histograma y un valor.
+ * POST: Se agrego el valor al histograma.
+ */
+void histograma_agregar(histograma_t* histograma, size_t valor);
+
+/* PRE: Recibe los contadores de destino y los de origen, que nadie mas esta actualizando.
+ * POST: Sumo los contadores de origen a los de destino y dejo los de origen en cero.
+ */
+void estadisticas_transferir(estadisticas_t* destino, estadisticas_t* origen);
+
+/* PRE: Recibe el numero de un rango del histograma.
+ * POST: Devuelve el menor valor que cae en ese rango.
+ */
+size_t histograma_inicio_rango(size_t rango);
+
+// Devuelve el tiempo actual en nanosegundos, con un reloj monotono.
+uint64_t estadisticas_reloj(void);
+
+/* PRE: Recibe un histograma de latencias y una latencia en nanosegundos.
+ * POST: Se agrego la latencia al histograma, en tiempo constante.
+ */
+void latencias_registrar(histograma_latencias_t* latencias, uint64_t latencia);
+
+/* PRE: Recibe un histograma de latencias con al menos una latencia y un percentil entre 0 y 1.
+ * POST: Devuelve la latencia de ese percentil: el mayor valor del rango donde cae (nunca mayor
+ * que la latencia maxima registrada).
+ */
+uint64_t latencias_percentil(const histograma_latencias_t* latencias, double percentil);
+
+#else
+
+#define ESTADISTICA(sentencia)
+
+#endif  // ESTADISTICAS
+
+#endif  // ESTADISTICAS_H
@@ -0,0 +1,182 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "hash_concurrente.h"
+
+#define CANT_CLAVES_DEFAULT 20000
+#define OPERACIONES_DEFAULT 200000
+#define ESCRITORES_DEFAULT 4
+#define LECTORES_DEFAULT 4
+#define FIJAS_POR_DIEZ 1  // Fraccion de las claves que se cargan al principio y nunca se borran.
+#define LARGO_MAX_CLAVE 32
+#define SEMILLA 88172645463325252ULL
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Estado compartido de la prueba. Cada escritor es el unico que guarda y borra las claves
+ * cuyo indice es congruente con su numero modulo la cantidad de escritores, por lo que el
+ * modelo (esta) de cada clave lo escribe un solo hilo y no necesita sincronizacion.
+ */
+typedef struct prueba_hash {
+	hash_concurrente_t* hash;
+	char** claves;
+	bool* esta;
+	size_t cant_claves;
+	size_t fijas;
+	size_t escritores;
+	size_t operaciones;
+	int terminar;   // Lo escribe el hilo principal con __atomic_store_n al terminar los escritores.
+	size_t errores; // Se incrementa con __atomic_fetch_add desde cualquier hilo.
+} prueba_hash_t;
+
+// Trabajo de un hilo escritor o lector.
+typedef struct hilo_prueba {
+	prueba_hash_t* prueba;
+	size_t numero;
+	unsigned long long estado;
+	pthread_t hilo;
+} hilo_prueba_t;
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Generador xorshift64, uno por hilo para que no compartan estado.
+unsigned long long estres_hash_aleatorio(unsigned long long* estado) {
+	*estado ^= *estado << 13;
+	*estado ^= *estado >> 7;
+	*estado ^= *estado << 17;
+	return *estado;
+}
+
+// Registra un error encontrado por cualquier hilo.
+void estres_hash_error(prueba_hash_t* prueba) {
+	__atomic_fetch_add(&prueba->errores, 1, __ATOMIC_RELAXED);
+}
+
+/* Funcion de cada escritor: guarda o borra (mitad y mitad) claves al azar de su franja que
+ * no sean fijas. Cada borrado debe devolver el dato de la clave si, segun el modelo, estaba.
+ */
+void* ejecutar_escritor(void* extra) {
+	hilo_prueba_t* escritor = extra;
+	prueba_hash_t* prueba = escritor->prueba;
+	size_t por_escritor = prueba->cant_claves / prueba->escritores;
+	for (size_t i = 0; i < prueba->operaciones; i++) {
+		unsigned long long aleatorio = estres_hash_aleatorio(&escritor->estado);
+		size_t k = (size_t)(aleatorio % por_escritor) * prueba->escritores + escritor->numero;
+		if (k < prueba->fijas) continue;
+		if (aleatorio >> 63) {
+			if (!hash_concurrente_guardar(prueba->hash, prueba->claves[k], prueba->claves[k])) estres_hash_error(prueba);
+			else prueba->esta[k] = true;
+			continue;
+		}
+		void* dato = hash_concurrente_borrar(prueba->hash, prueba->claves[k]);
+		if ((dato != NULL) != prueba->esta[k] || (dato && dato != prueba->claves[k])) estres_hash_error(prueba);
+		prueba->esta[k] = false;
+	}
+	return NULL;
+}
+
+/* Funcion de cada lector: busca claves al azar sin lock hasta que terminan los escritores.
+ * Las fijas siempre tienen que estar, y ninguna clave puede devolver el dato de otra.
+ */
+void* ejecutar_lector(void* extra) {
+	hilo_prueba_t* lector = extra;
+	prueba_hash_t* prueba = lector->prueba;
+	while (!__atomic_load_n(&prueba->terminar, __ATOMIC_RELAXED)) {
+		size_t k = (size_t)(estres_hash_aleatorio(&lector->estado) % prueba->cant_claves);
+		void* dato = hash_concurrente_obtener(prueba->hash, prueba->claves[k]);
+		if (k < prueba->fijas && dato != prueba->claves[k]) estres_hash_error(prueba);
+		else if (dato && dato != prueba->claves[k]) estres_hash_error(prueba);
+	}
+	return NULL;
+}
+
+/* PRE: Recibe la prueba con el hash vacio y las claves.
+ * POST: Carga las claves fijas, lanza los hilos, espera a que terminen y compara el hash con
+ * el modelo. Devuelve false si no se pudieron lanzar los hilos.
+ */
+bool ejecutar_prueba_hash(prueba_hash_t* prueba, size_t lectores) {
+	for (size_t i = 0; i < prueba->fijas; i++) {
+		if (!hash_concurrente_guardar(prueba->hash, prueba->claves[i], prueba->claves[i])) return false;
+		prueba->esta[i] = true;
+	}
+	size_t cant_hilos = prueba->escritores + lectores;
+	hilo_prueba_t* hilos = calloc(cant_hilos, sizeof(hilo_prueba_t));
+	if (!hilos) return false;
+	bool ok = true;
+	size_t lanzados = 0;
+	for (; ok && lanzados < cant_hilos; lanzados++) {
+		hilo_prueba_t* hilo = &hilos[lanzados];
+		hilo->prueba = prueba;
+		hilo->numero = lanzados < prueba->escritores ? lanzados : lanzados - prueba->escritores;
+		hilo->estado = SEMILLA + lanzados * 2654435761ULL;
+		void* (*funcion)(void*) = lanzados < prueba->escritores ? ejecutar_escritor : ejecutar_lector;
+		ok = pthread_create(&hilo->hilo, NULL, funcion, hilo) == 0;
+		if (!ok) break;
+	}
+	// Los lectores siguen buscando hasta que terminan todos los escritores (o fallo un lanzamiento).
+	for (size_t i = 0; i < lanzados && i < prueba->escritores; i++) pthread_join(hilos[i].hilo, NULL);
+	__atomic_store_n(&prueba->terminar, 1, __ATOMIC_RELAXED);
+	for (size_t i = prueba->escritores; i < lanzados; i++) pthread_join(hilos[i].hilo, NULL);
+	free(hilos);
+	if (!ok) return false;
+
+	size_t cantidad = 0;
+	for (size_t i = 0; i < prueba->cant_claves; i++) {
+		if (prueba->esta[i]) cantidad++;
+		if (hash_concurrente_pertenece(prueba->hash, prueba->claves[i]) != prueba->esta[i]) prueba->errores++;
+	}
+	if (cantidad != hash_concurrente_cantidad(prueba->hash)) prueba->errores++;
+	printf("claves=%zu escritores=%zu lectores=%zu vigentes=%zu errores=%zu\n", prueba->cant_claves,
+		prueba->escritores, lectores, cantidad, prueba->errores);
+	return true;
+}
+
+
+/* *****************************************************************
+ *                    			MAIN
+ * *****************************************************************/
+
+/* Verifica hash_concurrente_t contra un modelo: varios escritores guardan y borran claves
+ * disjuntas mientras varios lectores buscan sin lock. Al final, el hash debe tener exactamente
+ * las claves del modelo. Devuelve 0 si no hubo errores. Pensado para correr tambien con
+ * -fsanitize=thread o -fsanitize=address.
+ * Uso: ./estres_hash_concurrente [claves] [operaciones por escritor] [escritores] [lectores]
+ */
+int main(int argc, char* argv[]) {
+	size_t cant_claves = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : CANT_CLAVES_DEFAULT;
+	size_t operaciones = argc > 2 ? (size_t)strtoul(argv[2], NULL, 10) : OPERACIONES_DEFAULT;
+	size_t escritores = argc > 3 ? (size_t)strtoul(argv[3], NULL, 10) : ESCRITORES_DEFAULT;
+	size_t lectores = argc > 4 ? (size_t)strtoul(argv[4], NULL, 10) : LECTORES_DEFAULT;
+	if (!escritores || cant_claves < escritores) {
+		fprintf(stderr, "Uso: %s [claves] [operaciones por escritor] [escritores] [lectores]\n", argv[0]);
+		return -1;
+	}
+	prueba_hash_t prueba = { hash_concurrente_crear(NULL), malloc(cant_claves * sizeof(char*)),
+		calloc(cant_claves, sizeof(bool)), cant_claves, cant_claves * FIJAS_POR_DIEZ / 10, escritores,
+		operaciones, 0, 0 };
+	size_t generadas = 0;
+	bool ok = prueba.hash && prueba.claves && prueba.esta;
+	for (; ok && generadas < cant_claves; generadas++) {
+		prueba.claves[generadas] = malloc(LARGO_MAX_CLAVE);
+		if (!prueba.claves[generadas]) break;
+		snprintf(prueba.claves[generadas], LARGO_MAX_CLAVE, "clave%zu", generadas);
+	}
+	ok = ok && generadas == cant_claves && ejecutar_prueba_hash(&prueba, lectores);
+	if (!ok) fprintf(stderr, "Error: no se pudo ejecutar la prueba\n");
+
+	if (prueba.hash) hash_concurrente_destruir(prueba.hash);
+	for (size_t i = 0; i < generadas; i++) free(prueba.claves[i]);
+	free(prueba.claves);
+	free(prueba.esta);
+	return ok && !prueba.errores ? 0 : -1;
+}
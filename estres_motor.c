@@ -0,0 +1,326 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "motor.h"
+#include "sesion.h"
+
+#define PARTICIONES_DEFAULT 4
+#define USUARIOS_DEFAULT 64
+#define CLIENTES_DEFAULT 4
+#define OPERACIONES_DEFAULT 20000
+#define LARGO_MAX_LINEA 64
+#define BITS_PALABRA 64
+#define SEMILLA 88172645463325252ULL
+
+// Porcentaje de cada operacion (el resto hasta 100 son likes).
+#define PORCENTAJE_PUBLICAR 20
+#define PORCENTAJE_VER 50
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Modelo de lo que deberia tener el motor. Cada usuario lo usa un unico cliente (el usuario
+ * con ID u es del cliente u % clientes), por lo que los posts vistos y publicados de un usuario
+ * los escribe un solo hilo. Los autores y los likes los escriben varios, con atomicos.
+ */
+typedef struct modelo_motor {
+	motor_t* motor;
+	size_t cant_usuarios;
+	size_t cant_clientes;
+	size_t max_posts;         // Cota de IDs de post: una publicacion por operacion como mucho.
+	size_t* autores;          // ID del posteador + 1 de cada post publicado, 0 si no existe.
+	size_t* publicados;       // Posts publicados por cada usuario.
+	uint64_t* vistos;         // Por usuario, un bit por post que vio en su feed.
+	uint64_t* likes;          // Por post, un bit por usuario que lo likeo.
+	size_t palabras_posts;    // Palabras de 64 bits por usuario en vistos.
+	size_t palabras_usuarios; // Palabras de 64 bits por post en likes.
+	size_t errores;           // Se incrementa con __atomic_fetch_add desde cualquier hilo.
+} modelo_motor_t;
+
+// Trabajo de un hilo cliente.
+typedef struct cliente_estres {
+	modelo_motor_t* modelo;
+	size_t numero;
+	size_t cant_operaciones;
+	unsigned long long estado;
+	pthread_t hilo;
+} cliente_estres_t;
+
+// Likes juntados por motor_ver_likes.
+typedef struct likes_vistos {
+	const modelo_motor_t* modelo;
+	size_t id_post;
+	size_t cantidad;
+	bool ok;
+} likes_vistos_t;
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Generador xorshift64, uno por cliente para que no compartan estado.
+unsigned long long estres_motor_aleatorio(unsigned long long* estado) {
+	*estado ^= *estado << 13;
+	*estado ^= *estado >> 7;
+	*estado ^= *estado << 17;
+	return *estado;
+}
+
+// Escribe el nombre del usuario con ese ID.
+void nombre_usuario_estres(char* nombre, size_t id) {
+	snprintf(nombre, LARGO_MAX_LINEA, "usuario%zu", id);
+}
+
+// Registra un error encontrado por cualquier hilo.
+void estres_motor_error(modelo_motor_t* modelo, const char* descripcion, size_t id) {
+	if (!__atomic_fetch_add(&modelo->errores, 1, __ATOMIC_RELAXED)) fprintf(stderr, "Error: %s (%zu)\n", descripcion, id);
+}
+
+// Devuelve el ID + 1 del posteador de un post ya publicado, o 0 si todavia no se sabe.
+size_t estres_motor_autor(const modelo_motor_t* modelo, size_t id_post) {
+	return id_post < modelo->max_posts ? __atomic_load_n(&modelo->autores[id_post], __ATOMIC_ACQUIRE) : 0;
+}
+
+// Devuelve true si, segun el modelo, el usuario likeo el post.
+bool estres_motor_likeo(const modelo_motor_t* modelo, size_t id_post, size_t id_usuario) {
+	uint64_t palabra = __atomic_load_n(&modelo->likes[id_post * modelo->palabras_usuarios + id_usuario / BITS_PALABRA], __ATOMIC_RELAXED);
+	return (palabra >> (id_usuario % BITS_PALABRA)) & 1;
+}
+
+/* PRE: Recibe el modelo, el usuario que vio un post, la vista y si ya terminaron los clientes.
+ * POST: Verifica que el post no sea del usuario, no lo haya visto antes y tenga el posteador
+ * y el texto con los que se publico. Lo marca como visto. Mientras hay clientes, el post puede
+ * llegar a un feed antes de que su publicacion vuelva y quede en el modelo.
+ */
+void verificar_vista(modelo_motor_t* modelo, size_t id_usuario, const vista_post_t* vista, bool terminado) {
+	char esperado[LARGO_MAX_LINEA];
+	size_t autor = estres_motor_autor(modelo, vista->id);
+	if (vista->id >= modelo->max_posts || ((autor || terminado) && autor != vista->id_posteador + 1)) {
+		estres_motor_error(modelo, "post visto con otro posteador o sin publicar", vista->id);
+		return;
+	}
+	if (vista->id_posteador == id_usuario) estres_motor_error(modelo, "post propio en el feed", vista->id);
+	nombre_usuario_estres(esperado, vista->id_posteador);
+	if (strcmp(vista->posteador, esperado)) estres_motor_error(modelo, "nombre del posteador", vista->id);
+	snprintf(esperado, sizeof(esperado), "post de %zu", vista->id_posteador);
+	if (strcmp(vista->texto, esperado)) estres_motor_error(modelo, "texto del post", vista->id);
+	uint64_t* palabra = &modelo->vistos[id_usuario * modelo->palabras_posts + vista->id / BITS_PALABRA];
+	uint64_t bit = 1ULL << (vista->id % BITS_PALABRA);
+	if (*palabra & bit) estres_motor_error(modelo, "post visto dos veces", vista->id);
+	*palabra |= bit;
+}
+
+/* PRE: Recibe un cliente.
+ * POST: Ejecuta sus operaciones con su propia sesion: cada una loggea a uno de sus usuarios,
+ * publica, ve el feed o likea un post al azar, y cierra la sesion. Verifica cada respuesta
+ * contra el modelo.
+ */
+void* ejecutar_cliente_estres(void* extra) {
+	cliente_estres_t* cliente = extra;
+	modelo_motor_t* modelo = cliente->modelo;
+	sesion_t* sesion = sesion_crear();
+	if (!sesion) {
+		estres_motor_error(modelo, "no se pudo crear la sesion", cliente->numero);
+		return NULL;
+	}
+	size_t propios = (modelo->cant_usuarios - cliente->numero + modelo->cant_clientes - 1) / modelo->cant_clientes;
+	char linea[LARGO_MAX_LINEA];
+	size_t conocidos = 0;  // Mayor ID de post + 1 que vio o publico el cliente.
+	for (size_t i = 0; i < cliente->cant_operaciones; i++) {
+		size_t id_usuario = cliente->numero + (size_t)(estres_motor_aleatorio(&cliente->estado) % propios) * modelo->cant_clientes;
+		unsigned long long tipo = estres_motor_aleatorio(&cliente->estado) % 100;
+		nombre_usuario_estres(linea, id_usuario);
+		if (motor_login(modelo->motor, sesion, linea) != PROTOCOLO_OK) {
+			estres_motor_error(modelo, "login", id_usuario);
+			continue;
+		}
+		if (tipo < PORCENTAJE_PUBLICAR) {
+			size_t id_post;
+			snprintf(linea, sizeof(linea), "post de %zu", id_usuario);
+			if (motor_publicar(modelo->motor, sesion, linea, &id_post) != PROTOCOLO_OK || id_post >= modelo->max_posts) {
+				estres_motor_error(modelo, "publicar", id_usuario);
+			} else {
+				__atomic_store_n(&modelo->autores[id_post], id_usuario + 1, __ATOMIC_RELEASE);
+				modelo->publicados[id_usuario]++;
+				if (id_post >= conocidos) conocidos = id_post + 1;
+			}
+		} else if (tipo < PORCENTAJE_PUBLICAR + PORCENTAJE_VER) {
+			vista_post_t vista;
+			protocolo_estado_t estado = motor_ver_siguiente(modelo->motor, sesion, &vista);
+			if (estado == PROTOCOLO_OK) {
+				verificar_vista(modelo, id_usuario, &vista, false);
+				if (vista.id >= conocidos) conocidos = vista.id + 1;
+			} else if (estado != PROTOCOLO_SIN_POSTS) {
+				estres_motor_error(modelo, "ver el feed", id_usuario);
+			}
+		} else if (conocidos) {
+			size_t id_post = (size_t)(estres_motor_aleatorio(&cliente->estado) % conocidos);
+			// Si el autor ya esta en el modelo, la publicacion termino y el like tiene que andar.
+			size_t autor = estres_motor_autor(modelo, id_post);
+			protocolo_estado_t estado = motor_likear(modelo->motor, sesion, id_post);
+			if (estado == PROTOCOLO_OK) {
+				uint64_t* palabra = &modelo->likes[id_post * modelo->palabras_usuarios + id_usuario / BITS_PALABRA];
+				__atomic_fetch_or(palabra, 1ULL << (id_usuario % BITS_PALABRA), __ATOMIC_RELAXED);
+			} else if (autor || estado != PROTOCOLO_POST_INEXISTENTE) {
+				estres_motor_error(modelo, "likear", id_post);
+			}
+		}
+		if (motor_logout(modelo->motor, sesion) != PROTOCOLO_OK) estres_motor_error(modelo, "logout", id_usuario);
+	}
+	sesion_destruir(sesion);
+	return NULL;
+}
+
+// Verifica cada like contra el modelo, como funcion visitar de motor_ver_likes.
+bool verificar_like(size_t id, const char* nombre, void* extra) {
+	likes_vistos_t* vistos = extra;
+	char esperado[LARGO_MAX_LINEA];
+	nombre_usuario_estres(esperado, id);
+	if (id >= vistos->modelo->cant_usuarios || strcmp(nombre, esperado) || !estres_motor_likeo(vistos->modelo, vistos->id_post, id)) {
+		vistos->ok = false;
+	}
+	vistos->cantidad++;
+	return true;
+}
+
+/* PRE: Recibe el modelo, con todos los clientes terminados.
+ * POST: Vacia el feed de cada usuario, verificando que los posts salgan en orden de afinidad
+ * y con los likes del modelo, que cada usuario haya visto todos los posts de los demas y que
+ * los likes de cada post sean los del modelo.
+ */
+void verificar_final(modelo_motor_t* modelo) {
+	sesion_t* sesion = sesion_crear();
+	if (!sesion) {
+		estres_motor_error(modelo, "no se pudo crear la sesion", 0);
+		return;
+	}
+	size_t total = 0;
+	for (size_t u = 0; u < modelo->cant_usuarios; u++) total += modelo->publicados[u];
+	char nombre[LARGO_MAX_LINEA];
+	for (size_t u = 0; u < modelo->cant_usuarios; u++) {
+		nombre_usuario_estres(nombre, u);
+		if (motor_login(modelo->motor, sesion, nombre) != PROTOCOLO_OK) {
+			estres_motor_error(modelo, "login", u);
+			continue;
+		}
+		size_t afinidad_anterior = 0, id_anterior = 0;
+		bool primero = true;
+		vista_post_t vista;
+		while (motor_ver_siguiente(modelo->motor, sesion, &vista) == PROTOCOLO_OK) {
+			verificar_vista(modelo, u, &vista, true);
+			size_t afinidad = u > vista.id_posteador ? u - vista.id_posteador : vista.id_posteador - u;
+			if (!primero && (afinidad < afinidad_anterior || (afinidad == afinidad_anterior && vista.id < id_anterior))) {
+				estres_motor_error(modelo, "orden del feed", vista.id);
+			}
+			size_t likes = 0;
+			for (size_t i = 0; i < modelo->cant_usuarios; i++) likes += estres_motor_likeo(modelo, vista.id, i);
+			if (likes != vista.likes) estres_motor_error(modelo, "likes en el feed", vista.id);
+			afinidad_anterior = afinidad;
+			id_anterior = vista.id;
+			primero = false;
+		}
+		motor_logout(modelo->motor, sesion);
+		size_t vistos = 0;
+		for (size_t i = 0; i < modelo->palabras_posts; i++) vistos += (size_t)__builtin_popcountll(modelo->vistos[u * modelo->palabras_posts + i]);
+		if (vistos != total - modelo->publicados[u]) estres_motor_error(modelo, "posts sin entregar", u);
+	}
+	sesion_destruir(sesion);
+
+	for (size_t id_post = 0; id_post < modelo->max_posts; id_post++) {
+		if (!estres_motor_autor(modelo, id_post)) continue;
+		likes_vistos_t vistos = { modelo, id_post, 0, true };
+		size_t esperados = 0;
+		for (size_t i = 0; i < modelo->cant_usuarios; i++) esperados += estres_motor_likeo(modelo, id_post, i);
+		protocolo_estado_t estado = motor_ver_likes(modelo->motor, id_post, verificar_like, &vistos);
+		if (estado != (esperados ? PROTOCOLO_OK : PROTOCOLO_SIN_LIKES) || !vistos.ok || vistos.cantidad != esperados) {
+			estres_motor_error(modelo, "likes del post", id_post);
+		}
+	}
+}
+
+/* PRE: Recibe el modelo con el motor iniciado, la cantidad de operaciones por cliente.
+ * POST: Lanza los clientes, espera a que terminen y verifica el estado final. Devuelve false
+ * si no se pudieron lanzar.
+ */
+bool ejecutar_prueba_motor(modelo_motor_t* modelo, size_t cant_operaciones) {
+	cliente_estres_t* clientes = calloc(modelo->cant_clientes, sizeof(cliente_estres_t));
+	if (!clientes) return false;
+	bool ok = true;
+	size_t lanzados = 0;
+	for (; ok && lanzados < modelo->cant_clientes; lanzados++) {
+		cliente_estres_t* cliente = &clientes[lanzados];
+		cliente->modelo = modelo;
+		cliente->numero = lanzados;
+		cliente->cant_operaciones = cant_operaciones;
+		cliente->estado = SEMILLA + lanzados * 2654435761ULL;
+		ok = pthread_create(&cliente->hilo, NULL, ejecutar_cliente_estres, cliente) == 0;
+		if (!ok) break;
+	}
+	for (size_t i = 0; i < lanzados; i++) pthread_join(clientes[i].hilo, NULL);
+	free(clientes);
+	if (ok) verificar_final(modelo);
+	return ok;
+}
+
+
+/* *****************************************************************
+ *                    			MAIN
+ * *****************************************************************/
+
+/* Verifica el motor concurrente (ver motor.h) contra un modelo: varios clientes publican, ven
+ * sus feeds y likean a la vez, y cada respuesta se compara con lo que ya se sabe. Al final se
+ * vacian todos los feeds y se comparan los likes de cada post. Devuelve 0 si no hubo errores.
+ * Pensado para correr tambien con -fsanitize=thread o -fsanitize=address.
+ * Uso: ./estres_motor [particiones] [usuarios] [clientes] [operaciones por cliente]
+ */
+int main(int argc, char* argv[]) {
+	size_t cant_particiones = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : PARTICIONES_DEFAULT;
+	size_t cant_usuarios = argc > 2 ? (size_t)strtoul(argv[2], NULL, 10) : USUARIOS_DEFAULT;
+	size_t cant_clientes = argc > 3 ? (size_t)strtoul(argv[3], NULL, 10) : CLIENTES_DEFAULT;
+	size_t cant_operaciones = argc > 4 ? (size_t)strtoul(argv[4], NULL, 10) : OPERACIONES_DEFAULT;
+	if (!cant_particiones || !cant_clientes || cant_usuarios < cant_clientes) {
+		fprintf(stderr, "Uso: %s [particiones] [usuarios] [clientes] [operaciones por cliente]\n", argv[0]);
+		return -1;
+	}
+	modelo_motor_t modelo;
+	modelo.motor = motor_crear(cant_particiones);
+	modelo.cant_usuarios = cant_usuarios;
+	modelo.cant_clientes = cant_clientes;
+	modelo.max_posts = cant_clientes * cant_operaciones;
+	modelo.palabras_posts = modelo.max_posts / BITS_PALABRA + 1;
+	modelo.palabras_usuarios = cant_usuarios / BITS_PALABRA + 1;
+	modelo.autores = calloc(modelo.max_posts, sizeof(size_t));
+	modelo.publicados = calloc(cant_usuarios, sizeof(size_t));
+	modelo.vistos = calloc(cant_usuarios * modelo.palabras_posts, sizeof(uint64_t));
+	modelo.likes = calloc(modelo.max_posts * modelo.palabras_usuarios, sizeof(uint64_t));
+	modelo.errores = 0;
+	bool ok = modelo.motor && modelo.autores && modelo.publicados && modelo.vistos && modelo.likes;
+	char nombre[LARGO_MAX_LINEA];
+	for (size_t i = 0; ok && i < cant_usuarios; i++) {
+		nombre_usuario_estres(nombre, i);
+		ok = motor_agregar_usuario(modelo.motor, nombre);
+	}
+	ok = ok && motor_iniciar(modelo.motor) && ejecutar_prueba_motor(&modelo, cant_operaciones);
+	if (!ok) fprintf(stderr, "Error: no se pudo ejecutar la prueba\n");
+	else {
+		size_t total = 0;
+		for (size_t u = 0; u < cant_usuarios; u++) total += modelo.publicados[u];
+		printf("particiones=%zu usuarios=%zu clientes=%zu posts=%zu errores=%zu\n", cant_particiones, cant_usuarios,
+			cant_clientes, total, modelo.errores);
+	}
+
+	if (modelo.motor) motor_destruir(modelo.motor);
+	free(modelo.autores);
+	free(modelo.publicados);
+	free(modelo.vistos);
+	free(modelo.likes);
+	return ok && !modelo.errores ? 0 : -1;
+}
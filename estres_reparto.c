@@ -0,0 +1,197 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "reparto.h"
+#include "usuario.h"
+#include "post.h"
+
+#define USUARIOS_DEFAULT (2 * REPARTO_MINIMO_USUARIOS)
+#define POSTS_DEFAULT 2000
+#define HILOS_DEFAULT 4
+#define LARGO_MAX_NOMBRE 32
+#define SEMILLA 88172645463325252ULL
+
+// Probabilidad (1 en N por post) de leer un feed a mitad del reparto y de reemplazar un usuario.
+#define UNO_EN_LECTURA 4
+#define UNO_EN_REEMPLAZO 64
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Cada usuario existe dos veces: uno recibe los posts del repartidor y el otro, de referencia,
+ * los recibe en el mismo hilo, encolando uno por uno como en el reparto secuencial. Los feeds
+ * de los dos tienen que dar siempre los mismos posts en el mismo orden.
+ */
+typedef struct prueba_reparto {
+	repartidor_t* repartidor;
+	usuario_t** paralelos;
+	usuario_t** secuenciales;
+	char* nombres;
+	post_t** posts;
+	size_t cant_usuarios;
+	size_t cant_posts;
+	unsigned long long estado;
+	size_t errores;
+} prueba_reparto_t;
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Generador xorshift64.
+unsigned long long estres_reparto_aleatorio(unsigned long long* estado) {
+	*estado ^= *estado << 13;
+	*estado ^= *estado >> 7;
+	*estado ^= *estado << 17;
+	return *estado;
+}
+
+/* PRE: Recibe la prueba y el ID de un usuario sin reparto en curso.
+ * POST: Crea el usuario (de nuevo, si ya existia) en las dos versiones y lo registra en el
+ * repartidor. Devuelve false si no hay memoria.
+ */
+bool crear_usuario_reparto(prueba_reparto_t* prueba, size_t id) {
+	const char* nombre = prueba->nombres + id * LARGO_MAX_NOMBRE;
+	usuario_t* paralelo = usuario_crear(nombre, id);
+	usuario_t* secuencial = usuario_crear(nombre, id);
+	if (!paralelo || !secuencial || !repartidor_agregar_usuario(prueba->repartidor, paralelo)) {
+		if (paralelo) usuario_destruir(paralelo);
+		if (secuencial) usuario_destruir(secuencial);
+		return false;
+	}
+	if (prueba->paralelos[id]) usuario_destruir(prueba->paralelos[id]);
+	if (prueba->secuenciales[id]) usuario_destruir(prueba->secuenciales[id]);
+	prueba->paralelos[id] = paralelo;
+	prueba->secuenciales[id] = secuencial;
+	return true;
+}
+
+/* PRE: Recibe la prueba, sin reparto en curso, el ID de un usuario y donde guardar si quedaban posts.
+ * POST: Saca el siguiente post de las dos versiones del usuario y devuelve true si son el mismo.
+ */
+bool comparar_siguiente_post(prueba_reparto_t* prueba, size_t id, bool* quedan) {
+	post_t* paralelo = usuario_ver_post(prueba->paralelos[id]);
+	post_t* secuencial = usuario_ver_post(prueba->secuenciales[id]);
+	*quedan = paralelo || secuencial;
+	if (paralelo == secuencial) return true;
+	if (!prueba->errores) fprintf(stderr, "Error: el feed del usuario %zu difiere del secuencial\n", id);
+	return false;
+}
+
+/* PRE: Recibe la prueba con los usuarios creados.
+ * POST: Publica cada post con el repartidor y de forma secuencial, leyendo feeds y
+ * reemplazando usuarios al azar en el medio, y al final vacia y compara todos los feeds.
+ * Devuelve false si no hay memoria.
+ */
+bool ejecutar_prueba_reparto(prueba_reparto_t* prueba) {
+	for (size_t id_post = 0; id_post < prueba->cant_posts; id_post++) {
+		size_t id_posteador = (size_t)(estres_reparto_aleatorio(&prueba->estado) % prueba->cant_usuarios);
+		char* texto = malloc(LARGO_MAX_NOMBRE);
+		if (!texto) return false;
+		snprintf(texto, LARGO_MAX_NOMBRE, "post %zu", id_post);
+		post_t* post = post_crear(prueba->nombres + id_posteador * LARGO_MAX_NOMBRE, id_posteador, texto, id_post);
+		if (!post) {
+			free(texto);
+			return false;
+		}
+		prueba->posts[id_post] = post;
+		repartidor_publicar(prueba->repartidor, post);
+		// En modo relajado, el reparto sigue en los otros hilos mientras se arma la referencia.
+		for (size_t id = 0; id < prueba->cant_usuarios; id++) {
+			if (id == id_posteador) continue;
+			size_t afinidad = id > id_posteador ? id - id_posteador : id_posteador - id;
+			if (!usuario_guardar_feed(prueba->secuenciales[id], post, afinidad)) return false;
+		}
+		unsigned long long aleatorio = estres_reparto_aleatorio(&prueba->estado);
+		size_t id = (size_t)(aleatorio >> 16) % prueba->cant_usuarios;
+		bool quedan;
+		if (aleatorio % UNO_EN_LECTURA == 0) {
+			repartidor_esperar(prueba->repartidor);
+			if (!comparar_siguiente_post(prueba, id, &quedan)) prueba->errores++;
+		} else if (aleatorio % UNO_EN_REEMPLAZO == 1) {
+			repartidor_esperar(prueba->repartidor);
+			repartidor_quitar_usuario(prueba->repartidor, id);
+			if (!crear_usuario_reparto(prueba, id)) return false;
+		}
+	}
+	repartidor_esperar(prueba->repartidor);
+	for (size_t id = 0; id < prueba->cant_usuarios; id++) {
+		bool quedan = true;
+		while (quedan) {
+			if (!comparar_siguiente_post(prueba, id, &quedan)) {
+				prueba->errores++;
+				break;
+			}
+		}
+	}
+	return true;
+}
+
+/* PRE: Recibe la cantidad de usuarios, de posts y de hilos, y si el reparto es relajado.
+ * POST: Ejecuta una prueba completa y escribe una linea con el resultado. Devuelve la cantidad
+ * de errores, o -1 si no se pudo ejecutar.
+ */
+long probar_reparto(size_t cant_usuarios, size_t cant_posts, size_t cant_hilos, bool relajado) {
+	prueba_reparto_t prueba = { repartidor_crear(cant_hilos, relajado), calloc(cant_usuarios, sizeof(usuario_t*)),
+		calloc(cant_usuarios, sizeof(usuario_t*)), malloc(cant_usuarios * LARGO_MAX_NOMBRE),
+		calloc(cant_posts, sizeof(post_t*)), cant_usuarios, cant_posts, SEMILLA, 0 };
+	bool ok = prueba.repartidor && prueba.paralelos && prueba.secuenciales && prueba.nombres && prueba.posts;
+	for (size_t id = 0; ok && id < cant_usuarios; id++) {
+		snprintf(prueba.nombres + id * LARGO_MAX_NOMBRE, LARGO_MAX_NOMBRE, "usuario%zu", id);
+		ok = crear_usuario_reparto(&prueba, id);
+	}
+	ok = ok && ejecutar_prueba_reparto(&prueba);
+	if (ok) {
+		printf("usuarios=%zu posts=%zu hilos=%zu relajado=%d errores=%zu\n", cant_usuarios, cant_posts, cant_hilos,
+			relajado, prueba.errores);
+	}
+
+	// El repartidor se destruye primero: puede estar usando los usuarios y los posts.
+	if (prueba.repartidor) repartidor_destruir(prueba.repartidor);
+	for (size_t id = 0; id < cant_usuarios; id++) {
+		if (prueba.paralelos && prueba.paralelos[id]) usuario_destruir(prueba.paralelos[id]);
+		if (prueba.secuenciales && prueba.secuenciales[id]) usuario_destruir(prueba.secuenciales[id]);
+	}
+	for (size_t id = 0; prueba.posts && id < cant_posts; id++) {
+		if (prueba.posts[id]) post_destruir(prueba.posts[id]);
+	}
+	free(prueba.paralelos);
+	free(prueba.secuenciales);
+	free(prueba.nombres);
+	free(prueba.posts);
+	return ok ? (long)prueba.errores : -1;
+}
+
+
+/* *****************************************************************
+ *                    			MAIN
+ * *****************************************************************/
+
+/* Verifica el reparto en paralelo (ver reparto.h), sincronico y relajado, contra el reparto
+ * secuencial: publica posts de usuarios al azar, lee feeds y reemplaza usuarios en el medio, y
+ * al final todos los feeds tienen que dar los mismos posts en el mismo orden. Con menos de
+ * REPARTO_MINIMO_USUARIOS usuarios el reparto no usa los hilos. Devuelve 0 si no hubo errores.
+ * Pensado para correr tambien con -fsanitize=thread o -fsanitize=address.
+ * Uso: ./estres_reparto [usuarios] [posts] [hilos]
+ */
+int main(int argc, char* argv[]) {
+	size_t cant_usuarios = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : USUARIOS_DEFAULT;
+	size_t cant_posts = argc > 2 ? (size_t)strtoul(argv[2], NULL, 10) : POSTS_DEFAULT;
+	size_t cant_hilos = argc > 3 ? (size_t)strtoul(argv[3], NULL, 10) : HILOS_DEFAULT;
+	if (!cant_usuarios || !cant_hilos) {
+		fprintf(stderr, "Uso: %s [usuarios] [posts] [hilos]\n", argv[0]);
+		return -1;
+	}
+	long errores = probar_reparto(cant_usuarios, cant_posts, cant_hilos, false);
+	long errores_relajado = errores == -1 ? -1 : probar_reparto(cant_usuarios, cant_posts, cant_hilos, true);
+	if (errores == -1 || errores_relajado == -1) {
+		fprintf(stderr, "Error: no se pudo ejecutar la prueba\n");
+		return -1;
+	}
+	return errores || errores_relajado ? -1 : 0;
+}
@@ -0,0 +1,116 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "feed.h"
+
+#define TAM_INICIAL 8
+#define FACTOR_REDIMENSION 2
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+typedef struct registro {
+	post_t** posts;
+	size_t cant;
+	size_t tam;
+} registro_t;
+
+struct feed {
+	registro_t* autores;
+	size_t cant_autores;
+	size_t* autor_publicacion;
+	size_t cant_posts;
+	size_t tam_posts;
+};
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+/* PRE: Recibe un tamaño actual, la cantidad minima requerida y el tamaño de cada elemento.
+ * POST: Devuelve el arreglo redimensionado al primer tamaño suficiente (duplicando),
+ * actualizando tam. Devuelve NULL si no se pudo redimensionar.
+ */
+void* redimensionar_arreglo(void* arreglo, size_t* tam, size_t requerido, size_t tam_elem) {
+	size_t tam_nuevo = *tam ? *tam : TAM_INICIAL;
+	while (tam_nuevo < requerido) tam_nuevo *= FACTOR_REDIMENSION;
+	void* nuevo = realloc(arreglo, tam_nuevo * tam_elem);
+	if (!nuevo) return NULL;
+	*tam = tam_nuevo;
+	return nuevo;
+}
+
+/* PRE: Recibe un feed y el ID de un autor.
+ * POST: Devuelve true si el arreglo de autores tiene lugar para ese ID, agrandandolo si hace falta.
+ */
+bool feed_asegurar_autor(feed_t* feed, size_t id_autor) {
+	if (id_autor < feed->cant_autores) return true;
+	size_t cant_nueva = feed->cant_autores;
+	registro_t* autores = redimensionar_arreglo(feed->autores, &cant_nueva, id_autor + 1, sizeof(registro_t));
+	if (!autores) return false;
+	memset(autores + feed->cant_autores, 0, (cant_nueva - feed->cant_autores) * sizeof(registro_t));
+	feed->autores = autores;
+	feed->cant_autores = cant_nueva;
+	return true;
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL FEED
+ * *****************************************************************/
+
+feed_t* feed_crear(void) {
+	feed_t* feed = calloc(1, sizeof(feed_t));
+	if (!feed) return NULL;
+	return feed;
+}
+
+bool feed_publicar(feed_t* feed, post_t* post, size_t id_autor) {
+	if (!feed_asegurar_autor(feed, id_autor)) return false;
+	if (feed->cant_posts == feed->tam_posts) {
+		size_t* autor_publicacion = redimensionar_arreglo(feed->autor_publicacion, &feed->tam_posts, feed->cant_posts + 1, sizeof(size_t));
+		if (!autor_publicacion) return false;
+		feed->autor_publicacion = autor_publicacion;
+	}
+	registro_t* registro = &feed->autores[id_autor];
+	if (registro->cant == registro->tam) {
+		post_t** posts = redimensionar_arreglo(registro->posts, &registro->tam, registro->cant + 1, sizeof(post_t*));
+		if (!posts) return false;
+		registro->posts = posts;
+	}
+	registro->posts[registro->cant++] = post;
+	feed->autor_publicacion[feed->cant_posts++] = id_autor;
+	return true;
+}
+
+size_t feed_cantidad_posts(const feed_t* feed) {
+	return feed->cant_posts;
+}
+
+size_t feed_autor_publicacion(const feed_t* feed, size_t pos) {
+	return feed->autor_publicacion[pos];
+}
+
+size_t feed_cantidad_autores(const feed_t* feed) {
+	return feed->cant_autores;
+}
+
+size_t feed_cantidad_posts_autor(const feed_t* feed, size_t id_autor) {
+	return id_autor < feed->cant_autores ? feed->autores[id_autor].cant : 0;
+}
+
+post_t* feed_post_autor(const feed_t* feed, size_t id_autor, size_t n) {
+	return feed->autores[id_autor].posts[n];
+}
+
+void feed_destruir(feed_t* feed) {
+	for (size_t i = 0; i < feed->cant_autores; i++) {
+		free(feed->autores[i].posts);
+	}
+	free(feed->autores);
+	free(feed->autor_publicacion);
+	free(feed);
+}
@@ -0,0 +1,67 @@
+#ifndef FEED_H
+#define FEED_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "post.h"
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Registro global de publicaciones. Cada post se guarda una unica vez en el
+ * registro de su autor, y los feeds de los usuarios se calculan al momento de
+ * leerlos (ver usuario_ver_post_desde). El registro no es dueño de los posts.
+ */
+typedef struct feed feed_t;
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL FEED
+ * *****************************************************************/
+
+// Crea un registro de publicaciones vacio.
+feed_t* feed_crear(void);
+
+/* PRE: Recibe un feed previamente creado, un post y el ID de su autor.
+ * POST: Devuelve true si se pudo agregar el post al registro del autor, en caso
+ * contrario false. Es O(1) amortizado, independiente de la cantidad de usuarios.
+ */
+bool feed_publicar(feed_t* feed, post_t* post, size_t id_autor);
+
+/* PRE: Recibe un feed previamente creado.
+ * POST: Devuelve la cantidad total de posts publicados.
+ */
+size_t feed_cantidad_posts(const feed_t* feed);
+
+/* PRE: Recibe un feed previamente creado y un numero de publicacion menor a la
+ * cantidad de posts publicados.
+ * POST: Devuelve el ID del autor de la publicacion numero pos (en orden de publicacion).
+ */
+size_t feed_autor_publicacion(const feed_t* feed, size_t pos);
+
+/* PRE: Recibe un feed previamente creado.
+ * POST: Devuelve una cota para los IDs de autores: todo autor que haya publicado
+ * tiene un ID menor al valor devuelto.
+ */
+size_t feed_cantidad_autores(const feed_t* feed);
+
+/* PRE: Recibe un feed previamente creado y el ID de un autor.
+ * POST: Devuelve la cantidad de posts publicados por ese autor.
+ */
+size_t feed_cantidad_posts_autor(const feed_t* feed, size_t id_autor);
+
+/* PRE: Recibe un feed previamente creado, el ID de un autor y un numero n menor a
+ * la cantidad de posts de ese autor.
+ * POST: Devuelve el n-esimo post del autor, en orden de publicacion.
+ */
+post_t* feed_post_autor(const feed_t* feed, size_t id_autor, size_t n);
+
+/* PRE: Recibe un feed previamente creado.
+ * POST: Se destruyo el feed (no destruye los posts).
+ */
+void feed_destruir(feed_t* feed);
+
+#endif  // FEED_H
@@ -1,5 +1,7 @@
 #define _POSIX_C_SOURCE 200809L
 #include "hash.h"
+#include "estadisticas.h"
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -8,7 +10,9 @@
 #define FACTOR_CARGA_MIN 0.1
 #define FACTOR_AGRANDAMIENTO 2
 #define FACTOR_ACHICAMIENTO 3
-#define ERROR -1
+#define CELDAS_POR_MIGRACION 16
+#define POS_INVALIDA SIZE_MAX
+#define CLAVE_TERMINADA SIZE_MAX  // Largo de una clave que termina en '\0'.
 
 /* ******************************************************************
  *                DEFINICION DE LOS TIPOS DE DATOS
@@ -19,6 +23,7 @@ typedef enum { VACIO, OCUPADO, BORRADO } estado_t;
 typedef struct celda {
 	char* clave;
 	void* dato;
+	uint32_t hash;  // Valor de hashing(clave), para no recalcularlo ni comparar claves de mas.
 	estado_t estado;
 } celda_t;
 
@@ -28,6 +33,12 @@ struct hash {
 	size_t capacidad;
 	celda_t* tabla;
 	void (*func_dest)(void*);
+	bool incremental;
+	bool copiar_claves;     // Si es false, las claves son del usuario del hash y no se copian ni liberan.
+	celda_t* tabla_vieja;   // Tabla que se esta migrando de a partes, o NULL si no hay migracion en curso.
+	size_t capacidad_vieja;
+	size_t cantidad_vieja;  // Celdas ocupadas que quedan en la tabla vieja (incluidas en cantidad).
+	size_t pos_migracion;   // Las celdas de la tabla vieja anteriores a esta posicion ya se migraron.
 };
 
 struct hash_iter {
@@ -40,19 +51,50 @@ struct hash_iter {
  *                    FUNCIONES AUXILIARES
  * *****************************************************************/
 
-// RS Hash de Robert Sedgewick.
-// https://www.programmingalgorithms.com/algorithm/rs-hash/c/
-unsigned long hashing(const char* str) {
-	unsigned long length = (unsigned long)strlen(str);
-	unsigned long b = 378551;
-	unsigned long a = 63689;
-	unsigned long hash = 0;
-	unsigned long i = 0;
-	for (i = 0; i < length; str++, i++) {
-		hash = hash * a + (*str);
-		a = a * b;
+/* Mezcla final de MurmurHash3 (fmix64): distribuye cada bit de entrada en todos
+ * los de salida, para que el modulo por la capacidad no dependa solo de los bits bajos.
+ */
+uint64_t hashing_mezclar(uint64_t h) {
+	h ^= h >> 33;
+	h *= 0xff51afd7ed558ccdULL;
+	h ^= h >> 33;
+	h *= 0xc4ceb9fe1a85ec53ULL;
+	h ^= h >> 33;
+	return h;
+}
+
+/* Funcion de hashing que mezcla la clave de a palabras de 8 bytes (en lugar de a un
+ * byte como el RS Hash que se usaba antes): junta los bytes de cada palabra y hace una
+ * sola multiplicacion por palabra, y al final aplica la mezcla de MurmurHash3. Recorre
+ * la clave una unica vez, sin strlen y sin leer mas alla del '\0' ni de los largo_max
+ * bytes (una clave de largo_max bytes da lo mismo que si terminara en '\0').
+ */
+uint32_t hashing_acotado(const char* str, size_t largo_max) {
+	const unsigned char* actual = (const unsigned char*)str;
+	uint64_t hash = 0x9e3779b97f4a7c15ULL;
+	while (true) {
+		uint64_t palabra = 0;
+		size_t largo = 0;
+		for (; largo < sizeof(uint64_t) && largo < largo_max && actual[largo]; largo++) {
+			palabra |= (uint64_t)actual[largo] << (8 * largo);
+		}
+		hash = (hash ^ palabra ^ largo) * 0x100000001b3ULL;
+		if (largo < sizeof(uint64_t)) break;
+		hash ^= hash >> 29;
+		actual += sizeof(uint64_t);
+		largo_max -= sizeof(uint64_t);
 	}
-	return hash;
+	return (uint32_t)hashing_mezclar(hash);
+}
+
+uint32_t hashing(const char* str) {
+	return hashing_acotado(str, CLAVE_TERMINADA);
+}
+
+// Compara una clave guardada con una clave de largo dado (CLAVE_TERMINADA si termina en '\0').
+bool hash_claves_iguales(const char* guardada, const char* clave, size_t largo) {
+	if (largo == CLAVE_TERMINADA) return strcmp(guardada, clave) == 0;
+	return strncmp(guardada, clave, largo) == 0 && guardada[largo] == '\0';
 }
 
 /* PRE: Recibe la capacidad de la tabla.
@@ -64,22 +106,34 @@ celda_t* hash_crear_tabla(size_t capacidad) {
 	return tabla;
 }
 
-/* PRE: Recibe un dato, una clave y una funcion de destruir dato o NULL.
+/* PRE: Recibe el hash y una clave guardada en el.
+ * POST: Libera la clave, salvo que el hash use claves externas.
+ */
+void hash_liberar_clave(const hash_t* hash, char* clave) {
+	if (hash->copiar_claves) free(clave);
+}
+
+/* PRE: Recibe el hash y una celda ocupada.
  * POST: Destruye una celda.
  */
-void hash_celda_destruir(void* dato, char* clave, hash_destruir_dato_t destruir_dato) {
-	free(clave);
-	if (destruir_dato != NULL) destruir_dato(dato);
+void hash_celda_destruir(const hash_t* hash, celda_t* celda) {
+	hash_liberar_clave(hash, celda->clave);
+	if (hash->func_dest != NULL) hash->func_dest(celda->dato);
 }
 
-/* PRE: Recibe el hash, una clave, un dato y una posicion donde se quiere guardar.
- * POST: Guarda el dato en la celda y aumenta la cantidad del hash.
+/* PRE: Recibe el hash, una clave, su valor de hashing, un dato y una posicion donde se quiere guardar.
+ * POST: Guarda el dato en la celda y aumenta la cantidad del hash. Devuelve false si no se
+ * pudo copiar la clave.
  */
-void hash_celda_guardar_dato(hash_t* hash, const char* clave, void* dato, size_t pos) {
+bool hash_celda_guardar_dato(hash_t* hash, const char* clave, uint32_t valor_hash, void* dato, size_t pos) {
+	char* copia = hash->copiar_claves ? strdup(clave) : (char*)clave;
+	if (!copia) return false;
 	hash->tabla[pos].estado = OCUPADO;
 	hash->tabla[pos].dato = dato;
-	hash->tabla[pos].clave = strdup(clave);
+	hash->tabla[pos].clave = copia;
+	hash->tabla[pos].hash = valor_hash;
 	hash->cantidad++;
+	return true;
 }
 
 /* PRE: Recibe el hash y una posicion donde se quiere borrar.
@@ -89,50 +143,142 @@ void hash_celda_guardar_dato(hash_t* hash, const char* clave, void* dato, size_t
 void* hash_celda_borrar_dato(hash_t* hash, size_t pos) {
 	void* dato = hash->tabla[pos].dato;
 	hash->tabla[pos].estado = BORRADO;
-	free(hash->tabla[pos].clave);
+	hash_liberar_clave(hash, hash->tabla[pos].clave);
 	hash->cantidad_borrados++;
 	hash->cantidad--;
 	return dato;
 }
 
+/* PRE: Recibe una tabla, su capacidad y una celda ocupada cuya clave no esta en la tabla.
+ * POST: Copia la celda en la primera posicion vacia a partir de la que le corresponde por su hash.
+ */
+void tabla_ubicar_celda(celda_t* tabla, size_t capacidad, const celda_t* celda) {
+	size_t pos = celda->hash % capacidad;
+	while (tabla[pos].estado != VACIO) {
+		pos = pos == capacidad - 1 ? 0 : pos + 1;
+	}
+	tabla[pos] = *celda;
+}
+
+/* PRE: Recibe el hash.
+ * POST: Devuelve el factor de carga de la tabla actual (sin contar la tabla vieja en migracion).
+ */
+double hash_factor_carga(const hash_t* hash) {
+	return (double)(hash->cantidad - hash->cantidad_vieja + hash->cantidad_borrados) / (double)hash->capacidad;
+}
+
+/* PRE: El hash fue creado.
+ * POST: Migra a la tabla actual las celdas ocupadas de las proximas cant_celdas posiciones
+ * de la tabla vieja, si hay una migracion en curso. Las celdas migradas quedan como BORRADO
+ * en la tabla vieja para no cortar las secuencias de sondeo de las que faltan migrar.
+ * Cuando termina de recorrerla, libera la tabla vieja.
+ */
+void hash_migrar(hash_t* hash, size_t cant_celdas) {
+	if (!hash->tabla_vieja) return;
+	size_t fin = hash->capacidad_vieja - hash->pos_migracion > cant_celdas ? hash->pos_migracion + cant_celdas : hash->capacidad_vieja;
+	for (; hash->pos_migracion < fin; hash->pos_migracion++) {
+		celda_t* celda = &hash->tabla_vieja[hash->pos_migracion];
+		if (celda->estado != OCUPADO) continue;
+		tabla_ubicar_celda(hash->tabla, hash->capacidad, celda);
+		celda->estado = BORRADO;
+		hash->cantidad_vieja--;
+	}
+	if (hash->pos_migracion == hash->capacidad_vieja) {
+		free(hash->tabla_vieja);
+		hash->tabla_vieja = NULL;
+		hash->capacidad_vieja = 0;
+		hash->pos_migracion = 0;
+	}
+}
+
 /* PRE: El hash fue creado.
- * POST: Devuelve FALSE si no se pudo redimensionar, en otro caso TRUE.
+ * POST: Devuelve FALSE si no se pudo redimensionar, en otro caso TRUE. Las celdas se mueven
+ * a la tabla nueva con su clave y su valor de hashing ya calculados, sin copiarlas ni compararlas.
+ * En modo incremental solo se crea la tabla nueva, y las celdas se van moviendo de a
+ * CELDAS_POR_MIGRACION en cada guardado o borrado (ver hash_migrar). Si todavia habia una
+ * migracion en curso, primero se termina.
  */
 bool hash_redimensionar(hash_t* hash, size_t capacidad_nueva) {
+	hash_migrar(hash, hash->capacidad_vieja);
 	celda_t* tabla_nueva = hash_crear_tabla(capacidad_nueva);
 	if (!tabla_nueva) return false;
-
-	celda_t* tabla_vieja = hash->tabla;
-	size_t capacidad_vieja = hash->capacidad;
-
+	ESTADISTICA(estadisticas.redimensiones_hash++);
+
+	if (hash->incremental) {
+		hash->tabla_vieja = hash->tabla;
+		hash->capacidad_vieja = hash->capacidad;
+		hash->cantidad_vieja = hash->cantidad;
+		hash->pos_migracion = 0;
+	} else {
+		for (size_t i = 0; i < hash->capacidad; i++) {
+			if (hash->tabla[i].estado == OCUPADO) tabla_ubicar_celda(tabla_nueva, capacidad_nueva, &hash->tabla[i]);
+		}
+		free(hash->tabla);
+	}
 	hash->tabla = tabla_nueva;
-	hash->cantidad = 0;
 	hash->cantidad_borrados = 0;
 	hash->capacidad = capacidad_nueva;
-
-	for (size_t i = 0; i < capacidad_vieja; i++) {
-		if (tabla_vieja[i].estado == OCUPADO) {
-			if (!hash_guardar(hash,tabla_vieja[i].clave, tabla_vieja[i].dato)) return false;
-			free(tabla_vieja[i].clave);
-		}
-	}
-	free(tabla_vieja);
 	return true;
 }
 
-/* PRE: Recibe una clave y un hash.
- * POST: Devuelve la posicion de la clave si se encontro en el hash, si no se 
- * encontro devuelve -1 (ERROR). Con el parametro buscar_vacio se puede indicar
- * a la funcion que busque una posicion vacia.
+/* PRE: Recibe una tabla, su capacidad, una clave, su largo (o CLAVE_TERMINADA) y su valor de hashing.
+ * POST: Devuelve la posicion de la clave si se encontro en la tabla, si no se 
+ * encontro devuelve POS_INVALIDA. Con el parametro buscar_vacio se puede indicar
+ * a la funcion que busque una posicion vacia. Solo se comparan byte a byte las
+ * claves cuyo valor de hashing coincide.
  */
-size_t hash_buscar(const hash_t* hash, const char* clave, bool buscar_vacio) {
-	size_t pos = hashing(clave) % hash->capacidad;
-	while (hash->tabla[pos].estado != VACIO) {
-		if (hash->tabla[pos].estado == OCUPADO && strcmp(hash->tabla[pos].clave, clave) == 0) return pos;
-		if (pos == hash->capacidad - 1) pos = 0;
+size_t tabla_buscar(const celda_t* tabla, size_t capacidad, const char* clave, size_t largo, uint32_t valor_hash, bool buscar_vacio) {
+	size_t pos = valor_hash % capacidad;
+	ESTADISTICA(size_t sondeos = 0);
+	while (tabla[pos].estado != VACIO) {
+		const celda_t* celda = &tabla[pos];
+		ESTADISTICA(sondeos++);
+		if (celda->estado == OCUPADO && celda->hash == valor_hash && (celda->clave == clave || hash_claves_iguales(celda->clave, clave, largo))) {
+			ESTADISTICA(histograma_agregar(&estadisticas.sondeos_hash, sondeos));
+			return pos;
+		}
+		if (pos == capacidad - 1) pos = 0;
 		else pos++;
 	}
-	return buscar_vacio ? pos : ERROR;
+	ESTADISTICA(histograma_agregar(&estadisticas.sondeos_hash, sondeos));
+	return buscar_vacio ? pos : POS_INVALIDA;
+}
+
+/* PRE: Recibe una clave, su valor de hashing y un hash.
+ * POST: Igual que tabla_buscar, sobre la tabla actual del hash.
+ */
+size_t hash_buscar(const hash_t* hash, const char* clave, uint32_t valor_hash, bool buscar_vacio) {
+	return tabla_buscar(hash->tabla, hash->capacidad, clave, CLAVE_TERMINADA, valor_hash, buscar_vacio);
+}
+
+/* PRE: Recibe una clave, su largo (o CLAVE_TERMINADA) y un hash.
+ * POST: Devuelve la celda ocupada con esa clave, buscando en la tabla actual y, si hay una
+ * migracion en curso, en la tabla vieja. Devuelve NULL si la clave no esta.
+ */
+celda_t* hash_buscar_celda(const hash_t* hash, const char* clave, size_t largo) {
+	uint32_t valor_hash = hashing_acotado(clave, largo);
+	size_t pos = tabla_buscar(hash->tabla, hash->capacidad, clave, largo, valor_hash, false);
+	if (pos != POS_INVALIDA) return &hash->tabla[pos];
+	if (!hash->tabla_vieja) return NULL;
+	pos = tabla_buscar(hash->tabla_vieja, hash->capacidad_vieja, clave, largo, valor_hash, false);
+	return pos == POS_INVALIDA ? NULL : &hash->tabla_vieja[pos];
+}
+
+/* PRE: Recibe un iterador.
+ * POST: Devuelve la celda en la posicion del iterador. Las posiciones recorren primero la
+ * tabla actual y despues la tabla vieja, si hay una migracion en curso.
+ */
+const celda_t* hash_iter_celda(const hash_iter_t* iter) {
+	const hash_t* hash = iter->hash;
+	if (iter->pos < hash->capacidad) return &hash->tabla[iter->pos];
+	return &hash->tabla_vieja[iter->pos - hash->capacidad];
+}
+
+/* PRE: Recibe un hash.
+ * POST: Devuelve la cantidad de posiciones que recorre el iterador.
+ */
+size_t hash_iter_posiciones(const hash_t* hash) {
+	return hash->capacidad + (hash->tabla_vieja ? hash->capacidad_vieja : 0);
 }
 
 /* PRE: Recibe un iterador.
@@ -140,8 +286,8 @@ size_t hash_buscar(const hash_t* hash, const char* clave, bool buscar_vacio) {
  */
 bool posicion_valida(hash_iter_t* iter) {
 	if (hash_cantidad(iter->hash) == 0) return true;
-	while (iter->pos < iter->hash->capacidad) {
-		if (iter->hash->tabla[iter->pos].estado == OCUPADO) return true;
+	while (iter->pos < hash_iter_posiciones(iter->hash)) {
+		if (hash_iter_celda(iter)->estado == OCUPADO) return true;
 		iter->pos++;
 	}
 	return false;
@@ -153,6 +299,14 @@ bool posicion_valida(hash_iter_t* iter) {
  * *****************************************************************/
 
 hash_t *hash_crear(hash_destruir_dato_t destruir_dato) {
+	return hash_crear_con_opciones(destruir_dato, 0);
+}
+
+hash_t *hash_crear_incremental(hash_destruir_dato_t destruir_dato) {
+	return hash_crear_con_opciones(destruir_dato, HASH_INCREMENTAL);
+}
+
+hash_t *hash_crear_con_opciones(hash_destruir_dato_t destruir_dato, int opciones) {
 	hash_t* hash = malloc(sizeof(hash_t));
 	if (!hash) return NULL;
 
@@ -160,6 +314,12 @@ hash_t *hash_crear(hash_destruir_dato_t destruir_dato) {
 	hash->capacidad = CAPACIDAD_INICIAL;
 	hash->cantidad_borrados = 0;
 	hash->func_dest = destruir_dato;
+	hash->incremental = opciones & HASH_INCREMENTAL;
+	hash->copiar_claves = !(opciones & HASH_CLAVES_EXTERNAS);
+	hash->tabla_vieja = NULL;
+	hash->capacidad_vieja = 0;
+	hash->cantidad_vieja = 0;
+	hash->pos_migracion = 0;
 	
 	hash->tabla = hash_crear_tabla(hash->capacidad);
 	if (!hash->tabla) return NULL;
@@ -168,49 +328,96 @@ hash_t *hash_crear(hash_destruir_dato_t destruir_dato) {
 }
 
 bool hash_guardar(hash_t *hash, const char *clave, void *dato) {
-	if ((double)(hash->cantidad + hash->cantidad_borrados) / (double)hash->capacidad >= FACTOR_CARGA_MAX) {
+	hash_migrar(hash, CELDAS_POR_MIGRACION);
+	if (hash_factor_carga(hash) >= FACTOR_CARGA_MAX) {
 		if (!hash_redimensionar(hash, hash->capacidad * FACTOR_AGRANDAMIENTO)) return false;
 	}
-	size_t pos = hash_buscar(hash, clave, true);
+	uint32_t valor_hash = hashing(clave);
+	if (hash->tabla_vieja) {
+		size_t pos_vieja = tabla_buscar(hash->tabla_vieja, hash->capacidad_vieja, clave, CLAVE_TERMINADA, valor_hash, false);
+		if (pos_vieja != POS_INVALIDA) {
+			if (hash->func_dest) hash->func_dest(hash->tabla_vieja[pos_vieja].dato);
+			hash->tabla_vieja[pos_vieja].dato = dato;
+			return true;
+		}
+	}
+	size_t pos = hash_buscar(hash, clave, valor_hash, true);
 	if (hash->tabla[pos].estado == OCUPADO) {
 		if (hash->func_dest) hash->func_dest(hash->tabla[pos].dato);
 		hash->tabla[pos].dato = dato;
 		return true;
 	}
-	hash_celda_guardar_dato(hash, clave, dato, pos);
+	return hash_celda_guardar_dato(hash, clave, valor_hash, dato, pos);
+}
+
+bool hash_reservar(hash_t *hash, size_t cantidad) {
+	size_t capacidad_nueva = (size_t)((double)cantidad / FACTOR_CARGA_MAX) + 1;
+	if (capacidad_nueva <= hash->capacidad) return true;
+	if (!hash_redimensionar(hash, capacidad_nueva)) return false;
+	// La reserva se pide antes de una carga masiva: no tiene sentido dejar la migracion a medias.
+	hash_migrar(hash, hash->capacidad_vieja);
 	return true;
 }
 
 void *hash_borrar(hash_t *hash, const char *clave) {
-	size_t pos = hash_buscar(hash, clave, false);
-	if (pos == ERROR) return NULL;
+	hash_migrar(hash, CELDAS_POR_MIGRACION);
+	uint32_t valor_hash = hashing(clave);
+	size_t pos = hash_buscar(hash, clave, valor_hash, false);
+	if (pos == POS_INVALIDA) {
+		if (!hash->tabla_vieja) return NULL;
+		pos = tabla_buscar(hash->tabla_vieja, hash->capacidad_vieja, clave, CLAVE_TERMINADA, valor_hash, false);
+		if (pos == POS_INVALIDA) return NULL;
+		celda_t* celda = &hash->tabla_vieja[pos];
+		celda->estado = BORRADO;
+		hash_liberar_clave(hash, celda->clave);
+		hash->cantidad_vieja--;
+		hash->cantidad--;
+		return celda->dato;
+	}
 	void* dato = hash_celda_borrar_dato(hash, pos);
 	
-	if ((double)(hash->cantidad + hash->cantidad_borrados) / (double)hash->capacidad <= FACTOR_CARGA_MIN) {
+	if (!hash->tabla_vieja && hash_factor_carga(hash) <= FACTOR_CARGA_MIN) {
 		if (!hash_redimensionar(hash, hash->capacidad / FACTOR_ACHICAMIENTO)) return false;
 	}
 	return dato;
 }
 
 void *hash_obtener(const hash_t *hash, const char *clave) {
-	size_t pos = hash_buscar(hash, clave, false);
-	return pos == ERROR ? NULL : hash->tabla[pos].dato;
+	return hash_obtener_largo(hash, clave, CLAVE_TERMINADA);
+}
+
+void *hash_obtener_largo(const hash_t *hash, const char *clave, size_t largo) {
+	celda_t* celda = hash_buscar_celda(hash, clave, largo);
+	return celda ? celda->dato : NULL;
 }
 
 bool hash_pertenece(const hash_t *hash, const char *clave) {
-	return hash_buscar(hash, clave, false) == ERROR ? false : true;
+	return hash_buscar_celda(hash, clave, CLAVE_TERMINADA) != NULL;
 }
 
 size_t hash_cantidad(const hash_t *hash) {
 	return hash->cantidad;
 }
 
+#ifdef ESTADISTICAS
+void hash_ver_ocupacion(const hash_t *hash, size_t *capacidad, size_t *borrados) {
+	*capacidad = hash->capacidad;
+	*borrados = hash->cantidad_borrados;
+}
+#endif
+
 void hash_destruir(hash_t *hash) {
 	for (size_t i = 0; i < hash->capacidad; i++) {
 		if (hash->tabla[i].estado == OCUPADO) {
-			hash_celda_destruir(hash->tabla[i].dato, hash->tabla[i].clave, hash->func_dest);
+			hash_celda_destruir(hash, &hash->tabla[i]);
+		}
+	}
+	for (size_t i = 0; hash->tabla_vieja && i < hash->capacidad_vieja; i++) {
+		if (hash->tabla_vieja[i].estado == OCUPADO) {
+			hash_celda_destruir(hash, &hash->tabla_vieja[i]);
 		}
 	}
+	free(hash->tabla_vieja);
 	free(hash->tabla);
 	free(hash);
 }
@@ -235,11 +442,11 @@ bool hash_iter_avanzar(hash_iter_t *iter) {
 }
 
 const char *hash_iter_ver_actual(const hash_iter_t *iter) {
-	return hash_iter_al_final(iter) ? NULL : iter->hash->tabla[iter->pos].clave;
+	return hash_iter_al_final(iter) ? NULL : hash_iter_celda(iter)->clave;
 }
 	
 bool hash_iter_al_final(const hash_iter_t *iter) {
-	return iter->pos >= iter->hash->capacidad || hash_cantidad(iter->hash) == 0; 
+	return iter->pos >= hash_iter_posiciones(iter->hash) || hash_cantidad(iter->hash) == 0; 
 }
 void hash_iter_destruir(hash_iter_t *iter) {
 	free(iter);
@@ -3,6 +3,7 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 // Los structs deben llamarse "hash" y "hash_iter".
 struct hash;
@@ -14,10 +15,31 @@ typedef struct hash_iter hash_iter_t;
 // tipo de función para destruir dato
 typedef void (*hash_destruir_dato_t)(void *);
 
+/* Funcion de hashing de las claves (la usa tambien hash_concurrente).
+ */
+uint32_t hashing(const char *str);
+
 /* Crea el hash
  */
 hash_t *hash_crear(hash_destruir_dato_t destruir_dato);
 
+/* Crea el hash en modo de redimension incremental: al superar el factor de
+ * carga, la tabla nueva convive con la vieja y cada guardado o borrado migra
+ * una cantidad acotada de celdas, en lugar de rehashear toda la tabla de una
+ * vez. Las busquedas no modifican el hash y consultan ambas tablas, por lo que
+ * se pueden hacer mientras se lo recorre con el iterador.
+ */
+hash_t *hash_crear_incremental(hash_destruir_dato_t destruir_dato);
+
+// Opciones de hash_crear_con_opciones, que se pueden combinar con |.
+#define HASH_INCREMENTAL 1      // Redimension incremental, como en hash_crear_incremental.
+#define HASH_CLAVES_EXTERNAS 2  // Las claves no se copian ni se liberan: quien guarda una clave
+                                // debe mantenerla valida (y sin modificar) mientras este en el hash.
+
+/* Crea el hash con las opciones indicadas (0 equivale a hash_crear).
+ */
+hash_t *hash_crear_con_opciones(hash_destruir_dato_t destruir_dato, int opciones);
+
 /* Guarda un elemento en el hash, si la clave ya se encuentra en la
  * estructura, la reemplaza. De no poder guardarlo devuelve false.
  * Pre: La estructura hash fue inicializada
@@ -25,6 +47,14 @@ hash_t *hash_crear(hash_destruir_dato_t destruir_dato);
  */
 bool hash_guardar(hash_t *hash, const char *clave, void *dato);
 
+/* Agranda la tabla para que entren cantidad elementos en total sin que el hash
+ * se tenga que redimensionar al guardarlos. Si ya entraban, no hace nada. De no
+ * poder agrandarla devuelve false.
+ * Pre: La estructura hash fue inicializada
+ * Post: Se pueden guardar elementos hasta llegar a cantidad sin redimensionar.
+ */
+bool hash_reservar(hash_t *hash, size_t cantidad);
+
 /* Borra un elemento del hash y devuelve el dato asociado.  Devuelve
  * NULL si el dato no estaba.
  * Pre: La estructura hash fue inicializada
@@ -39,6 +69,12 @@ void *hash_borrar(hash_t *hash, const char *clave);
  */
 void *hash_obtener(const hash_t *hash, const char *clave);
 
+/* Igual que hash_obtener, para una clave de largo bytes que no necesita terminar
+ * en '\0' (por ejemplo, una linea de un archivo mapeado en memoria).
+ * Pre: La estructura hash fue inicializada
+ */
+void *hash_obtener_largo(const hash_t *hash, const char *clave, size_t largo);
+
 /* Determina si clave pertenece o no al hash.
  * Pre: La estructura hash fue inicializada
  */
@@ -49,6 +85,14 @@ bool hash_pertenece(const hash_t *hash, const char *clave);
  */
 size_t hash_cantidad(const hash_t *hash);
 
+#ifdef ESTADISTICAS
+/* Guarda en capacidad la cantidad de celdas de la tabla actual y en borrados la cantidad
+ * de celdas borradas que todavia ocupan lugar en ella.
+ * Pre: La estructura hash fue inicializada
+ */
+void hash_ver_ocupacion(const hash_t *hash, size_t *capacidad, size_t *borrados);
+#endif
+
 /* Destruye la estructura liberando la memoria pedida y llamando a la función
  * destruir para cada par (clave, dato).
  * Pre: La estructura hash fue inicializada
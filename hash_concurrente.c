@@ -0,0 +1,461 @@
+#define _POSIX_C_SOURCE 200809L
+#include "hash_concurrente.h"
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CAPACIDAD_INICIAL_FRANJA 8  // Las capacidades son potencias de 2.
+#define FACTOR_CARGA_MAX 0.65
+#define FACTOR_AGRANDAMIENTO 2
+#define BITS_FRANJA 6               // log2(HASH_CONCURRENTE_FRANJAS)
+#define TAM_LINEA_CACHE 64
+#define RETIRADOS_MIN 4096          // Bytes retirados de una franja a partir de los cuales se liberan.
+
+#if (1 << BITS_FRANJA) != HASH_CONCURRENTE_FRANJAS
+#error "BITS_FRANJA tiene que ser el logaritmo en base 2 de HASH_CONCURRENTE_FRANJAS"
+#endif
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+// Copia de una clave. Cuando se borra pasa a la lista de claves retiradas de su franja.
+typedef struct clave_concurrente {
+	struct clave_concurrente* siguiente;
+	char texto[];
+} clave_concurrente_t;
+
+// Los campos se leen sin lock desde las busquedas, por lo que se escriben con __atomic_store_n.
+typedef struct celda_concurrente {
+	clave_concurrente_t* clave;  // NULL si la celda esta vacia, o CLAVE_BORRADA.
+	void* dato;
+	uint32_t hash;
+} celda_concurrente_t;
+
+typedef struct tabla_concurrente {
+	struct tabla_concurrente* anterior;  // En la lista de tablas retiradas, la siguiente.
+	size_t capacidad;
+	celda_concurrente_t celdas[];
+} tabla_concurrente_t;
+
+typedef struct franja {
+	unsigned secuencia;             // Impar mientras una escritura modifica la franja.
+	tabla_concurrente_t* tabla;
+	size_t cantidad;
+	size_t borrados;
+	clave_concurrente_t* claves_retiradas;  // Sacadas de la tabla, pero alguna busqueda puede seguir leyendolas.
+	tabla_concurrente_t* tablas_retiradas;
+	size_t bytes_retirados;
+	pthread_mutex_t mutex;          // Lo toman las escrituras; las busquedas no.
+} franja_t;
+
+// Cada franja ocupa sus propias lineas de cache, para que las escrituras en una no invaliden las vecinas.
+typedef union franja_alineada {
+	franja_t franja;
+	char relleno[(sizeof(franja_t) / TAM_LINEA_CACHE + 1) * TAM_LINEA_CACHE];
+} franja_alineada_t;
+
+/* Cantidad de busquedas en curso de los hilos que usan este lector, separadas por la paridad
+ * de la epoca en la que empezaron (ver esperar_lectores).
+ */
+typedef union lector_alineado {
+	size_t activos[2];
+	char relleno[TAM_LINEA_CACHE];
+} lector_alineado_t;
+
+struct hash_concurrente {
+	franja_alineada_t franjas[HASH_CONCURRENTE_FRANJAS];
+	lector_alineado_t lectores[HASH_CONCURRENTE_LECTORES];
+	size_t epoca;
+	pthread_mutex_t mutex_reclamo;  // Una sola espera de lectores a la vez. Se toma con el de una franja.
+	hash_destruir_dato_t func_dest;
+};
+
+// Numero de lector de cada hilo (empezando en 1; 0 si todavia no tiene), comun a todos los hashes.
+static __thread size_t lector_del_hilo;
+static size_t lectores_asignados;
+
+// Marca de las celdas borradas, para no cortar las secuencias de sondeo que pasan por ellas.
+static clave_concurrente_t clave_borrada;
+#define CLAVE_BORRADA (&clave_borrada)
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Devuelve los bytes que ocupa una tabla de la capacidad recibida.
+size_t tabla_concurrente_bytes(size_t capacidad) {
+	return sizeof(tabla_concurrente_t) + capacidad * sizeof(celda_concurrente_t);
+}
+
+/* PRE: Recibe una capacidad (potencia de 2).
+ * POST: Devuelve una tabla vacia o NULL si no se pudo crear.
+ */
+tabla_concurrente_t* tabla_concurrente_crear(size_t capacidad) {
+	tabla_concurrente_t* tabla = calloc(1, tabla_concurrente_bytes(capacidad));
+	if (!tabla) return NULL;
+	tabla->capacidad = capacidad;
+	return tabla;
+}
+
+// Devuelve la posicion donde empieza el sondeo de un valor de hashing.
+size_t tabla_concurrente_inicio(const tabla_concurrente_t* tabla, uint32_t valor_hash) {
+	return (valor_hash >> BITS_FRANJA) & (tabla->capacidad - 1);
+}
+
+// Devuelve la franja que le corresponde a un valor de hashing.
+franja_t* franja_de(const hash_concurrente_t* hash, uint32_t valor_hash) {
+	return (franja_t*)&hash->franjas[valor_hash & (HASH_CONCURRENTE_FRANJAS - 1)].franja;
+}
+
+/* PRE: Recibe la franja (con su lock tomado) que se va a modificar.
+ * POST: La secuencia quedo impar: las busquedas que pasen por la franja van a reintentar.
+ */
+void franja_comenzar_escritura(franja_t* franja) {
+	__atomic_store_n(&franja->secuencia, franja->secuencia + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+// Termina la escritura comenzada, dejando la secuencia par.
+void franja_terminar_escritura(franja_t* franja) {
+	__atomic_store_n(&franja->secuencia, franja->secuencia + 1, __ATOMIC_RELEASE);
+}
+
+/* PRE: Recibe un hash.
+ * POST: Anota una busqueda en curso en el lector del hilo, con la paridad de la epoca actual,
+ * y devuelve el contador a descontar en terminar_lectura. Desde aca hasta terminar_lectura,
+ * nada de lo que la busqueda vea en las franjas se libera.
+ */
+size_t* comenzar_lectura(hash_concurrente_t* hash) {
+	if (!lector_del_hilo) lector_del_hilo = __atomic_add_fetch(&lectores_asignados, 1, __ATOMIC_RELAXED);
+	lector_alineado_t* lector = &hash->lectores[(lector_del_hilo - 1) % HASH_CONCURRENTE_LECTORES];
+	size_t* activos = &lector->activos[__atomic_load_n(&hash->epoca, __ATOMIC_ACQUIRE) & 1];
+	__atomic_fetch_add(activos, 1, __ATOMIC_SEQ_CST);
+	// Si esperar_lectores no vio este contador, esta busqueda ya ve las tablas y claves nuevas.
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+	return activos;
+}
+
+// Termina la busqueda comenzada con comenzar_lectura.
+void terminar_lectura(size_t* activos) {
+	__atomic_fetch_sub(activos, 1, __ATOMIC_RELEASE);
+}
+
+/* PRE: Recibe un hash con el lock de reclamo tomado, despues de sacar de las franjas lo que se
+ * quiere liberar.
+ * POST: Ninguna busqueda que pudiera haberlo visto sigue en curso. Cambia de epoca y espera a
+ * que terminen las busquedas de la epoca anterior, dos veces: una busqueda anotada en la otra
+ * paridad puede haber empezado antes del cambio anterior.
+ */
+void esperar_lectores(hash_concurrente_t* hash) {
+	for (size_t fase = 0; fase < 2; fase++) {
+		size_t epoca = hash->epoca;
+		__atomic_store_n(&hash->epoca, epoca + 1, __ATOMIC_SEQ_CST);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+		for (size_t i = 0; i < HASH_CONCURRENTE_LECTORES; i++) {
+			while (__atomic_load_n(&hash->lectores[i].activos[epoca & 1], __ATOMIC_ACQUIRE)) sched_yield();
+		}
+	}
+}
+
+// Libera una lista de claves retiradas.
+void liberar_claves_retiradas(clave_concurrente_t* clave) {
+	while (clave) {
+		clave_concurrente_t* siguiente = clave->siguiente;
+		free(clave);
+		clave = siguiente;
+	}
+}
+
+// Libera una lista de tablas retiradas.
+void liberar_tablas_retiradas(tabla_concurrente_t* tabla) {
+	while (tabla) {
+		tabla_concurrente_t* anterior = tabla->anterior;
+		free(tabla);
+		tabla = anterior;
+	}
+}
+
+/* PRE: Recibe el hash y una franja con su lock tomado, a la que se le acaba de retirar algo.
+ * POST: Si lo retirado ocupa mas que la tabla actual (y al menos RETIRADOS_MIN), espera a las
+ * busquedas en curso y lo libera: lo retenido por una franja queda acotado por su tamaño.
+ */
+void franja_reclamar(hash_concurrente_t* hash, franja_t* franja) {
+	size_t limite = tabla_concurrente_bytes(franja->tabla->capacidad);
+	if (franja->bytes_retirados < limite || franja->bytes_retirados < RETIRADOS_MIN) return;
+	pthread_mutex_lock(&hash->mutex_reclamo);
+	esperar_lectores(hash);
+	pthread_mutex_unlock(&hash->mutex_reclamo);
+	liberar_claves_retiradas(franja->claves_retiradas);
+	liberar_tablas_retiradas(franja->tablas_retiradas);
+	franja->claves_retiradas = NULL;
+	franja->tablas_retiradas = NULL;
+	franja->bytes_retirados = 0;
+}
+
+/* PRE: Recibe una franja, una clave y su valor de hashing. Se puede llamar sin el lock.
+ * POST: Devuelve true si la clave esta en la franja, guardando su dato en dato. La tabla se
+ * recorre sin lock y, si la secuencia cambio mientras tanto, se vuelve a recorrer.
+ */
+bool franja_buscar(const franja_t* franja, const char* clave, uint32_t valor_hash, void** dato) {
+	while (true) {
+		unsigned secuencia = __atomic_load_n(&franja->secuencia, __ATOMIC_ACQUIRE);
+		if (secuencia & 1) {
+			// Las escrituras duran unos pocos stores, salvo que el hilo que escribe pierda el procesador.
+			sched_yield();
+			continue;
+		}
+		const tabla_concurrente_t* tabla = __atomic_load_n(&franja->tabla, __ATOMIC_ACQUIRE);
+		size_t mascara = tabla->capacidad - 1;
+		size_t pos = tabla_concurrente_inicio(tabla, valor_hash);
+		bool encontrada = false;
+		void* encontrado = NULL;
+		// Con la tabla a medio modificar podria no haber una celda vacia: el sondeo se acota.
+		for (size_t sondeos = 0; sondeos <= mascara; sondeos++) {
+			const celda_concurrente_t* celda = &tabla->celdas[pos];
+			const clave_concurrente_t* actual = __atomic_load_n(&celda->clave, __ATOMIC_ACQUIRE);
+			if (!actual) break;
+			if (actual != CLAVE_BORRADA && __atomic_load_n(&celda->hash, __ATOMIC_RELAXED) == valor_hash && strcmp(actual->texto, clave) == 0) {
+				encontrado = __atomic_load_n(&celda->dato, __ATOMIC_RELAXED);
+				encontrada = true;
+				break;
+			}
+			pos = (pos + 1) & mascara;
+		}
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&franja->secuencia, __ATOMIC_RELAXED) == secuencia) {
+			*dato = encontrado;
+			return encontrada;
+		}
+	}
+}
+
+/* PRE: Recibe una franja con su lock tomado, una clave y su valor de hashing.
+ * POST: Devuelve la posicion de la clave en la tabla de la franja y guarda true en encontrada.
+ * Si no esta, guarda false y devuelve la posicion donde guardarla (la primera borrada del
+ * sondeo, o la vacia donde termina).
+ */
+size_t franja_ubicar(const franja_t* franja, const char* clave, uint32_t valor_hash, bool* encontrada) {
+	const tabla_concurrente_t* tabla = franja->tabla;
+	size_t mascara = tabla->capacidad - 1;
+	size_t pos = tabla_concurrente_inicio(tabla, valor_hash);
+	size_t libre = SIZE_MAX;
+	while (tabla->celdas[pos].clave) {
+		const celda_concurrente_t* celda = &tabla->celdas[pos];
+		if (celda->clave == CLAVE_BORRADA) {
+			if (libre == SIZE_MAX) libre = pos;
+		} else if (celda->hash == valor_hash && strcmp(celda->clave->texto, clave) == 0) {
+			*encontrada = true;
+			return pos;
+		}
+		pos = (pos + 1) & mascara;
+	}
+	*encontrada = false;
+	return libre == SIZE_MAX ? pos : libre;
+}
+
+/* PRE: Recibe una franja con su lock tomado y una capacidad (potencia de 2) donde entran sus
+ * elementos.
+ * POST: Devuelve false si no se pudo redimensionar. Si no, la franja paso a una tabla nueva,
+ * sin celdas borradas. La tabla nueva se llena antes de publicarla, mientras las busquedas
+ * siguen usando la anterior (que no cambia), por lo que solo esperan a que se cambie el puntero.
+ * La anterior queda retirada (ver franja_reclamar).
+ */
+bool franja_redimensionar(franja_t* franja, size_t capacidad_nueva) {
+	tabla_concurrente_t* vieja = franja->tabla;
+	tabla_concurrente_t* nueva = tabla_concurrente_crear(capacidad_nueva);
+	if (!nueva) return false;
+	for (size_t i = 0; i < vieja->capacidad; i++) {
+		const celda_concurrente_t* celda = &vieja->celdas[i];
+		if (!celda->clave || celda->clave == CLAVE_BORRADA) continue;
+		size_t pos = tabla_concurrente_inicio(nueva, celda->hash);
+		while (nueva->celdas[pos].clave) pos = (pos + 1) & (capacidad_nueva - 1);
+		nueva->celdas[pos] = *celda;
+	}
+	franja_comenzar_escritura(franja);
+	__atomic_store_n(&franja->tabla, nueva, __ATOMIC_RELEASE);
+	franja_terminar_escritura(franja);
+	franja->borrados = 0;
+	vieja->anterior = franja->tablas_retiradas;
+	franja->tablas_retiradas = vieja;
+	franja->bytes_retirados += tabla_concurrente_bytes(vieja->capacidad);
+	return true;
+}
+
+// Devuelve la menor capacidad (potencia de 2) en la que entran cantidad elementos con la mitad del factor de carga maximo.
+size_t franja_capacidad_para(size_t cantidad) {
+	size_t capacidad = CAPACIDAD_INICIAL_FRANJA;
+	while ((double)cantidad > FACTOR_CARGA_MAX * (double)capacidad / FACTOR_AGRANDAMIENTO) capacidad *= FACTOR_AGRANDAMIENTO;
+	return capacidad;
+}
+
+/* PRE: Recibe el hash, una franja con su lock tomado, una clave, su valor de hashing y un dato.
+ * POST: Devuelve true si se guardo el par (clave, dato) en la franja.
+ */
+bool franja_guardar(hash_concurrente_t* hash, franja_t* franja, const char* clave, uint32_t valor_hash, void* dato) {
+	// Las celdas borradas tambien alargan los sondeos: si ocupan demasiado, se limpian.
+	if ((double)(franja->cantidad + franja->borrados + 1) > FACTOR_CARGA_MAX * (double)franja->tabla->capacidad) {
+		if (!franja_redimensionar(franja, franja_capacidad_para(franja->cantidad + 1))) return false;
+		franja_reclamar(hash, franja);
+	}
+	bool encontrada;
+	size_t pos = franja_ubicar(franja, clave, valor_hash, &encontrada);
+	celda_concurrente_t* celda = &franja->tabla->celdas[pos];
+	if (encontrada) {
+		void* anterior = celda->dato;
+		franja_comenzar_escritura(franja);
+		__atomic_store_n(&celda->dato, dato, __ATOMIC_RELAXED);
+		franja_terminar_escritura(franja);
+		if (hash->func_dest) hash->func_dest(anterior);
+		return true;
+	}
+	size_t largo = strlen(clave) + 1;
+	clave_concurrente_t* copia = malloc(sizeof(clave_concurrente_t) + largo);
+	if (!copia) return false;
+	memcpy(copia->texto, clave, largo);
+	if (celda->clave == CLAVE_BORRADA) franja->borrados--;
+	franja_comenzar_escritura(franja);
+	__atomic_store_n(&celda->hash, valor_hash, __ATOMIC_RELAXED);
+	__atomic_store_n(&celda->dato, dato, __ATOMIC_RELAXED);
+	__atomic_store_n(&celda->clave, copia, __ATOMIC_RELEASE);
+	franja_terminar_escritura(franja);
+	__atomic_store_n(&franja->cantidad, franja->cantidad + 1, __ATOMIC_RELAXED);
+	return true;
+}
+
+/* PRE: Recibe una franja sin usar por ningun otro hilo y la funcion para destruir los datos.
+ * POST: Libera sus claves (las vigentes y las retiradas), sus tablas (la actual y las
+ * retiradas) y su lock.
+ */
+void franja_destruir(franja_t* franja, hash_destruir_dato_t destruir_dato) {
+	tabla_concurrente_t* tabla = franja->tabla;
+	for (size_t i = 0; i < tabla->capacidad; i++) {
+		celda_concurrente_t* celda = &tabla->celdas[i];
+		if (!celda->clave || celda->clave == CLAVE_BORRADA) continue;
+		free(celda->clave);
+		if (destruir_dato) destruir_dato(celda->dato);
+	}
+	free(tabla);
+	liberar_tablas_retiradas(franja->tablas_retiradas);
+	liberar_claves_retiradas(franja->claves_retiradas);
+	pthread_mutex_destroy(&franja->mutex);
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL HASH CONCURRENTE
+ * *****************************************************************/
+
+hash_concurrente_t *hash_concurrente_crear(hash_destruir_dato_t destruir_dato) {
+	void* memoria;
+	if (posix_memalign(&memoria, TAM_LINEA_CACHE, sizeof(hash_concurrente_t)) != 0) return NULL;
+	hash_concurrente_t* hash = memoria;
+	hash->func_dest = destruir_dato;
+	hash->epoca = 0;
+	memset(hash->lectores, 0, sizeof(hash->lectores));
+	if (pthread_mutex_init(&hash->mutex_reclamo, NULL) != 0) {
+		free(hash);
+		return NULL;
+	}
+	for (size_t i = 0; i < HASH_CONCURRENTE_FRANJAS; i++) {
+		franja_t* franja = &hash->franjas[i].franja;
+		franja->secuencia = 0;
+		franja->cantidad = 0;
+		franja->borrados = 0;
+		franja->claves_retiradas = NULL;
+		franja->tablas_retiradas = NULL;
+		franja->bytes_retirados = 0;
+		franja->tabla = tabla_concurrente_crear(CAPACIDAD_INICIAL_FRANJA);
+		if (franja->tabla && pthread_mutex_init(&franja->mutex, NULL) == 0) continue;
+		free(franja->tabla);
+		for (size_t j = 0; j < i; j++) franja_destruir(&hash->franjas[j].franja, NULL);
+		pthread_mutex_destroy(&hash->mutex_reclamo);
+		free(hash);
+		return NULL;
+	}
+	return hash;
+}
+
+bool hash_concurrente_guardar(hash_concurrente_t *hash, const char *clave, void *dato) {
+	uint32_t valor_hash = hashing(clave);
+	franja_t* franja = franja_de(hash, valor_hash);
+	pthread_mutex_lock(&franja->mutex);
+	bool ok = franja_guardar(hash, franja, clave, valor_hash, dato);
+	pthread_mutex_unlock(&franja->mutex);
+	return ok;
+}
+
+bool hash_concurrente_reservar(hash_concurrente_t *hash, size_t cantidad) {
+	size_t capacidad = franja_capacidad_para(cantidad / HASH_CONCURRENTE_FRANJAS + 1);
+	bool ok = true;
+	for (size_t i = 0; ok && i < HASH_CONCURRENTE_FRANJAS; i++) {
+		franja_t* franja = &hash->franjas[i].franja;
+		pthread_mutex_lock(&franja->mutex);
+		if (capacidad > franja->tabla->capacidad) ok = franja_redimensionar(franja, capacidad);
+		if (ok) franja_reclamar(hash, franja);
+		pthread_mutex_unlock(&franja->mutex);
+	}
+	return ok;
+}
+
+void *hash_concurrente_borrar(hash_concurrente_t *hash, const char *clave) {
+	uint32_t valor_hash = hashing(clave);
+	franja_t* franja = franja_de(hash, valor_hash);
+	pthread_mutex_lock(&franja->mutex);
+	bool encontrada;
+	size_t pos = franja_ubicar(franja, clave, valor_hash, &encontrada);
+	void* dato = NULL;
+	if (encontrada) {
+		celda_concurrente_t* celda = &franja->tabla->celdas[pos];
+		dato = celda->dato;
+		// La clave puede estar siendo comparada por una busqueda: queda retirada.
+		clave_concurrente_t* retirada = celda->clave;
+		franja_comenzar_escritura(franja);
+		__atomic_store_n(&celda->clave, CLAVE_BORRADA, __ATOMIC_RELAXED);
+		franja_terminar_escritura(franja);
+		__atomic_store_n(&franja->cantidad, franja->cantidad - 1, __ATOMIC_RELAXED);
+		franja->borrados++;
+		retirada->siguiente = franja->claves_retiradas;
+		franja->claves_retiradas = retirada;
+		franja->bytes_retirados += sizeof(clave_concurrente_t) + strlen(retirada->texto) + 1;
+		franja_reclamar(hash, franja);
+	}
+	pthread_mutex_unlock(&franja->mutex);
+	return dato;
+}
+
+void *hash_concurrente_obtener(const hash_concurrente_t *hash, const char *clave) {
+	uint32_t valor_hash = hashing(clave);
+	void* dato;
+	// Los contadores de los lectores no son parte del contenido del hash.
+	size_t* activos = comenzar_lectura((hash_concurrente_t*)hash);
+	bool encontrada = franja_buscar(franja_de(hash, valor_hash), clave, valor_hash, &dato);
+	terminar_lectura(activos);
+	return encontrada ? dato : NULL;
+}
+
+bool hash_concurrente_pertenece(const hash_concurrente_t *hash, const char *clave) {
+	uint32_t valor_hash = hashing(clave);
+	void* dato;
+	size_t* activos = comenzar_lectura((hash_concurrente_t*)hash);
+	bool encontrada = franja_buscar(franja_de(hash, valor_hash), clave, valor_hash, &dato);
+	terminar_lectura(activos);
+	return encontrada;
+}
+
+size_t hash_concurrente_cantidad(const hash_concurrente_t *hash) {
+	size_t cantidad = 0;
+	for (size_t i = 0; i < HASH_CONCURRENTE_FRANJAS; i++) {
+		cantidad += __atomic_load_n(&hash->franjas[i].franja.cantidad, __ATOMIC_RELAXED);
+	}
+	return cantidad;
+}
+
+void hash_concurrente_destruir(hash_concurrente_t *hash) {
+	for (size_t i = 0; i < HASH_CONCURRENTE_FRANJAS; i++) franja_destruir(&hash->franjas[i].franja, hash->func_dest);
+	pthread_mutex_destroy(&hash->mutex_reclamo);
+	free(hash);
+}
@@ -0,0 +1,91 @@
+#ifndef HASH_CONCURRENTE_H
+#define HASH_CONCURRENTE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "hash.h"
+
+/* Variante de hash_t que se puede usar desde varios hilos a la vez.
+ *
+ * Las claves se reparten por su valor de hashing en HASH_CONCURRENTE_FRANJAS subtablas
+ * (franjas) independientes, cada una con su lock para las escrituras: dos guardados o borrados
+ * solo se esperan si caen en la misma franja, y una redimension solo bloquea a su franja.
+ * Las busquedas no toman locks ni escriben en las franjas: cada franja tiene un contador de
+ * secuencia (seqlock) que las escrituras incrementan antes y despues de modificarla, y una
+ * busqueda que vio la franja cambiar mientras la recorria vuelve a empezar.
+ *
+ * Para que una busqueda nunca lea memoria liberada, las tablas reemplazadas al redimensionar y
+ * las claves borradas quedan retiradas, y se liberan recien cuando terminaron todas las
+ * busquedas que pudieron verlas (un periodo de gracia). Cada busqueda se anota en un contador
+ * de su hilo (de HASH_CONCURRENTE_LECTORES, compartidos si hay mas hilos), y una franja que
+ * retiro mas bytes que los de su tabla actual cambia la epoca del hash y espera a que se
+ * vacien los contadores de la anterior antes de liberar lo retirado. Asi lo retenido por una
+ * franja queda acotado por lo que ocupa, aunque se guarden y borren claves sin parar.
+ *
+ * Los datos si los maneja quien usa el hash: el dato que devuelve una busqueda puede haber
+ * sido reemplazado o borrado por otro hilo, por lo que quien lo destruye (hash_concurrente_borrar
+ * lo devuelve, y hash_concurrente_guardar destruye el anterior) debe asegurarse de que ningun
+ * otro hilo lo siga usando. No hay iterador.
+ */
+#define HASH_CONCURRENTE_FRANJAS 64
+#define HASH_CONCURRENTE_LECTORES 64
+
+struct hash_concurrente;
+
+typedef struct hash_concurrente hash_concurrente_t;
+
+/* Crea el hash concurrente
+ */
+hash_concurrente_t *hash_concurrente_crear(hash_destruir_dato_t destruir_dato);
+
+/* Guarda un elemento en el hash, si la clave ya se encuentra en la
+ * estructura, la reemplaza (destruyendo el dato anterior). De no poder
+ * guardarlo devuelve false. Se puede llamar desde cualquier hilo.
+ * Pre: La estructura hash fue inicializada
+ * Post: Se almacenó el par (clave, dato)
+ */
+bool hash_concurrente_guardar(hash_concurrente_t *hash, const char *clave, void *dato);
+
+/* Agranda las franjas para que entren cantidad elementos en total (repartidos
+ * de manera uniforme) sin que se tengan que redimensionar. De no poder
+ * agrandarlas devuelve false.
+ * Pre: La estructura hash fue inicializada
+ */
+bool hash_concurrente_reservar(hash_concurrente_t *hash, size_t cantidad);
+
+/* Borra un elemento del hash y devuelve el dato asociado. Devuelve
+ * NULL si el dato no estaba. Se puede llamar desde cualquier hilo.
+ * Pre: La estructura hash fue inicializada
+ * Post: El elemento fue borrado de la estructura y se lo devolvió,
+ * en el caso de que estuviera guardado.
+ */
+void *hash_concurrente_borrar(hash_concurrente_t *hash, const char *clave);
+
+/* Obtiene el valor de un elemento del hash, si la clave no se encuentra
+ * devuelve NULL. No toma locks: se puede llamar desde cualquier hilo, a la
+ * vez que otros guardan o borran.
+ * Pre: La estructura hash fue inicializada
+ */
+void *hash_concurrente_obtener(const hash_concurrente_t *hash, const char *clave);
+
+/* Determina si clave pertenece o no al hash. No toma locks, como
+ * hash_concurrente_obtener.
+ * Pre: La estructura hash fue inicializada
+ */
+bool hash_concurrente_pertenece(const hash_concurrente_t *hash, const char *clave);
+
+/* Devuelve la cantidad de elementos del hash. Si otros hilos lo estan
+ * modificando, es la de algun momento reciente.
+ * Pre: La estructura hash fue inicializada
+ */
+size_t hash_concurrente_cantidad(const hash_concurrente_t *hash);
+
+/* Destruye la estructura liberando la memoria pedida y llamando a la función
+ * destruir para cada par (clave, dato). Ningun otro hilo puede estar usandola.
+ * Pre: La estructura hash fue inicializada
+ * Post: La estructura hash fue destruida
+ */
+void hash_concurrente_destruir(hash_concurrente_t *hash);
+
+#endif  // HASH_CONCURRENTE_H
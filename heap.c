@@ -42,48 +42,36 @@ void swap(void** x, void** y) {
 	*y = aux;
 }
 
-/* PRE: Recibe un arreglo, una posicion y una funcion de comparacion
- * POST: Llama recursivamente desde abajo hasta llegar al incio asegurando que se cumpla prop de max-heap
+/* PRE: Recibe un arreglo, una funcion de comparacion y una posicion
+ * POST: Sube el elemento de esa posicion hasta que se cumpla la prop de max-heap. En lugar de
+ * intercambiar en cada nivel, desplaza los padres hacia abajo y ubica el elemento una sola vez.
  */
 void upheap(void* elementos[], cmp_func_t cmp, size_t pos_elemento) {
-	if (pos_elemento == 0) return; // El elemento es la raiz
-	size_t pos_padre = (pos_elemento - 1) / 2;
-	if (cmp(elementos[pos_padre], elementos[pos_elemento]) < 0) {
-		swap(&elementos[pos_padre], &elementos[pos_elemento]);
-		upheap(elementos, cmp, pos_padre);
+	void* elemento = elementos[pos_elemento];
+	while (pos_elemento > 0) {
+		size_t pos_padre = (pos_elemento - 1) / 2;
+		if (cmp(elementos[pos_padre], elemento) >= 0) break;
+		elementos[pos_elemento] = elementos[pos_padre];
+		pos_elemento = pos_padre;
 	}
+	elementos[pos_elemento] = elemento;
 }
 
-/* PRE: Recibe un arreglo de genericos, una funcion de comparacion, una pos de padre, hijo izq e hijo der
- * POST: Devuelve la posicion del maximo de los tres
- */
-size_t calcular_pos_hijo_max(void* elementos[], cmp_func_t cmp, size_t cant_elem, size_t pos_elemento) {
-	size_t pos_hijo_izq = 2 * pos_elemento + 1;
-	if (pos_hijo_izq >= cant_elem) pos_hijo_izq = 0;
-	size_t pos_hijo_der = 2 * pos_elemento + 2;
-	if (pos_hijo_der >= cant_elem) pos_hijo_der = 0;
-	size_t pos_max = 0;
-	if (pos_hijo_izq && pos_hijo_der) {
-		if (cmp(elementos[pos_hijo_izq], elementos[pos_hijo_der]) >= 0) pos_max = pos_hijo_izq;
-		else pos_max = pos_hijo_der;
-	} else {
-		if (pos_hijo_izq) pos_max = pos_hijo_izq;
-		if (pos_hijo_der) pos_max = pos_hijo_der;
-	} 
-	return pos_max;
-}
-
-/* PRE: Recibe un arreglo, una posicion y una funcion de comparacion
- * POST: Llama recursivamente desde arriba hasta llegar al final asegurando que se cumpla prop de max-heap
+/* PRE: Recibe un arreglo, una funcion de comparacion, la cantidad de elementos y una posicion
+ * POST: Baja el elemento de esa posicion hasta que se cumpla la prop de max-heap. En lugar de
+ * intercambiar en cada nivel, desplaza el hijo maximo hacia arriba y ubica el elemento una sola vez.
  */
 void downheap(void* elementos[], cmp_func_t cmp, size_t cant_elem, size_t pos_elemento) {
-	if (pos_elemento == cant_elem - 1) return;
-	size_t pos_hijo_max = calcular_pos_hijo_max(elementos, cmp, cant_elem, pos_elemento);
-	if (!pos_hijo_max) return;
-	if (cmp(elementos[pos_elemento], elementos[pos_hijo_max]) < 0) {
-		swap(&elementos[pos_elemento], &elementos[pos_hijo_max]);
-		downheap(elementos, cmp, cant_elem, pos_hijo_max);
+	if (pos_elemento >= cant_elem) return;
+	void* elemento = elementos[pos_elemento];
+	while (2 * pos_elemento + 1 < cant_elem) {
+		size_t pos_hijo_max = 2 * pos_elemento + 1;
+		if (pos_hijo_max + 1 < cant_elem && cmp(elementos[pos_hijo_max], elementos[pos_hijo_max + 1]) < 0) pos_hijo_max++;
+		if (cmp(elemento, elementos[pos_hijo_max]) >= 0) break;
+		elementos[pos_elemento] = elementos[pos_hijo_max];
+		pos_elemento = pos_hijo_max;
 	}
+	elementos[pos_elemento] = elemento;
 }
 
 /* PRE: Recibe un arreglo, la cantidad de elementos y una funcion de comparacion
@@ -95,6 +83,17 @@ void heapify(void* elementos[], size_t cant, cmp_func_t cmp) {
 	}
 }
 
+/* PRE: Recibe la cantidad de elementos que ya tiene el heap y la cantidad a agregar.
+ * POST: Devuelve true si conviene agregar todos al final y reconstruir el heap con heapify (O(n + k)),
+ * en lugar de hacer upheap de cada uno (O(k log(n + k))).
+ */
+bool conviene_heapify(size_t cant, size_t cant_lote) {
+	size_t total = cant + cant_lote;
+	size_t log_total = 1;
+	while (total >> log_total) log_total++;
+	return cant_lote * log_total >= total;
+}
+
 
 /* ******************************************************************
  *                    PRIMITIVAS DEL HEAP
@@ -118,14 +117,10 @@ heap_t* heap_crear(cmp_func_t cmp) {
 heap_t *heap_crear_arr(void *arreglo[], size_t n, cmp_func_t cmp) {
 	heap_t* heap = heap_crear(cmp);
 	if (!heap) return NULL;
-	heap->cant = n;
-	if (n >= heap->tam) {
-		if (!heap_redimensionar(heap, n * FACTOR_REDIMENSION)) return NULL;
+	if (!heap_encolar_lote(heap, arreglo, n)) {
+		heap_destruir(heap, NULL);
+		return NULL;
 	}
-	for (size_t i = 0; i < n; i++) {
-		heap->datos[i] = arreglo[i];
-	}
-	heapify(heap->datos, n, cmp);
 	return heap;
 }
 
@@ -147,6 +142,23 @@ bool heap_esta_vacio(const heap_t *heap) {
 	return heap->cant == 0;
 }
 
+bool heap_encolar_lote(heap_t *heap, void *elems[], size_t n) {
+	if (!heap) return false;
+	if (heap->cant + n > heap->tam) {
+		size_t tam_nuevo = heap->tam;
+		while (tam_nuevo < heap->cant + n) tam_nuevo *= FACTOR_REDIMENSION;
+		if (!heap_redimensionar(heap, tam_nuevo)) return false;
+	}
+	bool reconstruir = conviene_heapify(heap->cant, n);
+	for (size_t i = 0; i < n; i++) {
+		heap->datos[heap->cant] = elems[i];
+		if (!reconstruir) upheap(heap->datos, heap->cmp, heap->cant);
+		heap->cant++;
+	}
+	if (reconstruir) heapify(heap->datos, heap->cant, heap->cmp);
+	return true;
+}
+
 bool heap_encolar(heap_t *heap, void *elem) {
 	if (!heap) return false;
 	if (heap->cant == heap->tam) {
@@ -165,8 +177,8 @@ void *heap_ver_max(const heap_t *heap) {
 void *heap_desencolar(heap_t *heap) {
 	if (heap_esta_vacio(heap)) return NULL;
 	void* desencolado = heap->datos[0];
-	swap(&heap->datos[0], &heap->datos[heap->cant - 1]);
 	heap->cant--;
+	heap->datos[0] = heap->datos[heap->cant];
 	downheap(heap->datos, heap->cmp, heap->cant, 0);
 	if (heap->cant * FACTOR_CANT_MIN <= heap->tam && heap->tam / FACTOR_REDIMENSION >= TAM_INICIAL) {
 		heap_redimensionar(heap, heap->tam / FACTOR_REDIMENSION);
@@ -69,6 +69,16 @@ bool heap_esta_vacio(const heap_t *heap);
  */
 bool heap_encolar(heap_t *heap, void *elem);
 
+/* Agrega n elementos al heap de una sola vez. Reserva la capacidad necesaria
+ * una unica vez y, segun el tamaño del lote respecto del heap, encola cada
+ * elemento o los agrega todos y reconstruye el heap en O(cantidad + n).
+ * Devuelve true si fue una operación exitosa, o false en caso de error (en ese
+ * caso no se agregó ningún elemento).
+ * Pre: el heap fue creado.
+ * Post: se agregaron los n elementos al heap.
+ */
+bool heap_encolar_lote(heap_t *heap, void *elems[], size_t n);
+
 /* Devuelve el elemento con máxima prioridad. Si el heap esta vacío, devuelve
  * NULL.
  * Pre: el heap fue creado.
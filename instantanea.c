@@ -0,0 +1,23 @@
+#include "instantanea.h"
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LECTURA
+ * *****************************************************************/
+
+bool instantanea_leer_entero(lector_instantanea_t* lector, size_t bytes, uint64_t* valor) {
+	const unsigned char* datos = instantanea_leer_arreglo(lector, bytes, 1);
+	if (!datos) return false;
+	uint64_t leido = 0;
+	for (size_t i = bytes; i > 0; i--) leido = leido << 8 | datos[i - 1];
+	*valor = leido;
+	return true;
+}
+
+const void* instantanea_leer_arreglo(lector_instantanea_t* lector, uint64_t cant, size_t tam) {
+	size_t disponibles = (size_t)(lector->fin - lector->actual);
+	if (tam && cant > disponibles / tam) return NULL;
+	const char* datos = lector->actual;
+	lector->actual += cant * tam;
+	return datos;
+}
@@ -0,0 +1,64 @@
+#ifndef INSTANTANEA_H
+#define INSTANTANEA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* ******************************************************************
+ *                DEFINICION DEL FORMATO
+ * *****************************************************************/
+
+/* Formato de las instantaneas de AlgoGram (ver algogram_guardar_instantanea). Los enteros
+ * sueltos son little-endian de ancho fijo, y los arreglos grandes (likes) se vuelcan tal como
+ * estan en memoria, para restaurarlos con una sola copia. Por eso una instantanea solo se
+ * carga en una maquina con el mismo orden de bytes y el mismo tamaño de size_t, que quedan
+ * registrados en el encabezado:
+ *
+ *   encabezado  "ALGOGRAM", version u32, marca de orden u32 (INSTANTANEA_MARCA_ORDEN en el
+ *               orden de la maquina), tamaño de size_t u8, modo del feed u8, proximo ID de
+ *               usuario u64, cantidad de usuarios u64, cantidad de posts u64, secuencia del
+ *               primer registro de la bitacora que no esta incluido u64 (ver bitacora.h)
+ *   usuarios    por cada uno, en orden de ID: ID u64, largo u32, nombre terminado en '\0'
+ *   posts       por cada ID, en orden: el post (ver post_volcar)
+ *   feeds       por cada usuario, en el mismo orden: su estado (ver usuario_volcar)
+ */
+#define INSTANTANEA_MAGICO "ALGOGRAM"
+#define INSTANTANEA_LARGO_MAGICO 8
+#define INSTANTANEA_VERSION 3
+#define INSTANTANEA_MARCA_ORDEN 0x01020304U
+
+#define INSTANTANEA_TAM_U8 1
+#define INSTANTANEA_TAM_U32 4
+#define INSTANTANEA_TAM_U64 8
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+// Posicion de lectura dentro de una instantanea mapeada en memoria.
+typedef struct lector_instantanea {
+	const char* actual;
+	const char* fin;
+} lector_instantanea_t;
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LECTURA
+ * *****************************************************************/
+
+/* PRE: Recibe un lector y el largo de un entero del formato (a lo sumo 8 bytes).
+ * POST: Lee el entero little-endian y lo guarda en valor. Devuelve false si la instantanea
+ * termina antes.
+ */
+bool instantanea_leer_entero(lector_instantanea_t* lector, size_t bytes, uint64_t* valor);
+
+/* PRE: Recibe un lector, una cantidad de elementos y el tamaño de cada uno.
+ * POST: Devuelve una vista (sin alinear) de los siguientes cant * tam bytes y avanza el lector,
+ * o NULL si la instantanea termina antes.
+ */
+const void* instantanea_leer_arreglo(lector_instantanea_t* lector, uint64_t cant, size_t tam);
+
+#endif  // INSTANTANEA_H
@@ -0,0 +1,269 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "likes.h"
+
+#define CAPACIDAD_INICIAL 4
+#define FACTOR_REDIMENSION 2
+#define BITS_POR_PALABRA 64
+// Si hay al menos un like cada tantos usuarios, conviene recorrer todo el orden alfabetico
+// probando cada ID en el mapa de bits, en lugar de ordenar los likes.
+#define USUARIOS_POR_LIKE_RECORRIDO 16
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+struct likes {
+	uint32_t* ids;     // Ordenados de menor a mayor, mientras el conjunto es disperso.
+	size_t capacidad;
+	uint64_t* bits;    // El mapa de bits, una vez que el conjunto es denso (ids es NULL).
+	size_t palabras;
+	size_t cantidad;
+};
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+/* PRE: Recibe un conjunto disperso y un ID.
+ * POST: Devuelve la posicion del primer ID del arreglo que no es menor al recibido.
+ */
+size_t likes_buscar_pos(const likes_t* likes, size_t id) {
+	size_t inicio = 0;
+	size_t fin = likes->cantidad;
+	while (inicio < fin) {
+		size_t medio = inicio + (fin - inicio) / 2;
+		if (likes->ids[medio] < id) inicio = medio + 1;
+		else fin = medio;
+	}
+	return inicio;
+}
+
+/* PRE: Recibe un conjunto denso y un ID.
+ * POST: Devuelve true si el mapa de bits tiene lugar para ese ID, agrandandolo si hace falta.
+ */
+bool likes_asegurar_bits(likes_t* likes, size_t id) {
+	size_t palabras_necesarias = id / BITS_POR_PALABRA + 1;
+	if (palabras_necesarias <= likes->palabras) return true;
+	size_t palabras_nuevas = likes->palabras * FACTOR_REDIMENSION;
+	if (palabras_nuevas < palabras_necesarias) palabras_nuevas = palabras_necesarias;
+	uint64_t* bits = realloc(likes->bits, palabras_nuevas * sizeof(uint64_t));
+	if (!bits) return false;
+	memset(bits + likes->palabras, 0, (palabras_nuevas - likes->palabras) * sizeof(uint64_t));
+	likes->bits = bits;
+	likes->palabras = palabras_nuevas;
+	return true;
+}
+
+/* PRE: Recibe un conjunto disperso y el mayor ID que va a tener.
+ * POST: Devuelve true si se paso el conjunto a un mapa de bits, o false si no se pudo
+ * (en ese caso el conjunto no se modifica).
+ */
+bool likes_pasar_a_bits(likes_t* likes, size_t id_max) {
+	size_t palabras = id_max / BITS_POR_PALABRA + 1;
+	uint64_t* bits = calloc(palabras, sizeof(uint64_t));
+	if (!bits) return false;
+	for (size_t i = 0; i < likes->cantidad; i++) {
+		bits[likes->ids[i] / BITS_POR_PALABRA] |= (uint64_t)1 << (likes->ids[i] % BITS_POR_PALABRA);
+	}
+	free(likes->ids);
+	likes->ids = NULL;
+	likes->capacidad = 0;
+	likes->bits = bits;
+	likes->palabras = palabras;
+	return true;
+}
+
+/* PRE: Recibe un conjunto disperso y lleno, y el ID que se le quiere agregar.
+ * POST: Devuelve true si se hizo lugar para el ID: duplicando el arreglo o, si un mapa
+ * de bits hasta el mayor ID ocuparia menos que el arreglo duplicado, pasando a mapa de bits.
+ */
+bool likes_hacer_lugar(likes_t* likes, size_t id) {
+	size_t capacidad_nueva = likes->capacidad ? likes->capacidad * FACTOR_REDIMENSION : CAPACIDAD_INICIAL;
+	size_t id_max = likes->cantidad && likes->ids[likes->cantidad - 1] > id ? likes->ids[likes->cantidad - 1] : id;
+	if ((id_max / BITS_POR_PALABRA + 1) * sizeof(uint64_t) <= capacidad_nueva * sizeof(uint32_t)) {
+		return likes_pasar_a_bits(likes, id_max);
+	}
+	uint32_t* ids = realloc(likes->ids, capacidad_nueva * sizeof(uint32_t));
+	if (!ids) return false;
+	likes->ids = ids;
+	likes->capacidad = capacidad_nueva;
+	return true;
+}
+
+// Compara dos posiciones alfabeticas, para ordenarlas con qsort.
+int comparar_rangos(const void* a, const void* b) {
+	size_t rango_a = *(const size_t*)a;
+	size_t rango_b = *(const size_t*)b;
+	return rango_a < rango_b ? -1 : rango_a > rango_b;
+}
+
+/* PRE: Recibe un directorio ordenado, un ID, una posicion alfabetica minima y un arreglo de
+ * posiciones con n elementos.
+ * POST: Agrega al arreglo la posicion del ID si esta vigente y no es menor a rango_min, y
+ * devuelve la nueva cantidad de elementos.
+ */
+size_t likes_agregar_rango(const directorio_t* directorio, size_t id, size_t rango_min, size_t* rangos, size_t n) {
+	if (!directorio_nombre(directorio, id)) return n;
+	size_t rango = directorio_rango(directorio, id);
+	if (rango >= rango_min) rangos[n++] = rango;
+	return n;
+}
+
+/* PRE: Recibe un conjunto, un directorio ordenado, una posicion alfabetica minima y un
+ * arreglo con lugar para todos los IDs del conjunto.
+ * POST: Guarda en rangos la posicion alfabetica de cada ID vigente del conjunto que no sea
+ * menor a rango_min, y devuelve cuantos guardo.
+ */
+size_t likes_obtener_rangos(const likes_t* likes, const directorio_t* directorio, size_t rango_min, size_t* rangos) {
+	size_t n = 0;
+	if (likes->ids) {
+		for (size_t i = 0; i < likes->cantidad; i++) n = likes_agregar_rango(directorio, likes->ids[i], rango_min, rangos, n);
+		return n;
+	}
+	for (size_t p = 0; p < likes->palabras; p++) {
+		for (uint64_t palabra = likes->bits[p], b = 0; palabra; palabra >>= 1, b++) {
+			if (palabra & 1) n = likes_agregar_rango(directorio, p * BITS_POR_PALABRA + b, rango_min, rangos, n);
+		}
+	}
+	return n;
+}
+
+// Devuelve la cantidad de bits prendidos de una palabra.
+size_t likes_contar_bits(uint64_t palabra) {
+	palabra -= (palabra >> 1) & 0x5555555555555555ULL;
+	palabra = (palabra & 0x3333333333333333ULL) + ((palabra >> 2) & 0x3333333333333333ULL);
+	palabra = (palabra + (palabra >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+	return (size_t)((palabra * 0x0101010101010101ULL) >> 56);
+}
+
+/* PRE: Recibe un conjunto recien restaurado.
+ * POST: Devuelve true si cumple los invariantes de los que dependen las busquedas: los IDs del
+ * arreglo estrictamente crecientes, o tantos bits prendidos en el mapa como la cantidad.
+ */
+bool likes_es_valido(const likes_t* likes) {
+	if (likes->ids) {
+		for (size_t i = 1; i < likes->cantidad; i++) {
+			if (likes->ids[i - 1] >= likes->ids[i]) return false;
+		}
+		return true;
+	}
+	size_t prendidos = 0;
+	for (size_t p = 0; p < likes->palabras; p++) prendidos += likes_contar_bits(likes->bits[p]);
+	return prendidos == likes->cantidad;
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL CONJUNTO DE LIKES
+ * *****************************************************************/
+
+likes_t* likes_crear(void) {
+	likes_t* likes = calloc(1, sizeof(likes_t));
+	if (!likes) return NULL;
+	return likes;
+}
+
+bool likes_agregar(likes_t* likes, size_t id) {
+	if (id > LIKES_ID_MAX) return false;
+	if (likes_contiene(likes, id)) return true;
+	if (!likes->bits && likes->cantidad == likes->capacidad && !likes_hacer_lugar(likes, id)) return false;
+	if (likes->bits) {
+		if (!likes_asegurar_bits(likes, id)) return false;
+		likes->bits[id / BITS_POR_PALABRA] |= (uint64_t)1 << (id % BITS_POR_PALABRA);
+	} else {
+		size_t pos = likes_buscar_pos(likes, id);
+		memmove(likes->ids + pos + 1, likes->ids + pos, (likes->cantidad - pos) * sizeof(uint32_t));
+		likes->ids[pos] = (uint32_t)id;
+	}
+	likes->cantidad++;
+	return true;
+}
+
+bool likes_contiene(const likes_t* likes, size_t id) {
+	if (likes->bits) {
+		return id / BITS_POR_PALABRA < likes->palabras && (likes->bits[id / BITS_POR_PALABRA] >> (id % BITS_POR_PALABRA)) & 1;
+	}
+	size_t pos = likes_buscar_pos(likes, id);
+	return pos < likes->cantidad && likes->ids[pos] == id;
+}
+
+size_t likes_cantidad(const likes_t* likes) {
+	return likes->cantidad;
+}
+
+bool likes_recorrer(const likes_t* likes, directorio_t* directorio, const char* desde, bool visitar(size_t, const char*, void*), void* extra) {
+	if (!directorio_ordenar(directorio)) return false;
+	size_t cant_usuarios = directorio_cantidad(directorio);
+	size_t rango_min = desde ? directorio_rango_desde(directorio, desde) : 0;
+	if (likes->bits && likes->cantidad * USUARIOS_POR_LIKE_RECORRIDO >= cant_usuarios) {
+		for (size_t r = rango_min; r < cant_usuarios; r++) {
+			size_t id = directorio_id_en_rango(directorio, r);
+			if (likes_contiene(likes, id) && !visitar(id, directorio_nombre(directorio, id), extra)) break;
+		}
+		return true;
+	}
+	size_t* rangos = malloc((likes->cantidad ? likes->cantidad : 1) * sizeof(size_t));
+	if (!rangos) return false;
+	size_t n = likes_obtener_rangos(likes, directorio, rango_min, rangos);
+	qsort(rangos, n, sizeof(size_t), comparar_rangos);
+	for (size_t i = 0; i < n; i++) {
+		size_t id = directorio_id_en_rango(directorio, rangos[i]);
+		if (!visitar(id, directorio_nombre(directorio, id), extra)) break;
+	}
+	free(rangos);
+	return true;
+}
+
+void likes_volcar(const likes_t* likes, salida_t* salida) {
+	salida_entero(salida, likes->bits != NULL, INSTANTANEA_TAM_U8);
+	salida_entero(salida, likes->cantidad, INSTANTANEA_TAM_U64);
+	if (likes->bits) {
+		salida_entero(salida, likes->palabras, INSTANTANEA_TAM_U64);
+		salida_bytes(salida, likes->bits, likes->palabras * sizeof(uint64_t));
+	} else {
+		salida_entero(salida, likes->cantidad, INSTANTANEA_TAM_U64);
+		if (likes->cantidad) salida_bytes(salida, likes->ids, likes->cantidad * sizeof(uint32_t));
+	}
+}
+
+likes_t* likes_restaurar(lector_instantanea_t* lector) {
+	uint64_t denso, cantidad, elementos;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U8, &denso)) return NULL;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, &cantidad)) return NULL;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, &elementos)) return NULL;
+	if (denso > 1 || (!denso && elementos != cantidad) || (denso && cantidad > elementos * BITS_POR_PALABRA)) return NULL;
+	size_t tam = denso ? sizeof(uint64_t) : sizeof(uint32_t);
+	const void* datos = instantanea_leer_arreglo(lector, elementos, tam);
+	if (!datos) return NULL;
+	likes_t* likes = likes_crear();
+	if (!likes || !elementos) return likes;
+	void* copia = malloc(elementos * tam);
+	if (!copia) {
+		likes_destruir(likes);
+		return NULL;
+	}
+	memcpy(copia, datos, elementos * tam);
+	if (denso) {
+		likes->bits = copia;
+		likes->palabras = elementos;
+	} else {
+		likes->ids = copia;
+		likes->capacidad = elementos;
+	}
+	likes->cantidad = cantidad;
+	if (!likes_es_valido(likes)) {
+		likes_destruir(likes);
+		return NULL;
+	}
+	return likes;
+}
+
+void likes_destruir(likes_t* likes) {
+	free(likes->ids);
+	free(likes->bits);
+	free(likes);
+}
@@ -0,0 +1,77 @@
+#ifndef LIKES_H
+#define LIKES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "directorio.h"
+#include "instantanea.h"
+#include "salida.h"
+
+#define LIKES_ID_MAX UINT32_MAX
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Conjunto de IDs de usuario que likearon un post. Mientras es disperso se guarda
+ * como un arreglo ordenado de IDs (4 bytes por like, busqueda binaria); cuando un
+ * mapa de bits sobre los IDs ocuparia menos que el arreglo, pasa a ser un mapa de
+ * bits (un bit por ID, pertenencia O(1)) y ya no vuelve a ser disperso.
+ */
+typedef struct likes likes_t;
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL CONJUNTO DE LIKES
+ * *****************************************************************/
+
+// Crea un conjunto de likes vacio.
+likes_t* likes_crear(void);
+
+/* PRE: Recibe un conjunto previamente creado y un ID de usuario no mayor a LIKES_ID_MAX.
+ * POST: Devuelve true si el ID quedo en el conjunto (si ya estaba, no se modifica), o
+ * false si no se pudo agregar.
+ */
+bool likes_agregar(likes_t* likes, size_t id);
+
+/* PRE: Recibe un conjunto previamente creado y un ID de usuario.
+ * POST: Devuelve true si el ID esta en el conjunto, en caso contrario false.
+ */
+bool likes_contiene(const likes_t* likes, size_t id);
+
+/* PRE: Recibe un conjunto previamente creado.
+ * POST: Devuelve la cantidad de IDs del conjunto.
+ */
+size_t likes_cantidad(const likes_t* likes);
+
+/* PRE: Recibe un conjunto previamente creado, el directorio de usuarios, un nombre desde el
+ * cual recorrer (o NULL para recorrer desde el principio), una funcion visitar y un dato
+ * extra para visitar.
+ * POST: Aplica visitar al ID y al nombre de cada usuario del conjunto que siga vigente en el
+ * directorio y sea mayor o igual a desde, en orden alfabetico, hasta que visitar devuelva
+ * false. Devuelve false si no se pudo ordenar el directorio o pedir memoria para el recorrido.
+ */
+bool likes_recorrer(const likes_t* likes, directorio_t* directorio, const char* desde, bool visitar(size_t, const char*, void*), void* extra);
+
+/* PRE: Recibe un conjunto previamente creado y la salida de una instantanea.
+ * POST: Se escribio el conjunto: denso u8, cantidad u64, cantidad de elementos u64 y el
+ * arreglo ordenado de IDs (u32) o el mapa de bits (u64), tal como estan en memoria.
+ */
+void likes_volcar(const likes_t* likes, salida_t* salida);
+
+/* PRE: Recibe un lector posicionado donde se escribio un conjunto con likes_volcar.
+ * POST: Devuelve el conjunto restaurado con una copia de su arreglo, o NULL si la instantanea
+ * no tiene un conjunto valido (IDs desordenados o repetidos, o un mapa de bits con otra
+ * cantidad de IDs) o no hay memoria.
+ */
+likes_t* likes_restaurar(lector_instantanea_t* lector);
+
+/* PRE: Recibe un conjunto previamente creado.
+ * POST: Se destruyo el conjunto.
+ */
+void likes_destruir(likes_t* likes);
+
+#endif  // LIKES_H
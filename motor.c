@@ -0,0 +1,573 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "motor.h"
+#include "usuario.h"
+#include "post.h"
+#include "hash.h"
+#include "nombres.h"
+#include "directorio.h"
+#include "padron.h"
+#include "estadisticas.h"
+
+#define BUZON_TAM_INICIAL 64
+#define POSTS_TAM_INICIAL 32
+#define FACTOR_REDIMENSION 2
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+typedef enum {
+	MENSAJE_PUBLICAR,         // Crear el post (particion del post) y distribuirlo.
+	MENSAJE_ENTREGAR,         // Encolar un post en los feeds de la particion.
+	MENSAJE_VER_SIGUIENTE,    // Sacar el siguiente post del feed (particion del usuario).
+	MENSAJE_COMPLETAR_VISTA,  // Contar los likes del post visto (particion del post).
+	MENSAJE_LIKEAR,
+	MENSAJE_VER_LIKES,
+} tipo_mensaje_t;
+
+// Operacion pedida por un cliente, que espera bloqueado hasta que una particion la complete.
+typedef struct pedido {
+	pthread_mutex_t mutex;
+	pthread_cond_t completado;
+	bool listo;
+	protocolo_estado_t estado;
+	usuario_t* usuario;  // El de la sesion (publicar, ver y likear).
+	const char* texto;
+	size_t id_post;
+	vista_post_t* vista;
+	bool (*visitar)(size_t, const char*, void*);
+	void* extra;
+} pedido_t;
+
+typedef struct mensaje {
+	tipo_mensaje_t tipo;
+	pedido_t* pedido;  // NULL en los mensajes entre particiones que no responden a nadie.
+	post_t* post;      // Entregar y completar vista.
+} mensaje_t;
+
+// Mensajes pendientes de una particion. Lo escriben todos, y lo vacia solo el hilo dueño.
+typedef struct buzon {
+	pthread_mutex_t mutex;
+	pthread_cond_t hay_mensajes;
+	mensaje_t* mensajes;
+	size_t cant;
+	size_t tam;
+	bool terminar;  // El hilo dueño termina cuando vacia el buzon.
+} buzon_t;
+
+typedef struct particion {
+	motor_t* motor;
+	size_t indice;
+	usuario_t** usuarios;  // El usuario con ID i esta en la posicion i / N (NULL si no esta vigente).
+	size_t cant_usuarios;
+	post_t** posts;        // Igual que los usuarios, por ID del post.
+	size_t tam_posts;
+	buzon_t buzon;
+	mensaje_t* procesando;  // Mensajes sacados del buzon, que se intercambia con este arreglo.
+	size_t tam_procesando;
+	pthread_t hilo;
+	ESTADISTICA(estadisticas_t estadisticas;)  // Las del hilo, que deja al terminar.
+} particion_t;
+
+struct motor {
+	particion_t* particiones;
+	size_t cant_particiones;
+	hash_t* usuarios;  // Nombre -> usuario. Despues de iniciar solo se lee.
+	nombres_t* nombres;
+	directorio_t* directorio;  // Ordenado al iniciar, para que los recorridos solo lo lean.
+	size_t id_usuario;
+	size_t id_post;  // Atomico: lo incrementan los hilos de los clientes.
+	size_t hilos_lanzados;
+	bool iniciado;
+};
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Es un wrapper de la primitiva usuario_destruir para utilizar en el hash de usuarios del motor.
+void destruir_usuario_motor(void* usuario) {
+	usuario_destruir(usuario);
+}
+
+// Devuelve la particion dueña de un ID (de usuario o de post).
+particion_t* particion_de_id(const motor_t* motor, size_t id) {
+	return &motor->particiones[id % motor->cant_particiones];
+}
+
+// Devuelve la distancia entre los IDs de dos usuarios (la afinidad del feed).
+size_t distancia_usuarios(size_t id_usuario, size_t id_posteador) {
+	return id_usuario > id_posteador ? id_usuario - id_posteador : id_posteador - id_usuario;
+}
+
+/* PRE: Recibe un buzon sin inicializar.
+ * POST: Devuelve true si se pudo inicializar vacio, en caso contrario false.
+ */
+bool buzon_inicializar(buzon_t* buzon) {
+	buzon->mensajes = malloc(BUZON_TAM_INICIAL * sizeof(mensaje_t));
+	if (!buzon->mensajes) return false;
+	if (pthread_mutex_init(&buzon->mutex, NULL) != 0) {
+		free(buzon->mensajes);
+		return false;
+	}
+	if (pthread_cond_init(&buzon->hay_mensajes, NULL) != 0) {
+		pthread_mutex_destroy(&buzon->mutex);
+		free(buzon->mensajes);
+		return false;
+	}
+	buzon->cant = 0;
+	buzon->tam = BUZON_TAM_INICIAL;
+	buzon->terminar = false;
+	return true;
+}
+
+void buzon_finalizar(buzon_t* buzon) {
+	pthread_cond_destroy(&buzon->hay_mensajes);
+	pthread_mutex_destroy(&buzon->mutex);
+	free(buzon->mensajes);
+}
+
+/* PRE: Recibe un buzon con su lock tomado.
+ * POST: Devuelve true si hay lugar para un mensaje mas, agrandandolo si hace falta.
+ */
+bool buzon_hacer_lugar(buzon_t* buzon) {
+	if (buzon->cant < buzon->tam) return true;
+	mensaje_t* mensajes = realloc(buzon->mensajes, buzon->tam * FACTOR_REDIMENSION * sizeof(mensaje_t));
+	if (!mensajes) return false;
+	buzon->mensajes = mensajes;
+	buzon->tam *= FACTOR_REDIMENSION;
+	return true;
+}
+
+/* PRE: Recibe un buzon con su lock tomado y lugar para un mensaje mas.
+ * POST: Agrego el mensaje despues de los que ya estaban y desperto al hilo dueño.
+ */
+void buzon_agregar(buzon_t* buzon, tipo_mensaje_t tipo, pedido_t* pedido, post_t* post) {
+	mensaje_t* mensaje = &buzon->mensajes[buzon->cant++];
+	mensaje->tipo = tipo;
+	mensaje->pedido = pedido;
+	mensaje->post = post;
+	pthread_cond_signal(&buzon->hay_mensajes);
+}
+
+/* PRE: Recibe una particion y un mensaje. Se puede llamar desde cualquier hilo.
+ * POST: Devuelve true si el mensaje quedo en el buzon de la particion (despues de los que ya
+ * estaban), en caso contrario false.
+ */
+bool enviar_mensaje(particion_t* particion, tipo_mensaje_t tipo, pedido_t* pedido, post_t* post) {
+	buzon_t* buzon = &particion->buzon;
+	pthread_mutex_lock(&buzon->mutex);
+	bool hay_lugar = buzon_hacer_lugar(buzon);
+	if (hay_lugar) buzon_agregar(buzon, tipo, pedido, post);
+	pthread_mutex_unlock(&buzon->mutex);
+	return hay_lugar;
+}
+
+/* PRE: Recibe la particion de un post nuevo. Se llama desde su hilo.
+ * POST: Devuelve true si el post quedo para entregar en el buzon de todas las demas
+ * particiones, o false (sin enviarlo a ninguna) si alguna no tenia lugar. Los buzones se
+ * bloquean todos, en orden de particion, para que sea todo o nada; el resto de los envios
+ * bloquea un solo buzon, asi que no hay esperas circulares.
+ */
+bool enviar_entregas(particion_t* particion, post_t* post) {
+	motor_t* motor = particion->motor;
+	bool hay_lugar = true;
+	for (size_t i = 0; i < motor->cant_particiones; i++) {
+		if (i == particion->indice) continue;
+		pthread_mutex_lock(&motor->particiones[i].buzon.mutex);
+		hay_lugar = hay_lugar && buzon_hacer_lugar(&motor->particiones[i].buzon);
+	}
+	for (size_t i = 0; i < motor->cant_particiones; i++) {
+		if (i == particion->indice) continue;
+		buzon_t* buzon = &motor->particiones[i].buzon;
+		if (hay_lugar) buzon_agregar(buzon, MENSAJE_ENTREGAR, NULL, post);
+		pthread_mutex_unlock(&buzon->mutex);
+	}
+	return hay_lugar;
+}
+
+/* PRE: Recibe la particion del hilo que llama.
+ * POST: Espera a que haya mensajes o se pida terminar, y pasa todos los mensajes al arreglo
+ * procesando, dejando el buzon vacio. Devuelve la cantidad de mensajes: 0 solo si hay que
+ * terminar y ya no queda nada pendiente.
+ */
+size_t recibir_mensajes(particion_t* particion) {
+	buzon_t* buzon = &particion->buzon;
+	pthread_mutex_lock(&buzon->mutex);
+	while (!buzon->cant && !buzon->terminar) pthread_cond_wait(&buzon->hay_mensajes, &buzon->mutex);
+	// Se intercambian los arreglos, para no copiar ni retener el lock mientras se procesa.
+	mensaje_t* mensajes = buzon->mensajes;
+	size_t tam = buzon->tam, cant = buzon->cant;
+	buzon->mensajes = particion->procesando;
+	buzon->tam = particion->tam_procesando;
+	buzon->cant = 0;
+	pthread_mutex_unlock(&buzon->mutex);
+	particion->procesando = mensajes;
+	particion->tam_procesando = tam;
+	return cant;
+}
+
+// Inicializa un pedido sin completar.
+void pedido_inicializar(pedido_t* pedido) {
+	memset(pedido, 0, sizeof(pedido_t));
+	pthread_mutex_init(&pedido->mutex, NULL);
+	pthread_cond_init(&pedido->completado, NULL);
+}
+
+/* PRE: Recibe un pedido en curso y su resultado.
+ * POST: Despierta al cliente que lo espera. Despues de esto el pedido no se puede usar.
+ */
+void pedido_completar(pedido_t* pedido, protocolo_estado_t estado) {
+	pthread_mutex_lock(&pedido->mutex);
+	pedido->estado = estado;
+	pedido->listo = true;
+	pthread_cond_signal(&pedido->completado);
+	pthread_mutex_unlock(&pedido->mutex);
+}
+
+/* PRE: Recibe un pedido inicializado, la particion que lo atiende y el tipo de mensaje.
+ * POST: Envia el pedido y espera a que se complete. Devuelve su resultado y finaliza el pedido.
+ */
+protocolo_estado_t pedido_resolver(pedido_t* pedido, particion_t* particion, tipo_mensaje_t tipo) {
+	if (enviar_mensaje(particion, tipo, pedido, NULL)) {
+		pthread_mutex_lock(&pedido->mutex);
+		while (!pedido->listo) pthread_cond_wait(&pedido->completado, &pedido->mutex);
+		pthread_mutex_unlock(&pedido->mutex);
+	} else {
+		pedido->estado = PROTOCOLO_ERROR_INTERNO;
+	}
+	pthread_cond_destroy(&pedido->completado);
+	pthread_mutex_destroy(&pedido->mutex);
+	return pedido->estado;
+}
+
+// Devuelve el post con ese ID si es de la particion y existe, o NULL.
+post_t* particion_obtener_post(const particion_t* particion, size_t id_post) {
+	size_t pos = id_post / particion->motor->cant_particiones;
+	return pos < particion->tam_posts ? particion->posts[pos] : NULL;
+}
+
+/* PRE: Recibe una particion y un post nuevo que le pertenece.
+ * POST: Devuelve true si se guardo el post, agrandando el arreglo si hace falta (los IDs
+ * pueden llegar desordenados), en caso contrario false.
+ */
+bool particion_guardar_post(particion_t* particion, post_t* post) {
+	size_t pos = post_ver_id(post) / particion->motor->cant_particiones;
+	if (pos >= particion->tam_posts) {
+		size_t tam_nuevo = particion->tam_posts ? particion->tam_posts : POSTS_TAM_INICIAL;
+		while (tam_nuevo <= pos) tam_nuevo *= FACTOR_REDIMENSION;
+		post_t** posts = realloc(particion->posts, tam_nuevo * sizeof(post_t*));
+		if (!posts) return false;
+		memset(posts + particion->tam_posts, 0, (tam_nuevo - particion->tam_posts) * sizeof(post_t*));
+		particion->posts = posts;
+		particion->tam_posts = tam_nuevo;
+	}
+	particion->posts[pos] = post;
+	return true;
+}
+
+/* PRE: Recibe una particion y un post publicado.
+ * POST: Encolo el post en el feed de cada usuario de la particion, salvo el posteador. Si no
+ * hay memoria para algun feed, ese usuario no lo va a ver.
+ */
+void entregar_post(particion_t* particion, post_t* post) {
+	size_t id_posteador = post_ver_id_posteador(post);
+	for (size_t i = 0; i < particion->cant_usuarios; i++) {
+		usuario_t* usuario = particion->usuarios[i];
+		if (!usuario) continue;
+		size_t id_usuario = usuario_obtener_id(usuario);
+		if (id_usuario != id_posteador) usuario_guardar_feed(usuario, post, distancia_usuarios(id_usuario, id_posteador));
+	}
+}
+
+/* Crea y guarda el post pedido, y lo envia a las demas particiones antes de responder. Si no
+ * se puede enviar a todas, el post no se publica.
+ */
+void procesar_publicar(particion_t* particion, pedido_t* pedido) {
+	usuario_t* posteador = pedido->usuario;
+	char* texto = strdup(pedido->texto);
+	post_t* post = texto ? post_crear(usuario_ver_nombre(posteador), usuario_obtener_id(posteador), texto, pedido->id_post) : NULL;
+	if (!post) free(texto);
+	if (!post || !particion_guardar_post(particion, post)) {
+		if (post) post_destruir(post);
+		pedido_completar(pedido, PROTOCOLO_ERROR_INTERNO);
+		return;
+	}
+	if (!enviar_entregas(particion, post)) {
+		// Ninguna otra particion lo vio: se saca, y su ID queda sin post (como uno inexistente).
+		particion->posts[post_ver_id(post) / particion->motor->cant_particiones] = NULL;
+		post_destruir(post);
+		pedido_completar(pedido, PROTOCOLO_ERROR_INTERNO);
+		return;
+	}
+	pedido_completar(pedido, PROTOCOLO_OK);
+	entregar_post(particion, post);
+}
+
+// Cuenta los likes del post visto y responde al cliente (en la particion del post).
+void procesar_completar_vista(pedido_t* pedido, post_t* post) {
+	pedido->vista->likes = post_cantidad_likes(post);
+	pedido_completar(pedido, PROTOCOLO_OK);
+}
+
+// Saca el siguiente post del feed del usuario; los likes los cuenta la particion del post.
+void procesar_ver_siguiente(particion_t* particion, pedido_t* pedido) {
+	usuario_t* usuario = pedido->usuario;
+	post_t* post = usuario_ver_post(usuario);
+	if (!post) {
+		pedido_completar(pedido, PROTOCOLO_SIN_POSTS);
+		return;
+	}
+	vista_post_t* vista = pedido->vista;
+	vista->id = post_ver_id(post);
+	vista->id_posteador = post_ver_id_posteador(post);
+	vista->posteador = post_ver_posteador(post);
+	vista->texto = post_ver_texto(post);
+	particion_t* particion_post = particion_de_id(particion->motor, vista->id);
+	if (particion_post == particion) {
+		procesar_completar_vista(pedido, post);
+	} else if (!enviar_mensaje(particion_post, MENSAJE_COMPLETAR_VISTA, pedido, post)) {
+		pedido_completar(pedido, PROTOCOLO_ERROR_INTERNO);
+	}
+}
+
+void procesar_likear(particion_t* particion, pedido_t* pedido) {
+	post_t* post = particion_obtener_post(particion, pedido->id_post);
+	if (!post) {
+		pedido_completar(pedido, PROTOCOLO_POST_INEXISTENTE);
+		return;
+	}
+	size_t id_usuario = usuario_obtener_id(pedido->usuario);
+	if (!post_esta_likeado(post, id_usuario) && !post_likear(post, id_usuario)) {
+		pedido_completar(pedido, PROTOCOLO_ERROR_INTERNO);
+		return;
+	}
+	pedido_completar(pedido, PROTOCOLO_OK);
+}
+
+void procesar_ver_likes(particion_t* particion, pedido_t* pedido) {
+	post_t* post = particion_obtener_post(particion, pedido->id_post);
+	protocolo_estado_t estado = PROTOCOLO_OK;
+	if (!post) estado = PROTOCOLO_POST_INEXISTENTE;
+	else if (!post_cantidad_likes(post)) estado = PROTOCOLO_SIN_LIKES;
+	else if (!post_recorrer_likes(post, particion->motor->directorio, pedido->visitar, pedido->extra)) estado = PROTOCOLO_ERROR_INTERNO;
+	pedido_completar(pedido, estado);
+}
+
+// Funcion del hilo de cada particion: atiende su buzon hasta que se pida terminar y quede vacio.
+void* atender_particion(void* extra) {
+	particion_t* particion = extra;
+	size_t cant;
+	while ((cant = recibir_mensajes(particion))) {
+		for (size_t i = 0; i < cant; i++) {
+			mensaje_t* mensaje = &particion->procesando[i];
+			switch (mensaje->tipo) {
+				case MENSAJE_PUBLICAR: procesar_publicar(particion, mensaje->pedido); break;
+				case MENSAJE_ENTREGAR: entregar_post(particion, mensaje->post); break;
+				case MENSAJE_VER_SIGUIENTE: procesar_ver_siguiente(particion, mensaje->pedido); break;
+				case MENSAJE_COMPLETAR_VISTA: procesar_completar_vista(mensaje->pedido, mensaje->post); break;
+				case MENSAJE_LIKEAR: procesar_likear(particion, mensaje->pedido); break;
+				case MENSAJE_VER_LIKES: procesar_ver_likes(particion, mensaje->pedido); break;
+			}
+		}
+	}
+	ESTADISTICA(estadisticas_transferir(&particion->estadisticas, &estadisticas));
+	return NULL;
+}
+
+/* PRE: Recibe un motor sin iniciar con sus particiones inicializadas.
+ * POST: Devuelve true si pudo repartir los usuarios vigentes en las particiones.
+ */
+bool repartir_usuarios(motor_t* motor) {
+	size_t n = motor->cant_particiones;
+	for (size_t i = 0; i < n; i++) {
+		particion_t* particion = &motor->particiones[i];
+		particion->cant_usuarios = motor->id_usuario / n + (i < motor->id_usuario % n ? 1 : 0);
+		if (!particion->cant_usuarios) continue;
+		particion->usuarios = calloc(particion->cant_usuarios, sizeof(usuario_t*));
+		if (!particion->usuarios) return false;
+	}
+	hash_iter_t* iter = hash_iter_crear(motor->usuarios);
+	if (!iter) return false;
+	for (; !hash_iter_al_final(iter); hash_iter_avanzar(iter)) {
+		usuario_t* usuario = hash_obtener(motor->usuarios, hash_iter_ver_actual(iter));
+		size_t id = usuario_obtener_id(usuario);
+		particion_de_id(motor, id)->usuarios[id / n] = usuario;
+	}
+	hash_iter_destruir(iter);
+	return true;
+}
+
+// Devuelve la particion dueña del feed de un usuario.
+particion_t* particion_de_usuario(const motor_t* motor, usuario_t* usuario) {
+	return particion_de_id(motor, usuario_obtener_id(usuario));
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL MOTOR
+ * *****************************************************************/
+
+motor_t* motor_crear(size_t cant_particiones) {
+	if (!cant_particiones) return NULL;
+	motor_t* motor = malloc(sizeof(motor_t));
+	if (!motor) return NULL;
+	motor->particiones = calloc(cant_particiones, sizeof(particion_t));
+	if (!motor->particiones) {
+		free(motor);
+		return NULL;
+	}
+	motor->nombres = nombres_crear();
+	if (!motor->nombres) {
+		free(motor->particiones);
+		free(motor);
+		return NULL;
+	}
+	motor->usuarios = hash_crear_con_opciones(destruir_usuario_motor, HASH_CLAVES_EXTERNAS);
+	if (!motor->usuarios) {
+		nombres_destruir(motor->nombres);
+		free(motor->particiones);
+		free(motor);
+		return NULL;
+	}
+	motor->directorio = directorio_crear();
+	if (!motor->directorio) {
+		hash_destruir(motor->usuarios);
+		nombres_destruir(motor->nombres);
+		free(motor->particiones);
+		free(motor);
+		return NULL;
+	}
+	motor->cant_particiones = cant_particiones;
+	motor->id_usuario = 0;
+	motor->id_post = 0;
+	motor->hilos_lanzados = 0;
+	motor->iniciado = false;
+	return motor;
+}
+
+bool motor_agregar_usuario(motor_t* motor, const char* nombre_usuario) {
+	if (motor->iniciado) return false;
+	padron_t padron = { motor->nombres, motor->directorio, motor->usuarios, NULL };
+	if (!padron_agregar_usuario(&padron, nombre_usuario, strlen(nombre_usuario), motor->id_usuario)) return false;
+	motor->id_usuario++;
+	return true;
+}
+
+bool motor_iniciar(motor_t* motor) {
+	if (motor->iniciado) return false;
+	if (!directorio_ordenar(motor->directorio)) return false;
+	for (size_t i = 0; i < motor->cant_particiones; i++) {
+		particion_t* particion = &motor->particiones[i];
+		particion->motor = motor;
+		particion->indice = i;
+		particion->procesando = malloc(BUZON_TAM_INICIAL * sizeof(mensaje_t));
+		if (!particion->procesando) return false;
+		particion->tam_procesando = BUZON_TAM_INICIAL;
+		if (!buzon_inicializar(&particion->buzon)) {
+			free(particion->procesando);
+			particion->procesando = NULL;
+			return false;
+		}
+	}
+	if (!repartir_usuarios(motor)) return false;
+	motor->iniciado = true;
+	for (; motor->hilos_lanzados < motor->cant_particiones; motor->hilos_lanzados++) {
+		particion_t* particion = &motor->particiones[motor->hilos_lanzados];
+		if (pthread_create(&particion->hilo, NULL, atender_particion, particion) != 0) return false;
+	}
+	return true;
+}
+
+protocolo_estado_t motor_login(motor_t* motor, sesion_t* sesion, const char* nombre) {
+	if (sesion_ver_usuario(sesion)) return PROTOCOLO_YA_LOGGEADO;
+	usuario_t* usuario = nombre ? hash_obtener(motor->usuarios, nombre) : NULL;
+	if (!usuario) return PROTOCOLO_USUARIO_INEXISTENTE;
+	sesion_login(sesion, usuario);
+	return PROTOCOLO_OK;
+}
+
+protocolo_estado_t motor_logout(motor_t* motor, sesion_t* sesion) {
+	// La sesion es del cliente: cerrarla no necesita a ninguna particion.
+	(void)motor;
+	return sesion_logout(sesion) ? PROTOCOLO_OK : PROTOCOLO_NO_LOGGEADO;
+}
+
+protocolo_estado_t motor_publicar(motor_t* motor, sesion_t* sesion, const char* texto, size_t* id_post) {
+	usuario_t* usuario = sesion_ver_usuario(sesion);
+	if (!usuario) return PROTOCOLO_NO_LOGGEADO;
+	pedido_t pedido;
+	pedido_inicializar(&pedido);
+	pedido.usuario = usuario;
+	pedido.texto = texto ? texto : "";
+	pedido.id_post = __atomic_fetch_add(&motor->id_post, 1, __ATOMIC_RELAXED);
+	protocolo_estado_t estado = pedido_resolver(&pedido, particion_de_id(motor, pedido.id_post), MENSAJE_PUBLICAR);
+	if (estado == PROTOCOLO_OK) *id_post = pedido.id_post;
+	return estado;
+}
+
+protocolo_estado_t motor_ver_siguiente(motor_t* motor, sesion_t* sesion, vista_post_t* vista) {
+	usuario_t* usuario = sesion_ver_usuario(sesion);
+	if (!usuario) return PROTOCOLO_NO_LOGGEADO;
+	pedido_t pedido;
+	pedido_inicializar(&pedido);
+	pedido.usuario = usuario;
+	pedido.vista = vista;
+	return pedido_resolver(&pedido, particion_de_usuario(motor, usuario), MENSAJE_VER_SIGUIENTE);
+}
+
+protocolo_estado_t motor_likear(motor_t* motor, sesion_t* sesion, size_t id_post) {
+	usuario_t* usuario = sesion_ver_usuario(sesion);
+	if (!usuario) return PROTOCOLO_NO_LOGGEADO;
+	pedido_t pedido;
+	pedido_inicializar(&pedido);
+	pedido.usuario = usuario;
+	pedido.id_post = id_post;
+	return pedido_resolver(&pedido, particion_de_id(motor, id_post), MENSAJE_LIKEAR);
+}
+
+protocolo_estado_t motor_ver_likes(motor_t* motor, size_t id_post, bool visitar(size_t, const char*, void*), void* extra) {
+	pedido_t pedido;
+	pedido_inicializar(&pedido);
+	pedido.id_post = id_post;
+	pedido.visitar = visitar;
+	pedido.extra = extra;
+	return pedido_resolver(&pedido, particion_de_id(motor, id_post), MENSAJE_VER_LIKES);
+}
+
+void motor_destruir(motor_t* motor) {
+	// Cada hilo procesa lo que tiene pendiente (las entregas de los ultimos posts) antes de terminar.
+	for (size_t i = 0; i < motor->hilos_lanzados; i++) {
+		buzon_t* buzon = &motor->particiones[i].buzon;
+		pthread_mutex_lock(&buzon->mutex);
+		buzon->terminar = true;
+		pthread_cond_signal(&buzon->hay_mensajes);
+		pthread_mutex_unlock(&buzon->mutex);
+	}
+	for (size_t i = 0; i < motor->hilos_lanzados; i++) pthread_join(motor->particiones[i].hilo, NULL);
+	for (size_t i = 0; i < motor->cant_particiones; i++) {
+		particion_t* particion = &motor->particiones[i];
+		ESTADISTICA(estadisticas_transferir(&estadisticas, &particion->estadisticas));
+		for (size_t j = 0; j < particion->tam_posts; j++) {
+			if (particion->posts[j]) post_destruir(particion->posts[j]);
+		}
+		free(particion->posts);
+		free(particion->usuarios);
+		if (particion->procesando) {
+			free(particion->procesando);
+			buzon_finalizar(&particion->buzon);
+		}
+	}
+	free(motor->particiones);
+	directorio_destruir(motor->directorio);
+	hash_destruir(motor->usuarios);
+	nombres_destruir(motor->nombres);
+	free(motor);
+}
@@ -0,0 +1,114 @@
+#ifndef MOTOR_H
+#define MOTOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "protocolo.h"
+#include "sesion.h"
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Motor de AlgoGram (en modo push) que atiende a varios clientes a la vez usando varios hilos.
+ * Los usuarios se reparten en N particiones por ID (el usuario con ID i es de la particion
+ * i % N), igual que los posts (el post con ID p es de la particion p % N). Cada particion la
+ * atiende un unico hilo, que es el unico que toca los feeds de sus usuarios y los likes de sus
+ * posts, por lo que ninguna estructura mutable necesita locks: cada operacion se envia como
+ * mensaje al buzon de la particion dueña, y las que involucran a varias particiones pasan de
+ * una a otra por mensajes (publicar distribuye el post a todas; ver el feed pide los likes del
+ * post a la particion del post).
+ *
+ * Las operaciones se pueden llamar desde varios hilos a la vez, cada uno con sus sesiones, y
+ * bloquean al que llama hasta tener la respuesta. Publicar responde cuando el post ya esta
+ * guardado y su distribucion encolada en todas las particiones: cualquier operacion pedida
+ * despues la ve, aunque los feeds se actualizan en paralelo.
+ *
+ * El motor es una biblioteca: tp2 atiende a un unico cliente con AlgoGram, y el motor lo usan
+ * bench_motor y estres_motor. Los usuarios se registran igual que en AlgoGram (ver padron.h).
+ *
+ * Si se compila con ESTADISTICAS, cada particion cuenta en los contadores de su hilo, y
+ * motor_destruir los suma a los del hilo que lo destruye. Lo que cuentan los hilos de los
+ * clientes (las busquedas de los nombres) queda en los contadores de cada uno.
+ */
+typedef struct motor motor_t;
+
+// Post visto en un feed. Los textos pertenecen al motor.
+typedef struct vista_post {
+	size_t id;
+	size_t id_posteador;
+	const char* posteador;
+	const char* texto;
+	size_t likes;
+} vista_post_t;
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL MOTOR
+ * *****************************************************************/
+
+/* PRE: Recibe la cantidad de particiones (al menos 1).
+ * POST: Devuelve un motor sin usuarios, todavia sin iniciar, o NULL si no se pudo crear.
+ */
+motor_t* motor_crear(size_t cant_particiones);
+
+/* PRE: Recibe un motor sin iniciar y un nombre de usuario.
+ * POST: Devuelve true si se agrego el usuario, con el siguiente ID (un nombre repetido
+ * reemplaza al usuario anterior, como en algogram_agregar_usuario), en caso contrario false
+ * (tambien si ya se uso el ID COLA_FEED_AFINIDAD_MAX).
+ */
+bool motor_agregar_usuario(motor_t* motor, const char* nombre);
+
+/* PRE: Recibe un motor sin iniciar.
+ * POST: Reparte los usuarios en las particiones y lanza un hilo por particion. Desde ahora no
+ * se pueden agregar usuarios. Devuelve false si no se pudo iniciar (el motor solo se puede
+ * destruir).
+ */
+bool motor_iniciar(motor_t* motor);
+
+/* PRE: Recibe un motor iniciado, una sesion y un nombre de usuario.
+ * POST: Loggea al usuario en la sesion. Devuelve PROTOCOLO_OK, PROTOCOLO_YA_LOGGEADO o
+ * PROTOCOLO_USUARIO_INEXISTENTE.
+ */
+protocolo_estado_t motor_login(motor_t* motor, sesion_t* sesion, const char* nombre);
+
+/* PRE: Recibe un motor iniciado y una sesion.
+ * POST: Cierra la sesion. Devuelve PROTOCOLO_OK o PROTOCOLO_NO_LOGGEADO.
+ */
+protocolo_estado_t motor_logout(motor_t* motor, sesion_t* sesion);
+
+/* PRE: Recibe un motor iniciado, una sesion, el texto de un post y donde guardar su ID.
+ * POST: Publica el post del usuario de la sesion en los feeds de todos los demas. Devuelve
+ * PROTOCOLO_OK (guardando el ID), PROTOCOLO_NO_LOGGEADO o PROTOCOLO_ERROR_INTERNO.
+ */
+protocolo_estado_t motor_publicar(motor_t* motor, sesion_t* sesion, const char* texto, size_t* id_post);
+
+/* PRE: Recibe un motor iniciado, una sesion y donde guardar el post.
+ * POST: Saca el siguiente post del feed del usuario de la sesion. Devuelve PROTOCOLO_OK
+ * (guardando el post y sus likes), PROTOCOLO_NO_LOGGEADO o PROTOCOLO_SIN_POSTS.
+ */
+protocolo_estado_t motor_ver_siguiente(motor_t* motor, sesion_t* sesion, vista_post_t* vista);
+
+/* PRE: Recibe un motor iniciado, una sesion y el ID de un post.
+ * POST: El usuario de la sesion likeo el post. Devuelve PROTOCOLO_OK, PROTOCOLO_NO_LOGGEADO o
+ * PROTOCOLO_POST_INEXISTENTE.
+ */
+protocolo_estado_t motor_likear(motor_t* motor, sesion_t* sesion, size_t id_post);
+
+/* PRE: Recibe un motor iniciado, el ID de un post y una funcion visitar con su extra.
+ * POST: Llama a visitar con el ID y el nombre de cada usuario que likeo el post, en orden
+ * alfabetico, hasta que devuelva false. visitar se ejecuta en el hilo de la particion del post
+ * (mientras el que llamo espera). Devuelve PROTOCOLO_OK, PROTOCOLO_POST_INEXISTENTE,
+ * PROTOCOLO_SIN_LIKES o PROTOCOLO_ERROR_INTERNO.
+ */
+protocolo_estado_t motor_ver_likes(motor_t* motor, size_t id_post, bool visitar(size_t, const char*, void*), void* extra);
+
+/* PRE: Recibe un motor sin operaciones en curso.
+ * POST: Termina los hilos (despues de procesar los mensajes pendientes) y destruye el motor,
+ * con sus usuarios y posts.
+ */
+void motor_destruir(motor_t* motor);
+
+#endif  // MOTOR_H
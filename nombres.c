@@ -0,0 +1,68 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "nombres.h"
+#include "hash.h"
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* La copia canonica es a la vez la clave y el dato del hash, que usa claves externas
+ * para no guardar una segunda copia. El hash la libera como dato al destruirse.
+ */
+struct nombres {
+	hash_t* canonicos;
+};
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA TABLA DE NOMBRES
+ * *****************************************************************/
+
+nombres_t* nombres_crear(void) {
+	nombres_t* nombres = malloc(sizeof(nombres_t));
+	if (!nombres) return NULL;
+	nombres->canonicos = hash_crear_con_opciones(free, HASH_INCREMENTAL | HASH_CLAVES_EXTERNAS);
+	if (!nombres->canonicos) {
+		free(nombres);
+		return NULL;
+	}
+	return nombres;
+}
+
+const char* nombres_internar(nombres_t* nombres, const char* nombre) {
+	return nombres_internar_largo(nombres, nombre, strlen(nombre));
+}
+
+const char* nombres_internar_largo(nombres_t* nombres, const char* nombre, size_t largo) {
+	const char* canonico = hash_obtener_largo(nombres->canonicos, nombre, largo);
+	if (canonico) return canonico;
+	char* copia = strndup(nombre, largo);
+	if (!copia) return NULL;
+	if (!hash_guardar(nombres->canonicos, copia, copia)) {
+		free(copia);
+		return NULL;
+	}
+	return copia;
+}
+
+bool nombres_reservar(nombres_t* nombres, size_t cantidad) {
+	return hash_reservar(nombres->canonicos, cantidad);
+}
+
+const char* nombres_buscar(const nombres_t* nombres, const char* nombre) {
+	return hash_obtener(nombres->canonicos, nombre);
+}
+
+size_t nombres_cantidad(const nombres_t* nombres) {
+	return hash_cantidad(nombres->canonicos);
+}
+
+void nombres_destruir(nombres_t* nombres) {
+	hash_destruir(nombres->canonicos);
+	free(nombres);
+}
@@ -0,0 +1,60 @@
+#ifndef NOMBRES_H
+#define NOMBRES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Tabla de nombres canonicos (interning). Cada nombre distinto se guarda una
+ * unica vez, y todos los que lo internan reciben el mismo puntero, por lo que
+ * dos nombres internados son iguales si y solo si sus punteros son iguales.
+ * Los nombres canonicos viven hasta que se destruye la tabla.
+ */
+typedef struct nombres nombres_t;
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA TABLA DE NOMBRES
+ * *****************************************************************/
+
+// Crea una tabla de nombres vacia.
+nombres_t* nombres_crear(void);
+
+/* PRE: Recibe una tabla previamente creada y un nombre.
+ * POST: Devuelve la copia canonica del nombre, creandola si todavia no existia,
+ * o NULL si no se pudo crear.
+ */
+const char* nombres_internar(nombres_t* nombres, const char* nombre);
+
+/* PRE: Recibe una tabla previamente creada y un nombre de largo bytes, que no
+ * necesita terminar en '\0'.
+ * POST: Igual que nombres_internar; la copia canonica si termina en '\0'.
+ */
+const char* nombres_internar_largo(nombres_t* nombres, const char* nombre, size_t largo);
+
+/* PRE: Recibe una tabla previamente creada y una cantidad de nombres.
+ * POST: Devuelve true si la tabla quedo con lugar para esa cantidad de nombres
+ * sin redimensionarse, en caso contrario false.
+ */
+bool nombres_reservar(nombres_t* nombres, size_t cantidad);
+
+/* PRE: Recibe una tabla previamente creada y un nombre.
+ * POST: Devuelve la copia canonica del nombre, o NULL si no fue internado.
+ */
+const char* nombres_buscar(const nombres_t* nombres, const char* nombre);
+
+/* PRE: Recibe una tabla previamente creada.
+ * POST: Devuelve la cantidad de nombres distintos internados.
+ */
+size_t nombres_cantidad(const nombres_t* nombres);
+
+/* PRE: Recibe una tabla previamente creada.
+ * POST: Se destruyo la tabla y todas las copias canonicas.
+ */
+void nombres_destruir(nombres_t* nombres);
+
+#endif  // NOMBRES_H
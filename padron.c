@@ -0,0 +1,41 @@
+#include "padron.h"
+#include "usuario.h"
+#include "cola_feed.h"
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL PADRON
+ * *****************************************************************/
+
+bool padron_agregar_usuario(const padron_t* padron, const char* nombre_usuario, size_t largo, size_t id) {
+	// La afinidad es la distancia entre dos IDs: con IDs acotados, todo post entra en la cola del feed.
+	if (id > COLA_FEED_AFINIDAD_MAX) return false;
+	if (padron->repartidor) repartidor_esperar(padron->repartidor);
+	const char* nombre = nombres_internar_largo(padron->nombres, nombre_usuario, largo);
+	if (!nombre) return false;
+	usuario_t* usuario = usuario_crear(nombre, id);
+	if (!usuario) return false;
+	if (!directorio_agregar(padron->directorio, id, nombre)) {
+		usuario_destruir(usuario);
+		return false;
+	}
+	if (padron->repartidor && !repartidor_agregar_usuario(padron->repartidor, usuario)) {
+		directorio_quitar(padron->directorio, id);
+		usuario_destruir(usuario);
+		return false;
+	}
+	// Un nombre repetido reemplaza al usuario anterior, cuyo ID deja de estar vigente.
+	usuario_t* anterior = hash_obtener(padron->usuarios, nombre);
+	size_t id_anterior = anterior ? usuario_obtener_id(anterior) : 0;
+	if (!hash_guardar(padron->usuarios, nombre, usuario)) {
+		if (padron->repartidor) repartidor_quitar_usuario(padron->repartidor, id);
+		directorio_quitar(padron->directorio, id);
+		usuario_destruir(usuario);
+		return false;
+	}
+	if (anterior) {
+		directorio_quitar(padron->directorio, id_anterior);
+		if (padron->repartidor) repartidor_quitar_usuario(padron->repartidor, id_anterior);
+	}
+	return true;
+}
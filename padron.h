@@ -0,0 +1,41 @@
+#ifndef PADRON_H
+#define PADRON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "hash.h"
+#include "nombres.h"
+#include "directorio.h"
+#include "reparto.h"
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Padron de usuarios: las estructuras en las que AlgoGram y el motor registran a cada usuario.
+ * El padron solo agrupa los punteros; las estructuras son de quien lo arma.
+ */
+typedef struct padron {
+	nombres_t* nombres;
+	directorio_t* directorio;
+	hash_t* usuarios;          // Nombre canonico -> usuario, con claves externas. Destruye al reemplazado.
+	repartidor_t* repartidor;  // Repartidor en paralelo en el que se registran los usuarios, o NULL.
+} padron_t;
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL PADRON
+ * *****************************************************************/
+
+/* PRE: Recibe un padron, un nombre de usuario de largo bytes (no necesita terminar en '\0') y
+ * un ID que no este vigente.
+ * POST: Devuelve true si se creo el usuario con ese ID y quedo registrado en todas las
+ * estructuras del padron, en caso contrario false (tambien si el ID supera
+ * COLA_FEED_AFINIDAD_MAX), sin cambiar ninguna salvo la tabla de nombres. Un nombre repetido
+ * reemplaza al usuario anterior, cuyo ID deja de estar vigente.
+ */
+bool padron_agregar_usuario(const padron_t* padron, const char* nombre_usuario, size_t largo, size_t id);
+
+#endif  // PADRON_H
@@ -0,0 +1,105 @@
+#include <stdlib.h>
+#include <stdbool.h>
+
+#include "pool.h"
+
+#define ELEMENTOS_BLOQUE_INICIAL 16
+#define ELEMENTOS_BLOQUE_MAX 4096
+#define FACTOR_CRECIMIENTO 2
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+// Los elementos libres se encadenan reutilizando su propia memoria.
+typedef struct libre {
+	struct libre* sig;
+} libre_t;
+
+// Cada bloque guarda el puntero al anterior antes de sus elementos.
+typedef struct bloque {
+	struct bloque* ant;
+} bloque_t;
+
+struct pool {
+	size_t tam_elemento;
+	libre_t* libres;
+	bloque_t* bloques;
+	char* sin_usar;         // Proximo elemento nunca entregado del ultimo bloque.
+	size_t cant_sin_usar;
+	size_t elementos_bloque;
+};
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+/* PRE: Recibe un tamaño.
+ * POST: Devuelve el tamaño redondeado al multiplo de la alineacion de un puntero.
+ */
+size_t pool_alinear(size_t tam) {
+	size_t alineacion = sizeof(void*);
+	return (tam + alineacion - 1) / alineacion * alineacion;
+}
+
+/* PRE: Recibe un pool sin elementos disponibles.
+ * POST: Devuelve true si se pudo agregar un bloque nuevo, en caso contrario false.
+ * Cada bloque es el doble del anterior, hasta ELEMENTOS_BLOQUE_MAX elementos.
+ */
+bool pool_agregar_bloque(pool_t* pool) {
+	bloque_t* bloque = malloc(pool_alinear(sizeof(bloque_t)) + pool->elementos_bloque * pool->tam_elemento);
+	if (!bloque) return false;
+	bloque->ant = pool->bloques;
+	pool->bloques = bloque;
+	pool->sin_usar = (char*)bloque + pool_alinear(sizeof(bloque_t));
+	pool->cant_sin_usar = pool->elementos_bloque;
+	if (pool->elementos_bloque < ELEMENTOS_BLOQUE_MAX) pool->elementos_bloque *= FACTOR_CRECIMIENTO;
+	return true;
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL POOL
+ * *****************************************************************/
+
+pool_t* pool_crear(size_t tam_elemento) {
+	pool_t* pool = malloc(sizeof(pool_t));
+	if (!pool) return NULL;
+	pool->tam_elemento = pool_alinear(tam_elemento < sizeof(libre_t) ? sizeof(libre_t) : tam_elemento);
+	pool->libres = NULL;
+	pool->bloques = NULL;
+	pool->sin_usar = NULL;
+	pool->cant_sin_usar = 0;
+	pool->elementos_bloque = ELEMENTOS_BLOQUE_INICIAL;
+	return pool;
+}
+
+void* pool_pedir(pool_t* pool) {
+	if (pool->libres) {
+		libre_t* elemento = pool->libres;
+		pool->libres = elemento->sig;
+		return elemento;
+	}
+	if (!pool->cant_sin_usar && !pool_agregar_bloque(pool)) return NULL;
+	void* elemento = pool->sin_usar;
+	pool->sin_usar += pool->tam_elemento;
+	pool->cant_sin_usar--;
+	return elemento;
+}
+
+void pool_devolver(pool_t* pool, void* elemento) {
+	libre_t* libre = elemento;
+	libre->sig = pool->libres;
+	pool->libres = libre;
+}
+
+void pool_destruir(pool_t* pool) {
+	while (pool->bloques) {
+		bloque_t* ant = pool->bloques->ant;
+		free(pool->bloques);
+		pool->bloques = ant;
+	}
+	free(pool);
+}
@@ -0,0 +1,42 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Pool de elementos de tamaño fijo. Los elementos se piden en bloques (slabs)
+ * contiguos, y los liberados se reutilizan en los siguientes pedidos. Destruir
+ * el pool libera todos los bloques de una vez, sin recorrer los elementos.
+ */
+typedef struct pool pool_t;
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL POOL
+ * *****************************************************************/
+
+/* PRE: Recibe el tamaño de los elementos que se van a pedir.
+ * POST: Devuelve un pool vacio. No se pide memoria para los elementos hasta el primer pedido.
+ */
+pool_t* pool_crear(size_t tam_elemento);
+
+/* PRE: Recibe un pool previamente creado.
+ * POST: Devuelve un elemento sin inicializar, o NULL si no se pudo obtener memoria.
+ */
+void* pool_pedir(pool_t* pool);
+
+/* PRE: Recibe un pool previamente creado y un elemento obtenido con pool_pedir de ese pool.
+ * POST: El elemento vuelve al pool para ser reutilizado.
+ */
+void pool_devolver(pool_t* pool, void* elemento);
+
+/* PRE: Recibe un pool previamente creado.
+ * POST: Se liberaron todos los bloques del pool, incluidos los elementos que no se devolvieron.
+ */
+void pool_destruir(pool_t* pool);
+
+#endif  // POOL_H
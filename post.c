@@ -1,9 +1,8 @@
 #include <stdlib.h>
-#include <stdio.h>
 #include <string.h>
 
 #include "post.h"
-#include "abb.h"
+#include "likes.h"
 
 /* ******************************************************************
  *                DEFINICION DE LOS TIPOS DE DATOS
@@ -11,9 +10,10 @@
 
 struct post {
 	size_t id;
-	char* posteador;
+	const char* posteador;
+	size_t id_posteador;
 	char* texto;
-	abb_t* likes;
+	likes_t* likes;
 };
 
 
@@ -21,12 +21,53 @@ struct post {
  *                    FUNCIONES AUXILIARES
  * *****************************************************************/
 
-/* PRE: Recibe el nombre del usuario a imprimir. Como es la funcion visitar del iterador in order
- * del ABB, se desprecian los otros dos parametros.
- * POST: Se imprimio el usuario que le dio like al post, pasado por parametro.
+/* PRE: Recibe una salida y el nombre de un usuario.
+ * POST: Se escribio el usuario en la salida, como una linea del listado de likes.
  */
-bool imprimir_likes(const char* usuario, void* dato, void* extra) {
-	fprintf(stdout, "\t%s\n", usuario);
+void escribir_like(salida_t* salida, const char* usuario) {
+	salida_texto(salida, "\t");
+	salida_texto(salida, usuario);
+	salida_texto(salida, "\n");
+}
+
+/* PRE: Recibe el ID y el nombre del usuario a imprimir y la salida, como funcion visitar del
+ * recorrido de los likes (el ID no se usa).
+ * POST: Se escribio el usuario que le dio like al post, pasado por parametro.
+ */
+bool imprimir_likes(size_t id, const char* usuario, void* salida) {
+	(void)id;
+	escribir_like(salida, usuario);
+	return true;
+}
+
+/* PRE: Recibe una salida y un post.
+ * POST: Se escribio el encabezado del listado de likes del post.
+ */
+void escribir_cantidad_likes(salida_t* salida, post_t* post) {
+	salida_texto(salida, "El post tiene ");
+	salida_numero(salida, post_cantidad_likes(post));
+	salida_texto(salida, " likes:\n");
+}
+
+typedef struct pagina_likes {
+	salida_t* salida;
+	size_t restantes;
+	const char* siguiente;
+} pagina_likes_t;
+
+/* PRE: Recibe el ID y el nombre del usuario a imprimir y la pagina que se esta mostrando.
+ * POST: Si quedan lugares en la pagina, imprime el usuario y devuelve true. Si no, guarda el
+ * usuario como el siguiente a mostrar y devuelve false para cortar el recorrido.
+ */
+bool imprimir_likes_pagina(size_t id, const char* usuario, void* extra) {
+	(void)id;
+	pagina_likes_t* pagina = extra;
+	if (!pagina->restantes) {
+		pagina->siguiente = usuario;
+		return false;
+	}
+	escribir_like(pagina->salida, usuario);
+	pagina->restantes--;
 	return true;
 }
 
@@ -35,10 +76,10 @@ bool imprimir_likes(const char* usuario, void* dato, void* extra) {
  *                    PRIMITIVAS DE POST
  * *****************************************************************/
 
-post_t* post_crear(char* nombre_usuario, char* texto, size_t id) {
+post_t* post_crear(const char* nombre_usuario, size_t id_usuario, char* texto, size_t id) {
 	post_t* post = malloc(sizeof(post_t));
 	if (!post) return NULL;
-	abb_t* likes = abb_crear(strcmp, NULL);
+	likes_t* likes = likes_crear();
 	if (!likes) {
 		free(post);
 		return NULL;
@@ -46,6 +87,7 @@ post_t* post_crear(char* nombre_usuario, char* texto, size_t id) {
 	post->likes = likes;
 	post->id = id;
 	post->posteador = nombre_usuario;
+	post->id_posteador = id_usuario;
 	post->texto = texto;
 	return post;
 }
@@ -54,34 +96,86 @@ size_t post_ver_id(post_t* post) {
 	return post->id;
 }
 
-char* post_ver_posteador(post_t* post) {
+const char* post_ver_posteador(post_t* post) {
 	return post->posteador;
 }
 
+size_t post_ver_id_posteador(post_t* post) {
+	return post->id_posteador;
+}
+
 char* post_ver_texto(post_t* post) {
 	return post->texto;
 }
 
-bool post_likear(post_t* post, char* usuario) {
-	return abb_guardar(post->likes, usuario, NULL);
+bool post_likear(post_t* post, size_t id_usuario) {
+	return likes_agregar(post->likes, id_usuario);
 }
 
-bool post_esta_likeado(post_t* post, char* usuario) {
-	return abb_pertenece(post->likes, usuario);
+bool post_esta_likeado(post_t* post, size_t id_usuario) {
+	return likes_contiene(post->likes, id_usuario);
 }
 
 size_t post_cantidad_likes(post_t* post) {
-	return abb_cantidad(post->likes);
+	return likes_cantidad(post->likes);
+}
+
+bool post_recorrer_likes(post_t* post, directorio_t* directorio, bool visitar(size_t, const char*, void*), void* extra) {
+	return likes_recorrer(post->likes, directorio, NULL, visitar, extra);
 }
 
-void post_ver_likes(post_t* post) {
-	fprintf(stdout, "El post tiene %zu likes:\n", post_cantidad_likes(post));
-	abb_in_order(post->likes, imprimir_likes, NULL);
+void post_ver_likes(post_t* post, directorio_t* directorio, salida_t* salida) {
+	escribir_cantidad_likes(salida, post);
+	likes_recorrer(post->likes, directorio, NULL, imprimir_likes, salida);
+}
+
+void post_ver_likes_desde(post_t* post, directorio_t* directorio, const char* desde, size_t limite, salida_t* salida) {
+	pagina_likes_t pagina = { salida, limite, NULL };
+	escribir_cantidad_likes(salida, post);
+	likes_recorrer(post->likes, directorio, desde, imprimir_likes_pagina, &pagina);
+	if (pagina.siguiente) {
+		salida_texto(salida, "Siguiente: ");
+		salida_texto(salida, pagina.siguiente);
+		salida_texto(salida, "\n");
+	}
+}
+
+void post_volcar(post_t* post, salida_t* salida) {
+	size_t largo = strlen(post->texto);
+	salida_entero(salida, post->id_posteador, INSTANTANEA_TAM_U64);
+	salida_entero(salida, largo, INSTANTANEA_TAM_U32);
+	salida_bytes(salida, post->texto, largo);
+	likes_volcar(post->likes, salida);
+}
+
+post_t* post_restaurar(lector_instantanea_t* lector, size_t id, const directorio_t* directorio) {
+	uint64_t id_posteador, largo;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, &id_posteador)) return NULL;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U32, &largo)) return NULL;
+	const char* nombre = directorio_nombre(directorio, id_posteador);
+	const char* datos = instantanea_leer_arreglo(lector, largo, 1);
+	if (!nombre || !datos) return NULL;
+	char* texto = malloc(largo + 1);
+	post_t* post = malloc(sizeof(post_t));
+	likes_t* likes = likes_restaurar(lector);
+	if (!texto || !post || !likes) {
+		free(texto);
+		free(post);
+		if (likes) likes_destruir(likes);
+		return NULL;
+	}
+	memcpy(texto, datos, largo);
+	texto[largo] = '\0';
+	post->id = id;
+	post->posteador = nombre;
+	post->id_posteador = id_posteador;
+	post->texto = texto;
+	post->likes = likes;
+	return post;
 }
 
 void post_destruir(post_t* post) {
-	abb_destruir(post->likes);
+	likes_destruir(post->likes);
 	free(post->texto);
-	free(post->posteador);
 	free(post);
 }
@@ -4,6 +4,10 @@
 #include <stdlib.h>
 #include <stdbool.h>
 
+#include "directorio.h"
+#include "salida.h"
+#include "instantanea.h"
+
 
 /* ******************************************************************
  *                DEFINICION DE LOS TIPOS DE DATOS
@@ -15,10 +19,12 @@ typedef struct post post_t;
  *                    PRIMITIVAS DE POST
  * *****************************************************************/
 
-/* PRE: Recibe el nombre de un usuario, el texto del post y el ID que va a tener el post.
- * POST: Devuelve el post que fue creado con dichos parametros.
+/* PRE: Recibe el nombre internado de un usuario (ver nombres.h) y su ID, el texto del post y
+ * el ID que va a tener el post.
+ * POST: Devuelve el post que fue creado con dichos parametros. El post pasa a ser dueño del
+ * texto, pero no del nombre.
  */
-post_t* post_crear(char* nombre_usuario, char* texto, size_t id);
+post_t* post_crear(const char* nombre_usuario, size_t id_usuario, char* texto, size_t id);
 
 /* PRE: Recibe un post previamente creado.
  * POST: Devuelve el ID del post.
@@ -28,32 +34,65 @@ size_t post_ver_id(post_t* post);
 /* PRE: Recibe un post previamente creado.
  * POST: Devuelve el nombre del usuario que posteo ese post.
  */
-char* post_ver_posteador(post_t* post);
+const char* post_ver_posteador(post_t* post);
+
+/* PRE: Recibe un post previamente creado.
+ * POST: Devuelve el ID del usuario que posteo ese post.
+ */
+size_t post_ver_id_posteador(post_t* post);
 
 /* PRE: Recibe un post previamente creado.
  * POST: Devuelve el contenido del post.
  */
 char* post_ver_texto(post_t* post);
 
-/* PRE: Recibe un post previamente creado y un nombre de usuario.
+/* PRE: Recibe un post previamente creado y el ID de un usuario.
  * POST: Devuelve true si ese usuario pudo likear el post, o false en caso contrario.
  */
-bool post_likear(post_t* post, char* usuario);
+bool post_likear(post_t* post, size_t id_usuario);
 
-/* PRE: Recibe un post previamente creado y un nombre de usuario.
+/* PRE: Recibe un post previamente creado y el ID de un usuario.
  * POST: Devuelve true si el post esta likeado por ese usuario, en caso contrario false.
  */
-bool post_esta_likeado(post_t* post, char* usuario);
+bool post_esta_likeado(post_t* post, size_t id_usuario);
 
 /* PRE: Recibe un post previamente creado.
  * POST: Devuelve la cantidad de likes que tiene el post.
  */
 size_t post_cantidad_likes(post_t* post);
 
-/* PRE: Recibe un post previamente creado.
- * POST: Imprime por pantalla los usuarios que likearon ese post, en orden alfabetico.
+/* PRE: Recibe un post previamente creado, el directorio con los nombres de los usuarios, una
+ * funcion visitar y un dato extra para visitar.
+ * POST: Aplica visitar al ID y al nombre de cada usuario que likeo el post, en orden alfabetico,
+ * hasta que visitar devuelva false. Devuelve false si no se pudo hacer el recorrido.
+ */
+bool post_recorrer_likes(post_t* post, directorio_t* directorio, bool visitar(size_t, const char*, void*), void* extra);
+
+/* PRE: Recibe un post previamente creado, el directorio con los nombres de los usuarios y una salida.
+ * POST: Escribe en la salida los usuarios que likearon ese post, en orden alfabetico.
+ */
+void post_ver_likes(post_t* post, directorio_t* directorio, salida_t* salida);
+
+/* PRE: Recibe un post previamente creado, el directorio con los nombres de los usuarios, un
+ * nombre desde el cual mostrar, la cantidad maxima de usuarios a mostrar y una salida.
+ * POST: Escribe en la salida, en orden alfabetico, hasta limite usuarios que likearon el post
+ * cuyo nombre es mayor o igual a desde. Si quedan mas, escribe el nombre del siguiente, que
+ * sirve como desde para pedir la pagina que sigue.
+ */
+void post_ver_likes_desde(post_t* post, directorio_t* directorio, const char* desde, size_t limite, salida_t* salida);
+
+/* PRE: Recibe un post previamente creado y la salida de una instantanea.
+ * POST: Se escribio el post: ID del posteador u64, largo del texto u32, el texto y sus
+ * likes (ver likes_volcar). El ID del post es su posicion en la instantanea.
+ */
+void post_volcar(post_t* post, salida_t* salida);
+
+/* PRE: Recibe un lector posicionado donde se escribio un post con post_volcar, el ID del post
+ * y el directorio con los usuarios ya restaurados.
+ * POST: Devuelve el post restaurado, o NULL si la instantanea no tiene un post valido (o su
+ * posteador no esta en el directorio) o no hay memoria.
  */
-void post_ver_likes(post_t* post);
+post_t* post_restaurar(lector_instantanea_t* lector, size_t id, const directorio_t* directorio);
 
 /* PRE: Recibe un post previamente creado.
  * POST: Destruye el post.
@@ -0,0 +1,61 @@
+#ifndef PROTOCOLO_H
+#define PROTOCOLO_H
+
+
+/* ******************************************************************
+ *                    PROTOCOLO BINARIO DE ALGOGRAM
+ * *****************************************************************/
+
+/* Alternativa al protocolo de texto (se activa con --binario). Todos los enteros son
+ * sin signo y little-endian: u8, u32 y u64 ocupan 1, 4 y 8 bytes.
+ *
+ * Pedido:  u8 operacion, seguido de sus argumentos.
+ *   PROTOCOLO_LOGIN               u32 id_usuario
+ *   PROTOCOLO_LOGOUT              -
+ *   PROTOCOLO_PUBLICAR            u32 largo, largo bytes de texto (hasta PROTOCOLO_LARGO_MAX)
+ *   PROTOCOLO_VER_SIGUIENTE_FEED  -
+ *   PROTOCOLO_LIKEAR_POST         u64 id_post
+ *   PROTOCOLO_MOSTRAR_LIKES       u64 id_post
+ *
+ * Respuesta: u8 estado y, solo si el estado es PROTOCOLO_OK, los datos de la operacion.
+ *   PROTOCOLO_PUBLICAR            u64 id_post
+ *   PROTOCOLO_VER_SIGUIENTE_FEED  u64 id_post, u32 id_posteador, u64 likes, u32 largo, texto
+ *   PROTOCOLO_MOSTRAR_LIKES       u64 cantidad, cantidad x u32 id_usuario (en orden alfabetico)
+ *   (las demas no tienen datos)
+ *
+ * El ID de cada usuario es su numero de linea en el archivo de usuarios, empezando en 0. Ante
+ * una operacion desconocida se responde PROTOCOLO_OPERACION_INVALIDA y se deja de leer, ya que
+ * no hay forma de saber donde empieza el pedido siguiente. Lo mismo pasa con un texto de mas de
+ * PROTOCOLO_LARGO_MAX bytes: se responde PROTOCOLO_TEXTO_MUY_LARGO sin leerlo, para que un
+ * largo arbitrario no obligue a reservar hasta 4 GiB.
+ */
+
+typedef enum {
+	PROTOCOLO_LOGIN = 1,
+	PROTOCOLO_LOGOUT,
+	PROTOCOLO_PUBLICAR,
+	PROTOCOLO_VER_SIGUIENTE_FEED,
+	PROTOCOLO_LIKEAR_POST,
+	PROTOCOLO_MOSTRAR_LIKES,
+} protocolo_operacion_t;
+
+typedef enum {
+	PROTOCOLO_OK = 0,
+	PROTOCOLO_YA_LOGGEADO,
+	PROTOCOLO_NO_LOGGEADO,
+	PROTOCOLO_USUARIO_INEXISTENTE,
+	PROTOCOLO_POST_INEXISTENTE,
+	PROTOCOLO_SIN_POSTS,
+	PROTOCOLO_SIN_LIKES,
+	PROTOCOLO_ERROR_INTERNO,
+	PROTOCOLO_OPERACION_INVALIDA,
+	PROTOCOLO_TEXTO_MUY_LARGO,
+} protocolo_estado_t;
+
+#define PROTOCOLO_TAM_U8 1
+#define PROTOCOLO_TAM_U32 4
+#define PROTOCOLO_TAM_U64 8
+
+#define PROTOCOLO_LARGO_MAX (1 << 16)
+
+#endif  // PROTOCOLO_H
@@ -0,0 +1,191 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "reparto.h"
+#include "estadisticas.h"
+
+#define TAM_INICIAL 64
+#define FACTOR_REDIMENSION 2
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+typedef struct trabajador {
+	struct repartidor* repartidor;
+	size_t indice;
+	pthread_t hilo;
+	ESTADISTICA(estadisticas_t estadisticas;)  // Las del hilo, hasta que las junte repartidor_esperar.
+} trabajador_t;
+
+struct repartidor {
+	usuario_t** usuarios;  // Por ID (NULL si el ID no esta vigente). Solo cambia sin reparto en curso.
+	size_t cant_usuarios;
+	size_t tam_usuarios;
+	trabajador_t* trabajadores;
+	size_t cant_hilos;
+	size_t hilos_lanzados;
+	bool relajado;
+	pthread_mutex_t mutex;   // Protege los campos de aca para abajo.
+	pthread_cond_t hay_trabajo;
+	pthread_cond_t terminado;
+	post_t* post;            // El que se esta repartiendo.
+	size_t generacion;       // Cantidad de repartos pedidos, para que cada hilo sepa si hay uno nuevo.
+	size_t pendientes;       // Hilos que todavia no terminaron su rango del reparto en curso.
+	bool terminar;
+};
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+// Devuelve la afinidad entre el dueño de un feed y el posteador (la distancia entre sus IDs).
+size_t afinidad_reparto(size_t id_usuario, size_t id_posteador) {
+	return id_usuario > id_posteador ? id_usuario - id_posteador : id_posteador - id_usuario;
+}
+
+/* PRE: Recibe un rango del arreglo de usuarios y un post.
+ * POST: Encolo el post en el feed de cada usuario del rango, salvo el posteador.
+ */
+void repartir_rango(usuario_t** usuarios, size_t cant, post_t* post) {
+	size_t id_posteador = post_ver_id_posteador(post);
+	for (size_t i = 0; i < cant; i++) {
+		usuario_t* usuario = usuarios[i];
+		if (!usuario) continue;
+		size_t id_usuario = usuario_obtener_id(usuario);
+		if (id_usuario != id_posteador) usuario_guardar_feed(usuario, post, afinidad_reparto(id_usuario, id_posteador));
+	}
+}
+
+// Funcion de cada hilo: reparte su rango de usuarios en cada post nuevo, hasta que se destruya el repartidor.
+void* atender_reparto(void* extra) {
+	trabajador_t* trabajador = extra;
+	repartidor_t* repartidor = trabajador->repartidor;
+	size_t generacion = 0;
+	pthread_mutex_lock(&repartidor->mutex);
+	while (true) {
+		while (repartidor->generacion == generacion && !repartidor->terminar) pthread_cond_wait(&repartidor->hay_trabajo, &repartidor->mutex);
+		if (repartidor->terminar) break;
+		generacion = repartidor->generacion;
+		post_t* post = repartidor->post;
+		pthread_mutex_unlock(&repartidor->mutex);
+
+		size_t cant = repartidor->cant_usuarios, hilos = repartidor->cant_hilos;
+		size_t desde = cant * trabajador->indice / hilos, hasta = cant * (trabajador->indice + 1) / hilos;
+		repartir_rango(repartidor->usuarios + desde, hasta - desde, post);
+		ESTADISTICA(estadisticas_transferir(&trabajador->estadisticas, &estadisticas));
+
+		pthread_mutex_lock(&repartidor->mutex);
+		if (--repartidor->pendientes == 0) pthread_cond_signal(&repartidor->terminado);
+	}
+	pthread_mutex_unlock(&repartidor->mutex);
+	return NULL;
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL REPARTIDOR
+ * *****************************************************************/
+
+repartidor_t* repartidor_crear(size_t cant_hilos, bool relajado) {
+	if (!cant_hilos) return NULL;
+	repartidor_t* repartidor = malloc(sizeof(repartidor_t));
+	if (!repartidor) return NULL;
+	repartidor->usuarios = calloc(TAM_INICIAL, sizeof(usuario_t*));
+	repartidor->trabajadores = calloc(cant_hilos, sizeof(trabajador_t));
+	if (!repartidor->usuarios || !repartidor->trabajadores) {
+		free(repartidor->usuarios);
+		free(repartidor->trabajadores);
+		free(repartidor);
+		return NULL;
+	}
+	pthread_mutex_init(&repartidor->mutex, NULL);
+	pthread_cond_init(&repartidor->hay_trabajo, NULL);
+	pthread_cond_init(&repartidor->terminado, NULL);
+	repartidor->cant_usuarios = 0;
+	repartidor->tam_usuarios = TAM_INICIAL;
+	repartidor->cant_hilos = cant_hilos;
+	repartidor->hilos_lanzados = 0;
+	repartidor->relajado = relajado;
+	repartidor->post = NULL;
+	repartidor->generacion = 0;
+	repartidor->pendientes = 0;
+	repartidor->terminar = false;
+	for (; repartidor->hilos_lanzados < cant_hilos; repartidor->hilos_lanzados++) {
+		trabajador_t* trabajador = &repartidor->trabajadores[repartidor->hilos_lanzados];
+		trabajador->repartidor = repartidor;
+		trabajador->indice = repartidor->hilos_lanzados;
+		if (pthread_create(&trabajador->hilo, NULL, atender_reparto, trabajador) != 0) {
+			repartidor_destruir(repartidor);
+			return NULL;
+		}
+	}
+	return repartidor;
+}
+
+bool repartidor_agregar_usuario(repartidor_t* repartidor, usuario_t* usuario) {
+	size_t id = usuario_obtener_id(usuario);
+	if (id >= repartidor->tam_usuarios) {
+		size_t tam_nuevo = repartidor->tam_usuarios;
+		while (tam_nuevo <= id) tam_nuevo *= FACTOR_REDIMENSION;
+		usuario_t** usuarios = realloc(repartidor->usuarios, tam_nuevo * sizeof(usuario_t*));
+		if (!usuarios) return false;
+		memset(usuarios + repartidor->tam_usuarios, 0, (tam_nuevo - repartidor->tam_usuarios) * sizeof(usuario_t*));
+		repartidor->usuarios = usuarios;
+		repartidor->tam_usuarios = tam_nuevo;
+	}
+	repartidor->usuarios[id] = usuario;
+	if (id >= repartidor->cant_usuarios) repartidor->cant_usuarios = id + 1;
+	return true;
+}
+
+void repartidor_quitar_usuario(repartidor_t* repartidor, size_t id) {
+	if (id < repartidor->cant_usuarios) repartidor->usuarios[id] = NULL;
+}
+
+void repartidor_publicar(repartidor_t* repartidor, post_t* post) {
+	repartidor_esperar(repartidor);
+	if (repartidor->cant_usuarios < REPARTO_MINIMO_USUARIOS) {
+		repartir_rango(repartidor->usuarios, repartidor->cant_usuarios, post);
+		return;
+	}
+	pthread_mutex_lock(&repartidor->mutex);
+	repartidor->post = post;
+	repartidor->pendientes = repartidor->cant_hilos;
+	repartidor->generacion++;
+	pthread_cond_broadcast(&repartidor->hay_trabajo);
+	pthread_mutex_unlock(&repartidor->mutex);
+	if (!repartidor->relajado) repartidor_esperar(repartidor);
+}
+
+void repartidor_esperar(repartidor_t* repartidor) {
+	pthread_mutex_lock(&repartidor->mutex);
+	while (repartidor->pendientes) pthread_cond_wait(&repartidor->terminado, &repartidor->mutex);
+	// Sin reparto en curso los hilos no tocan sus contadores: pasan a los del que espera.
+#ifdef ESTADISTICAS
+	for (size_t i = 0; i < repartidor->hilos_lanzados; i++) {
+		estadisticas_transferir(&estadisticas, &repartidor->trabajadores[i].estadisticas);
+	}
+#endif
+	pthread_mutex_unlock(&repartidor->mutex);
+}
+
+void repartidor_destruir(repartidor_t* repartidor) {
+	repartidor_esperar(repartidor);
+	pthread_mutex_lock(&repartidor->mutex);
+	repartidor->terminar = true;
+	pthread_cond_broadcast(&repartidor->hay_trabajo);
+	pthread_mutex_unlock(&repartidor->mutex);
+	for (size_t i = 0; i < repartidor->hilos_lanzados; i++) pthread_join(repartidor->trabajadores[i].hilo, NULL);
+	pthread_cond_destroy(&repartidor->terminado);
+	pthread_cond_destroy(&repartidor->hay_trabajo);
+	pthread_mutex_destroy(&repartidor->mutex);
+	free(repartidor->trabajadores);
+	free(repartidor->usuarios);
+	free(repartidor);
+}
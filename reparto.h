@@ -0,0 +1,72 @@
+#ifndef REPARTO_H
+#define REPARTO_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "usuario.h"
+#include "post.h"
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Reparto en paralelo de los posts del modo push: un grupo de hilos encola cada post en los
+ * feeds de todos los usuarios, y cada hilo se ocupa de un rango fijo de IDs, por lo que nunca
+ * hay dos hilos tocando el mismo feed.
+ *
+ * En modo sincronico, repartidor_publicar vuelve cuando el post ya esta en todos los feeds. En
+ * modo relajado vuelve enseguida, y el reparto sigue mientras se atiende el resto del comando;
+ * antes de leer un feed, o de agregar o quitar usuarios, hay que llamar a repartidor_esperar.
+ * Hay a lo sumo un post repartiendose: el siguiente espera a que termine el anterior.
+ *
+ * Si se compila con ESTADISTICAS, cada hilo cuenta en sus propios contadores, y
+ * repartidor_esperar los suma a los del hilo que espera.
+ */
+typedef struct repartidor repartidor_t;
+
+// Con menos usuarios, el reparto lo hace el hilo que publica: despertar a los demas cuesta mas.
+#ifndef REPARTO_MINIMO_USUARIOS
+#define REPARTO_MINIMO_USUARIOS 4096
+#endif
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DEL REPARTIDOR
+ * *****************************************************************/
+
+/* PRE: Recibe la cantidad de hilos (al menos 1) y si el reparto es relajado.
+ * POST: Devuelve un repartidor sin usuarios, con sus hilos esperando, o NULL si no se pudo crear.
+ */
+repartidor_t* repartidor_crear(size_t cant_hilos, bool relajado);
+
+/* PRE: Recibe un repartidor sin reparto en curso y un usuario.
+ * POST: Devuelve true si el usuario queda registrado con su ID (reemplazando al que lo tuviera),
+ * o false si no hay memoria. El repartidor no es dueño del usuario.
+ */
+bool repartidor_agregar_usuario(repartidor_t* repartidor, usuario_t* usuario);
+
+/* PRE: Recibe un repartidor sin reparto en curso y el ID de un usuario.
+ * POST: El usuario con ese ID ya no recibe posts.
+ */
+void repartidor_quitar_usuario(repartidor_t* repartidor, size_t id);
+
+/* PRE: Recibe un repartidor y un post que sigue existiendo al menos hasta repartidor_esperar.
+ * POST: Encola el post en el feed de cada usuario registrado salvo el posteador, con su
+ * afinidad. En modo relajado puede volver antes de terminar. Si no hay memoria para algun
+ * feed, ese usuario no lo va a ver.
+ */
+void repartidor_publicar(repartidor_t* repartidor, post_t* post);
+
+/* PRE: Recibe un repartidor.
+ * POST: Termino el reparto en curso, si habia uno.
+ */
+void repartidor_esperar(repartidor_t* repartidor);
+
+/* PRE: Recibe un repartidor.
+ * POST: Termina el reparto en curso y los hilos, y destruye el repartidor (no los usuarios).
+ */
+void repartidor_destruir(repartidor_t* repartidor);
+
+#endif  // REPARTO_H
@@ -0,0 +1,141 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "salida.h"
+
+#define TAM_BUFFER (64 * 1024)
+#define DIGITOS_MAX 20  // Digitos decimales del mayor size_t de 64 bits.
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+struct salida {
+	int fd;
+	size_t usado;
+	bool error;  // Si alguna escritura fallo desde que se creo la salida.
+	bool (*antes_de_escribir)(void*);
+	void* extra;
+	char buffer[TAM_BUFFER];
+};
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+/* PRE: Recibe un descriptor, un texto y su largo.
+ * POST: Escribe el texto completo, reintentando las escrituras parciales o interrumpidas.
+ * Devuelve false si hubo un error de escritura.
+ */
+bool escribir_todo(int fd, const char* texto, size_t largo) {
+	while (largo) {
+		ssize_t escritos = write(fd, texto, largo);
+		if (escritos == -1) {
+			if (errno == EINTR) continue;
+			return false;
+		}
+		texto += escritos;
+		largo -= (size_t)escritos;
+	}
+	return true;
+}
+
+/* PRE: Recibe una salida, un texto y su largo.
+ * POST: Agrega el texto al buffer, vaciandolo antes si no entra. Un texto mas largo que el
+ * buffer se escribe directamente.
+ */
+void salida_agregar(salida_t* salida, const char* texto, size_t largo) {
+	if (largo > TAM_BUFFER - salida->usado) {
+		bool vaciada = salida_vaciar(salida);
+		if (largo > TAM_BUFFER) {
+			if (!vaciada || !escribir_todo(salida->fd, texto, largo)) salida->error = true;
+			return;
+		}
+	}
+	memcpy(salida->buffer + salida->usado, texto, largo);
+	salida->usado += largo;
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA SALIDA
+ * *****************************************************************/
+
+salida_t* salida_crear(int fd) {
+	salida_t* salida = malloc(sizeof(salida_t));
+	if (!salida) return NULL;
+	salida->fd = fd;
+	salida->usado = 0;
+	salida->error = false;
+	salida->antes_de_escribir = NULL;
+	salida->extra = NULL;
+	return salida;
+}
+
+void salida_antes_de_escribir(salida_t* salida, bool (*funcion)(void*), void* extra) {
+	salida->antes_de_escribir = funcion;
+	salida->extra = extra;
+}
+
+void salida_texto(salida_t* salida, const char* texto) {
+	salida_agregar(salida, texto, strlen(texto));
+}
+
+void salida_numero(salida_t* salida, size_t numero) {
+	static const char pares[] =
+		"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+		"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+		"8081828384858687888990919293949596979899";
+	char digitos[DIGITOS_MAX];
+	size_t pos = DIGITOS_MAX;
+	// De a dos digitos por vuelta, de derecha a izquierda.
+	while (numero >= 100) {
+		size_t resto = numero % 100;
+		numero /= 100;
+		digitos[--pos] = pares[resto * 2 + 1];
+		digitos[--pos] = pares[resto * 2];
+	}
+	if (numero >= 10) {
+		digitos[--pos] = pares[numero * 2 + 1];
+		digitos[--pos] = pares[numero * 2];
+	} else {
+		digitos[--pos] = (char)('0' + numero);
+	}
+	salida_agregar(salida, digitos + pos, DIGITOS_MAX - pos);
+}
+
+void salida_entero(salida_t* salida, uint64_t valor, size_t bytes) {
+	char codificado[sizeof(uint64_t)];
+	for (size_t i = 0; i < bytes; i++) {
+		codificado[i] = (char)(valor & 0xff);
+		valor >>= 8;
+	}
+	salida_agregar(salida, codificado, bytes);
+}
+
+void salida_bytes(salida_t* salida, const void* datos, size_t largo) {
+	salida_agregar(salida, datos, largo);
+}
+
+bool salida_vaciar(salida_t* salida) {
+	bool ok = !salida->antes_de_escribir || salida->antes_de_escribir(salida->extra);
+	ok = ok && escribir_todo(salida->fd, salida->buffer, salida->usado);
+	salida->usado = 0;
+	if (!ok) salida->error = true;
+	return ok;
+}
+
+bool salida_hubo_error(const salida_t* salida) {
+	return salida->error;
+}
+
+void salida_destruir(salida_t* salida) {
+	salida_vaciar(salida);
+	free(salida);
+}
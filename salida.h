@@ -0,0 +1,73 @@
+#ifndef SALIDA_H
+#define SALIDA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Salida con buffer propio sobre un descriptor de archivo. El texto se acumula en
+ * el buffer y se escribe con una sola llamada a write cuando se vacia la salida
+ * (o cuando el buffer se llena), en lugar de una llamada a stdio por linea.
+ */
+typedef struct salida salida_t;
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA SALIDA
+ * *****************************************************************/
+
+/* PRE: Recibe un descriptor de archivo abierto para escritura.
+ * POST: Devuelve una salida vacia que escribe en ese descriptor, o NULL si no se pudo crear.
+ */
+salida_t* salida_crear(int fd);
+
+/* PRE: Recibe una salida previamente creada, una funcion y su extra.
+ * POST: La funcion se llama antes de cada escritura en el descriptor (cada vez que se vacia la
+ * salida). Si devuelve false, lo acumulado se descarta sin escribirse, como en un error de
+ * escritura.
+ */
+void salida_antes_de_escribir(salida_t* salida, bool (*funcion)(void*), void* extra);
+
+/* PRE: Recibe una salida previamente creada y un texto.
+ * POST: Agrega el texto a la salida.
+ */
+void salida_texto(salida_t* salida, const char* texto);
+
+/* PRE: Recibe una salida previamente creada y un numero.
+ * POST: Agrega la representacion decimal del numero a la salida.
+ */
+void salida_numero(salida_t* salida, size_t numero);
+
+/* PRE: Recibe una salida previamente creada, un valor y una cantidad de bytes (a lo sumo 8).
+ * POST: Agrega los bytes menos significativos del valor a la salida, en orden little-endian.
+ */
+void salida_entero(salida_t* salida, uint64_t valor, size_t bytes);
+
+/* PRE: Recibe una salida previamente creada, datos y su largo.
+ * POST: Agrega los datos a la salida tal cual estan.
+ */
+void salida_bytes(salida_t* salida, const void* datos, size_t largo);
+
+/* PRE: Recibe una salida previamente creada.
+ * POST: Escribe todo lo acumulado en el descriptor. Devuelve false si hubo un error de escritura
+ * (lo que no se pudo escribir se descarta).
+ */
+bool salida_vaciar(salida_t* salida);
+
+/* PRE: Recibe una salida previamente creada.
+ * POST: Devuelve true si fallo alguna escritura desde que se creo la salida (incluidas las
+ * que se hacen al llenarse el buffer), en caso contrario false.
+ */
+bool salida_hubo_error(const salida_t* salida);
+
+/* PRE: Recibe una salida previamente creada.
+ * POST: Vacia la salida y la destruye (no cierra el descriptor).
+ */
+void salida_destruir(salida_t* salida);
+
+#endif  // SALIDA_H
@@ -0,0 +1,44 @@
+#include <stdlib.h>
+
+#include "sesion.h"
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+struct sesion {
+	usuario_t* usuario;  // NULL si no hay usuario loggeado.
+};
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA SESION
+ * *****************************************************************/
+
+sesion_t* sesion_crear(void) {
+	sesion_t* sesion = malloc(sizeof(sesion_t));
+	if (!sesion) return NULL;
+	sesion->usuario = NULL;
+	return sesion;
+}
+
+bool sesion_login(sesion_t* sesion, usuario_t* usuario) {
+	if (sesion->usuario) return false;
+	sesion->usuario = usuario;
+	return true;
+}
+
+bool sesion_logout(sesion_t* sesion) {
+	if (!sesion->usuario) return false;
+	sesion->usuario = NULL;
+	return true;
+}
+
+usuario_t* sesion_ver_usuario(const sesion_t* sesion) {
+	return sesion->usuario;
+}
+
+void sesion_destruir(sesion_t* sesion) {
+	free(sesion);
+}
@@ -0,0 +1,45 @@
+#ifndef SESION_H
+#define SESION_H
+
+#include <stdbool.h>
+
+#include "usuario.h"
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Sesion de un cliente: el usuario que tiene loggeado, si hay alguno. Cada cliente tiene su
+ * propia sesion, de modo que varios clientes pueden usar AlgoGram (o el motor) a la vez.
+ */
+typedef struct sesion sesion_t;
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA SESION
+ * *****************************************************************/
+
+// Crea una sesion sin usuario loggeado.
+sesion_t* sesion_crear(void);
+
+/* PRE: Recibe una sesion previamente creada y un usuario.
+ * POST: Devuelve true si la sesion no tenia usuario loggeado y ahora tiene a este, en caso
+ * contrario false (la sesion no cambia).
+ */
+bool sesion_login(sesion_t* sesion, usuario_t* usuario);
+
+/* PRE: Recibe una sesion previamente creada.
+ * POST: Devuelve true si habia un usuario loggeado y ya no lo hay, en caso contrario false.
+ */
+bool sesion_logout(sesion_t* sesion);
+
+/* PRE: Recibe una sesion previamente creada.
+ * POST: Devuelve el usuario loggeado, o NULL si no hay ninguno.
+ */
+usuario_t* sesion_ver_usuario(const sesion_t* sesion);
+
+// Destruye la sesion (no el usuario loggeado).
+void sesion_destruir(sesion_t* sesion);
+
+#endif  // SESION_H
@@ -0,0 +1,82 @@
+#include <stdlib.h>
+#include <string.h>
+
+#include "tabla_posts.h"
+
+#define TAM_INICIAL 32
+#define FACTOR_REDIMENSION 2
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+struct tabla_posts {
+	post_t** posts;
+	size_t cant;
+	size_t tam;
+};
+
+
+/* *****************************************************************
+ *                    FUNCIONES AUXILIARES
+ * *****************************************************************/
+
+/* PRE: Recibe una tabla y un ID.
+ * POST: Devuelve true si la tabla tiene lugar para ese ID, agrandandola si hace falta.
+ * Las posiciones nuevas quedan en NULL.
+ */
+bool tabla_posts_asegurar(tabla_posts_t* tabla, size_t id) {
+	if (id < tabla->tam) return true;
+	size_t tam_nuevo = tabla->tam;
+	while (tam_nuevo <= id) tam_nuevo *= FACTOR_REDIMENSION;
+	post_t** posts = realloc(tabla->posts, tam_nuevo * sizeof(post_t*));
+	if (!posts) return false;
+	memset(posts + tabla->tam, 0, (tam_nuevo - tabla->tam) * sizeof(post_t*));
+	tabla->posts = posts;
+	tabla->tam = tam_nuevo;
+	return true;
+}
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA TABLA DE POSTS
+ * *****************************************************************/
+
+tabla_posts_t* tabla_posts_crear(void) {
+	tabla_posts_t* tabla = malloc(sizeof(tabla_posts_t));
+	if (!tabla) return NULL;
+	tabla->posts = calloc(TAM_INICIAL, sizeof(post_t*));
+	if (!tabla->posts) {
+		free(tabla);
+		return NULL;
+	}
+	tabla->cant = 0;
+	tabla->tam = TAM_INICIAL;
+	return tabla;
+}
+
+bool tabla_posts_guardar(tabla_posts_t* tabla, post_t* post) {
+	size_t id = post_ver_id(post);
+	if (!tabla_posts_asegurar(tabla, id)) return false;
+	if (tabla->posts[id]) post_destruir(tabla->posts[id]);
+	tabla->posts[id] = post;
+	if (id >= tabla->cant) tabla->cant = id + 1;
+	return true;
+}
+
+post_t* tabla_posts_obtener(const tabla_posts_t* tabla, size_t id) {
+	return id < tabla->cant ? tabla->posts[id] : NULL;
+}
+
+size_t tabla_posts_cantidad(const tabla_posts_t* tabla) {
+	return tabla->cant;
+}
+
+void tabla_posts_destruir(tabla_posts_t* tabla) {
+	for (size_t i = 0; i < tabla->cant; i++) {
+		if (tabla->posts[i]) post_destruir(tabla->posts[i]);
+	}
+	free(tabla->posts);
+	free(tabla);
+}
@@ -0,0 +1,49 @@
+#ifndef TABLA_POSTS_H
+#define TABLA_POSTS_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "post.h"
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+/* Tabla de posts indexada directamente por el ID del post. Los IDs son densos
+ * (los asigna AlgoGram de forma consecutiva), por lo que se guardan en un arreglo
+ * que crece a medida que se publican. La tabla es dueña de los posts.
+ */
+typedef struct tabla_posts tabla_posts_t;
+
+
+/* ******************************************************************
+ *                    PRIMITIVAS DE LA TABLA DE POSTS
+ * *****************************************************************/
+
+// Crea una tabla de posts vacia.
+tabla_posts_t* tabla_posts_crear(void);
+
+/* PRE: Recibe una tabla previamente creada y un post.
+ * POST: Devuelve true si se pudo guardar el post en la posicion de su ID, en caso contrario false.
+ * Si ya habia un post con ese ID, se destruye y se reemplaza.
+ */
+bool tabla_posts_guardar(tabla_posts_t* tabla, post_t* post);
+
+/* PRE: Recibe una tabla previamente creada y un ID.
+ * POST: Devuelve el post con ese ID, o NULL si no existe. Es O(1).
+ */
+post_t* tabla_posts_obtener(const tabla_posts_t* tabla, size_t id);
+
+/* PRE: Recibe una tabla previamente creada.
+ * POST: Devuelve una cota para los IDs guardados: todo post de la tabla tiene un ID menor.
+ */
+size_t tabla_posts_cantidad(const tabla_posts_t* tabla);
+
+/* PRE: Recibe una tabla previamente creada.
+ * POST: Se destruyo la tabla y todos los posts que contenia.
+ */
+void tabla_posts_destruir(tabla_posts_t* tabla);
+
+#endif  // TABLA_POSTS_H
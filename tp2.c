@@ -1,33 +1,124 @@
 #define _POSIX_C_SOURCE 200809L
 
 #include <stdlib.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdint.h>
 #include <string.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "algogram.h"
+#include "entrada.h"
+#include "protocolo.h"
+#include "estadisticas.h"
 
 #define PARAM_ARCHIVO 1
+#define PARAM_OPCIONES 2
+#define MODO_BINARIO "--binario"
+#define OPCION_INSTANTANEA "--instantanea"
+#define OPCION_BITACORA "--bitacora"
+#define OPCION_VENTANA "--ventana"
+#define OPCION_PULL "--pull"
+#define OPCION_HILOS "--hilos"
+#define OPCION_RELAJADO "--relajado"
+#define VENTANA_MAX 60000  // Milisegundos.
+#define HILOS_MAX 256
+#define LARGO_COMANDO_MAX 19
+
+
+/* ******************************************************************
+ *                DEFINICION DE LOS TIPOS DE DATOS
+ * *****************************************************************/
+
+typedef struct parametros {
+	const char* archivo;       // Archivo de usuarios.
+	bool binario;
+	const char* instantanea;   // Instantanea a cargar (si existe) y a guardar al salir, o NULL.
+	const char* bitacora;      // Bitacora a reproducir y en la que se registran los comandos, o NULL.
+	size_t ventana;            // Ventana de group commit de la bitacora, en milisegundos.
+	bool hay_ventana;
+	bool pull;                 // Feeds en modo FEED_PULL (si no se carga una instantanea).
+	size_t hilos;              // Hilos del reparto en paralelo de los posts, o 0 para repartir sin hilos.
+	bool relajado;             // Reparto en paralelo relajado (ver algogram_repartir_en_paralelo).
+} parametros_t;
 
 
 /* *****************************************************************
  *                    FUNCIONES AUXILIARES
  * *****************************************************************/
 
-/* PRE: Recibe la cantidad de parametros del main.
- * POST: Devuelve true si la cantidad de parametros es válida, false si es invalida.
+/* PRE: Recibe un texto, el maximo aceptado y donde guardar el numero.
+ * POST: Devuelve true si el texto es un numero en decimal de hasta maximo, guardandolo en
+ * numero. En caso contrario false.
+ */
+bool parsear_numero(const char* texto, size_t maximo, size_t* numero) {
+	size_t valor = 0;
+	if (!*texto) return false;
+	for (; *texto; texto++) {
+		if (*texto < '0' || *texto > '9') return false;
+		valor = valor * 10 + (size_t)(*texto - '0');
+		if (valor > maximo) return false;
+	}
+	*numero = valor;
+	return true;
+}
+
+/* PRE: Recibe los parametros del main y donde guardarlos.
+ * POST: Devuelve true si los parametros son válidos (el archivo de usuarios y, opcionalmente y
+ * en cualquier orden, el modo binario, una instantanea, una bitacora con su ventana (en
+ * milisegundos), el modo pull de los feeds o la cantidad de hilos del reparto, que puede ser
+ * relajado), false si son invalidos.
  */
-bool validar_params(int argc) {
-	if (argc != 2) {
+bool validar_params(int argc, char* argv[], parametros_t* params) {
+	params->binario = false;
+	params->instantanea = NULL;
+	params->bitacora = NULL;
+	params->ventana = 0;
+	params->hay_ventana = false;
+	params->pull = false;
+	params->hilos = 0;
+	params->relajado = false;
+	bool validos = argc > PARAM_ARCHIVO;
+	for (int i = PARAM_OPCIONES; validos && i < argc; i++) {
+		bool hay_valor = i + 1 < argc;
+		if (!params->binario && strcmp(argv[i], MODO_BINARIO) == 0) {
+			params->binario = true;
+		} else if (!params->instantanea && strcmp(argv[i], OPCION_INSTANTANEA) == 0 && hay_valor) {
+			params->instantanea = argv[++i];
+		} else if (!params->bitacora && strcmp(argv[i], OPCION_BITACORA) == 0 && hay_valor) {
+			params->bitacora = argv[++i];
+		} else if (!params->hay_ventana && strcmp(argv[i], OPCION_VENTANA) == 0 && hay_valor) {
+			params->hay_ventana = true;
+			validos = parsear_numero(argv[++i], VENTANA_MAX, &params->ventana);
+		} else if (!params->pull && strcmp(argv[i], OPCION_PULL) == 0) {
+			params->pull = true;
+		} else if (!params->hilos && strcmp(argv[i], OPCION_HILOS) == 0 && hay_valor) {
+			validos = parsear_numero(argv[++i], HILOS_MAX, &params->hilos) && params->hilos;
+		} else if (!params->relajado && strcmp(argv[i], OPCION_RELAJADO) == 0) {
+			params->relajado = true;
+		} else {
+			validos = false;
+		}
+	}
+	// La ventana solo tiene sentido con bitacora, y el reparto relajado con hilos (que no se usan en modo pull).
+	if (params->hay_ventana && !params->bitacora) validos = false;
+	if ((params->relajado && !params->hilos) || (params->hilos && params->pull)) validos = false;
+	if (!validos) {
 		fprintf(stdout, "Error: parametros invalidos");
 		return false;
 	}
+	params->archivo = argv[PARAM_ARCHIVO];
 	return true;
 }
 
 /* PRE: Recibe el nombre del archivo a abrir.
  * POST: Devuelve el archivo abierto, si no se pudo abrir imprime un mensaje de error.
  */
-FILE* abrir_archivo(char* nom_archivo) {
+FILE* abrir_archivo(const char* nom_archivo) {
 	FILE* archivo = fopen(nom_archivo, "r");
 	if (!archivo) {
 		fprintf(stderr, "%s", "Error: no se pudo abrir el archivo de usuarios\n");
@@ -48,28 +139,324 @@ void obtener_usuarios(algogram_t* algogram, FILE* archivo) {
 	free(linea);
 }
 
+/* PRE: Recibe un AlgoGram y el contenido de un archivo de usuarios de largo tam, mapeado
+ * solo para lectura.
+ * POST: Todos los usuarios del archivo fueron agregados a AlgoGram. Primero se cuentan las
+ * lineas para reservar las tablas de una vez, y despues cada nombre se pasa directamente del
+ * mapeo con su largo, sin escribir en las paginas (que asi no se copian).
+ */
+void agregar_usuarios_mapeados(algogram_t* algogram, const char* datos, size_t tam) {
+	size_t cant_lineas = 0;
+	for (const char* p = datos; (p = memchr(p, '\n', (size_t)(datos + tam - p))); p++) cant_lineas++;
+	if (tam && datos[tam - 1] != '\n') cant_lineas++;
+	if (!algogram_reservar_usuarios(algogram, cant_lineas)) fprintf(stdout, "Error: no se pudo reservar lugar para los usuarios\n");
+
+	const char* inicio = datos;
+	const char* fin_datos = datos + tam;
+	while (inicio < fin_datos) {
+		// La ultima linea puede no tener '\n'.
+		const char* fin = memchr(inicio, '\n', (size_t)(fin_datos - inicio));
+		if (!fin) fin = fin_datos;
+		if (!algogram_agregar_usuario_largo(algogram, inicio, (size_t)(fin - inicio))) {
+			fprintf(stdout, "Error: no se pudo obtener el usuario\n");
+		}
+		inicio = fin < fin_datos ? fin + 1 : fin_datos;
+	}
+}
+
+/* PRE: Recibe un AlgoGram y un archivo de texto con usuarios.
+ * POST: Todos los usuarios del archivo fueron agregados a AlgoGram. Si el archivo se puede
+ * mapear en memoria se lo lee de una vez (ver agregar_usuarios_mapeados); si no (por ejemplo,
+ * si es un pipe), se lo lee linea por linea con obtener_usuarios.
+ */
+void cargar_usuarios(algogram_t* algogram, FILE* archivo) {
+	struct stat info;
+	int fd = fileno(archivo);
+	if (fstat(fd, &info) == -1 || !S_ISREG(info.st_mode)) {
+		obtener_usuarios(algogram, archivo);
+		return;
+	}
+	size_t tam = (size_t)info.st_size;
+	if (!tam) return;
+	char* datos = mmap(NULL, tam, PROT_READ, MAP_PRIVATE, fd, 0);
+	if (datos == MAP_FAILED) {
+		obtener_usuarios(algogram, archivo);
+		return;
+	}
+	agregar_usuarios_mapeados(algogram, datos, tam);
+	munmap(datos, tam);
+}
+
+/* Comandos: cada uno lee de la entrada las lineas de argumentos que le corresponden (como
+ * vistas, sin copiarlas) y llama a la primitiva de AlgoGram.
+ */
+
+bool comando_login(algogram_t* algogram, entrada_t* entrada) {
+	// Si ya hay un usuario loggeado, el comando falla sin consumir la linea del nombre.
+	if (algogram_hay_usuario_loggeado(algogram)) return algogram_login(algogram, NULL);
+	return algogram_login(algogram, entrada_linea(entrada, NULL));
+}
+
+bool comando_logout(algogram_t* algogram, entrada_t* entrada) {
+	(void)entrada;
+	return algogram_logout(algogram);
+}
+
+bool comando_publicar(algogram_t* algogram, entrada_t* entrada) {
+	// Sin usuario loggeado, el comando falla sin consumir la linea del texto.
+	if (!algogram_hay_usuario_loggeado(algogram)) return algogram_publicar_post(algogram, NULL);
+	return algogram_publicar_post(algogram, entrada_linea(entrada, NULL));
+}
+
+bool comando_ver_siguiente_feed(algogram_t* algogram, entrada_t* entrada) {
+	(void)entrada;
+	return algogram_ver_post(algogram);
+}
+
+bool comando_likear_post(algogram_t* algogram, entrada_t* entrada) {
+	return algogram_likear_post(algogram, entrada_linea(entrada, NULL));
+}
+
+bool comando_mostrar_likes(algogram_t* algogram, entrada_t* entrada) {
+	return algogram_ver_likes(algogram, entrada_linea(entrada, NULL));
+}
+
+bool comando_mostrar_likes_desde(algogram_t* algogram, entrada_t* entrada) {
+	// Cada linea deja de valer al leer la siguiente: las dos primeras se copian.
+	char* id_post = entrada_linea(entrada, NULL);
+	id_post = id_post ? strdup(id_post) : NULL;
+	char* desde = entrada_linea(entrada, NULL);
+	desde = desde ? strdup(desde) : NULL;
+	bool ok = algogram_ver_likes_desde(algogram, id_post, desde, entrada_linea(entrada, NULL));
+	free(id_post);
+	free(desde);
+	return ok;
+}
+
+#ifdef ESTADISTICAS
+bool comando_estadisticas(algogram_t* algogram, entrada_t* entrada) {
+	(void)entrada;
+	algogram_mostrar_estadisticas(algogram);
+	return true;
+}
+#endif
+
+typedef struct comando {
+	const char* nombre;
+	bool (*ejecutar)(algogram_t* algogram, entrada_t* entrada);
+} comando_t;
+
+/* Tabla de comandos indexada por el largo del nombre: como no hay dos comandos del mismo
+ * largo, el largo es un hash perfecto y cada linea se compara a lo sumo con un nombre.
+ */
+static const comando_t COMANDOS[LARGO_COMANDO_MAX + 1] = {
+	[5] = { "login", comando_login },
+	[6] = { "logout", comando_logout },
+	[8] = { "publicar", comando_publicar },
+	[11] = { "likear_post", comando_likear_post },
+#ifdef ESTADISTICAS
+	[12] = { "estadisticas", comando_estadisticas },
+#endif
+	[13] = { "mostrar_likes", comando_mostrar_likes },
+	[18] = { "ver_siguiente_feed", comando_ver_siguiente_feed },
+	[19] = { "mostrar_likes_desde", comando_mostrar_likes_desde },
+};
+
+/* PRE: Recibe una linea de la entrada y su largo.
+ * POST: Devuelve el comando cuyo nombre es exactamente la linea, o NULL si no hay ninguno.
+ */
+const comando_t* buscar_comando(const char* linea, size_t largo) {
+	if (largo > LARGO_COMANDO_MAX || !COMANDOS[largo].nombre) return NULL;
+	const comando_t* comando = &COMANDOS[largo];
+	if (comando->nombre[0] != linea[0] || memcmp(comando->nombre, linea, largo) != 0) return NULL;
+	return comando;
+}
+
+#ifdef ESTADISTICAS
+#if LARGO_COMANDO_MAX >= ESTADISTICAS_COMANDOS
+#error "Hace falta un histograma de latencias por cada posicion de la tabla de comandos"
+#endif
+
+/* PRE: Recibe un comando de la tabla y el momento en que empezo a ejecutarse.
+ * POST: Se registro la latencia en el histograma de ese comando, que se indexa igual que la tabla.
+ */
+void registrar_latencia_comando(const comando_t* comando, uint64_t inicio) {
+	histograma_latencias_t* latencias = &latencias_comandos[comando - COMANDOS];
+	latencias->nombre = comando->nombre;
+	latencias_registrar(latencias, estadisticas_reloj() - inicio);
+}
+#endif
+
+/* Wrapper de algogram_vaciar_salida para llamarla antes de cada lectura de la entrada. Con una
+ * ventana de group commit, si llegan mas comandos antes de que venza se leen sin responder los
+ * anteriores, que se confirman todos con la misma sincronizacion; si no llega nada, se vacia al
+ * vencer, aunque la entrada quede quieta.
+ */
+void vaciar_salida_wrapper(void* algogram) {
+	int demora = algogram_demora_salida(algogram);
+	struct pollfd entrada = { STDIN_FILENO, POLLIN, 0 };
+	if (demora > 0 && poll(&entrada, 1, demora) > 0) return;
+	algogram_vaciar_salida(algogram);
+}
+
 /* PRE: Recibe un AlgoGram.
  * POST: Se ejecutaron todos los comandos válidos de AlgoGram que se hayan ingresado por entrada estandar.
+ * La entrada se lee de a bloques, y las respuestas acumuladas se escriben justo antes de cada
+ * lectura: una sola escritura por tanda de comandos, y enseguida si se usa en forma interactiva.
  */
 void recibir_comandos(algogram_t* algogram) {
-	char* linea = NULL;
-	size_t capacidad;
-	while (getline(&linea, &capacidad, stdin) != EOF) {
-		if (strcmp(linea, "login\n") == 0) {
-			algogram_login(algogram);
-		} else if (strcmp(linea, "logout\n") == 0) {
-			algogram_logout(algogram);
-		} else if (strcmp(linea, "publicar\n") == 0) {
-			algogram_publicar_post(algogram);
-		} else if (strcmp(linea, "ver_siguiente_feed\n") == 0) {
-			algogram_ver_post(algogram);
-		} else if (strcmp(linea, "likear_post\n") == 0) {
-			algogram_likear_post(algogram);
-		} else if (strcmp(linea, "mostrar_likes\n") == 0) {
-			algogram_ver_likes(algogram);
+	entrada_t* entrada = entrada_crear(STDIN_FILENO, vaciar_salida_wrapper, algogram);
+	if (!entrada) {
+		fprintf(stdout, "Error: no se pudo leer la entrada\n");
+		return;
+	}
+	char* linea;
+	size_t largo;
+	while ((linea = entrada_linea(entrada, &largo))) {
+		// Un comando tiene que ser una linea completa: la ultima linea sin '\n' se ignora.
+		if (!entrada_linea_terminada(entrada)) continue;
+		const comando_t* comando = buscar_comando(linea, largo);
+		if (!comando) continue;
+		// La latencia incluye leer los argumentos, que puede bloquear si se usa en forma interactiva.
+		ESTADISTICA(uint64_t inicio = estadisticas_reloj());
+		comando->ejecutar(algogram, entrada);
+		ESTADISTICA(registrar_latencia_comando(comando, inicio));
+	}
+	entrada_destruir(entrada);
+}
+
+
+/* PRE: Recibe una vista de al menos bytes bytes.
+ * POST: Devuelve el entero sin signo little-endian de ese largo.
+ */
+uint64_t decodificar_entero(const char* datos, size_t bytes) {
+	uint64_t valor = 0;
+	for (size_t i = bytes; i > 0; i--) valor = valor << 8 | (unsigned char)datos[i - 1];
+	return valor;
+}
+
+/* PRE: Recibe una entrada y el largo de un entero del protocolo.
+ * POST: Lee el entero y lo guarda en valor. Devuelve false si la entrada termino antes.
+ */
+bool leer_entero(entrada_t* entrada, size_t bytes, uint64_t* valor) {
+	const char* datos = entrada_bytes(entrada, bytes);
+	if (!datos) return false;
+	*valor = decodificar_entero(datos, bytes);
+	return true;
+}
+
+/* PRE: Recibe un AlgoGram y una entrada posicionada al comienzo de un pedido.
+ * POST: Lee un pedido binario completo (ver protocolo.h) y lo ejecuta. Devuelve false si la
+ * entrada termino, si la operacion es desconocida o si el texto supera PROTOCOLO_LARGO_MAX, en
+ * cuyos casos no se puede seguir leyendo.
+ */
+bool atender_pedido_binario(algogram_t* algogram, entrada_t* entrada) {
+	uint64_t operacion, argumento;
+	if (!leer_entero(entrada, PROTOCOLO_TAM_U8, &operacion)) return false;
+	switch (operacion) {
+		case PROTOCOLO_LOGIN:
+			if (!leer_entero(entrada, PROTOCOLO_TAM_U32, &argumento)) return false;
+			algogram_bin_login(algogram, argumento);
+			return true;
+		case PROTOCOLO_LOGOUT:
+			algogram_bin_logout(algogram);
+			return true;
+		case PROTOCOLO_PUBLICAR: {
+			if (!leer_entero(entrada, PROTOCOLO_TAM_U32, &argumento)) return false;
+			// El largo viene del cliente: no se reserva lugar para un texto mas largo que el maximo.
+			if (argumento > PROTOCOLO_LARGO_MAX) {
+				algogram_bin_texto_muy_largo(algogram);
+				return false;
+			}
+			const char* texto = entrada_bytes(entrada, argumento);
+			if (!texto) return false;
+			algogram_bin_publicar_post(algogram, texto, argumento);
+			return true;
 		}
+		case PROTOCOLO_VER_SIGUIENTE_FEED:
+			algogram_bin_ver_post(algogram);
+			return true;
+		case PROTOCOLO_LIKEAR_POST:
+			if (!leer_entero(entrada, PROTOCOLO_TAM_U64, &argumento)) return false;
+			algogram_bin_likear_post(algogram, argumento);
+			return true;
+		case PROTOCOLO_MOSTRAR_LIKES:
+			if (!leer_entero(entrada, PROTOCOLO_TAM_U64, &argumento)) return false;
+			algogram_bin_ver_likes(algogram, argumento);
+			return true;
 	}
-	free(linea);
+	algogram_bin_operacion_invalida(algogram);
+	return false;
+}
+
+/* PRE: Recibe un AlgoGram.
+ * POST: Se ejecutaron todos los pedidos binarios que se hayan recibido por entrada estandar,
+ * con el mismo criterio de escritura de las respuestas que recibir_comandos.
+ */
+void recibir_pedidos_binarios(algogram_t* algogram) {
+	entrada_t* entrada = entrada_crear(STDIN_FILENO, vaciar_salida_wrapper, algogram);
+	if (!entrada) {
+		fprintf(stderr, "Error: no se pudo leer la entrada\n");
+		return;
+	}
+	while (atender_pedido_binario(algogram, entrada));
+	entrada_destruir(entrada);
+}
+
+/* PRE: Recibe los parametros del main y si hay una instantanea guardada.
+ * POST: Devuelve AlgoGram cargado de la instantanea (o vacio si no hay, en el modo pedido) y
+ * con la bitacora abierta y reproducida, si se pidio. La instantanea conserva el modo con el
+ * que se guardo, que tiene prioridad sobre el pedido. Si no se pudo, imprime el error y devuelve NULL.
+ */
+algogram_t* iniciar_algogram(const parametros_t* params, bool hay_instantanea) {
+	algogram_t* algogram = NULL;
+	if (hay_instantanea) {
+		algogram = algogram_cargar_instantanea(params->instantanea);
+		if (!algogram) {
+			fprintf(stdout, "Error: no se pudo cargar la instantanea");
+			return NULL;
+		}
+	} else {
+		/* Creo la estructura de AlgoGram */
+		algogram = algogram_crear_con_modo(params->pull ? FEED_PULL : FEED_PUSH);
+		if (!algogram) {
+			fprintf(stdout, "Error: no se pudo iniciar AlgoGram");
+			return NULL;
+		}
+	}
+	/* La bitacora se abre antes de cargar los usuarios, para que queden registrados */
+	if (params->bitacora && !algogram_abrir_bitacora(algogram, params->bitacora, params->ventana)) {
+		fprintf(stdout, "Error: no se pudo abrir la bitacora");
+		algogram_destruir(algogram);
+		return NULL;
+	}
+	return algogram;
+}
+
+/* PRE: Recibe un AlgoGram ya cargado y los parametros del main.
+ * POST: Atendio los comandos hasta el fin de la entrada, guardo la instantanea si se pidio y
+ * destruyo AlgoGram. Devuelve el codigo de salida del programa.
+ */
+int ejecutar_algogram(algogram_t* algogram, const parametros_t* params) {
+	/* Espero comandos por consola */
+	if (params->binario) recibir_pedidos_binarios(algogram);
+	else recibir_comandos(algogram);
+	algogram_vaciar_salida(algogram);
+	
+	int codigo = 0;
+	if (params->instantanea && !algogram_guardar_instantanea(algogram, params->instantanea)) {
+		fprintf(stderr, "%s", "Error: no se pudo guardar la instantanea\n");
+		codigo = -1;
+	}
+	
+#ifdef ESTADISTICAS
+	algogram_volcar_estadisticas(algogram, STDERR_FILENO);
+#endif
+	
+	/* Destruyo la estructura de AlgoGram */
+	algogram_destruir(algogram);
+	
+	return codigo;
 }
 
 
@@ -80,28 +467,50 @@ void recibir_comandos(algogram_t* algogram) {
 int main(int argc, char* argv[]) {
 	
 	/* Validacion de parametros */
-	if (!validar_params(argc)) {
+	parametros_t params;
+	if (!validar_params(argc, argv, &params)) {
 		return -1;
 	}
-	/* Creo la estructura de AlgoGram */
-	algogram_t* algogram = algogram_crear();
-	if (!algogram) {
-		fprintf(stdout, "Error: no se pudo iniciar AlgoGram");
-		return -1;
+	/* Si hay una instantanea guardada, AlgoGram arranca desde ella y no se lee el archivo de usuarios */
+	bool hay_instantanea = params.instantanea && access(params.instantanea, F_OK) == 0;
+	bool hay_bitacora = params.bitacora && access(params.bitacora, F_OK) == 0;
+	algogram_t* algogram = iniciar_algogram(&params, hay_instantanea);
+	if (!algogram) return -1;
+	/* Una bitacora sin instantanea que no llega al registro de carga es de una carga cortada por
+	 * una caida: solo tiene una parte de los usuarios y ningun comando (los comandos se atienden
+	 * despues de la carga), por lo que se descarta y se vuelve a cargar el archivo. */
+	if (hay_bitacora && !algogram_carga_completa(algogram)) {
+		algogram_destruir(algogram);
+		if (unlink(params.bitacora) == -1) {
+			fprintf(stdout, "Error: no se pudo descartar la bitacora");
+			return -1;
+		}
+		algogram = iniciar_algogram(&params, hay_instantanea);
+		if (!algogram) return -1;
 	}
-	/* Obtengo los usuarios del archivo de texto */
-	FILE* archivo = abrir_archivo(argv[PARAM_ARCHIVO]);
-	if (!archivo) {
+	if (!algogram_carga_completa(algogram)) {
+		/* Obtengo los usuarios del archivo de texto */
+		FILE* archivo = abrir_archivo(params.archivo);
+		if (!archivo) {
+			algogram_destruir(algogram);
+			return -1;
+		}
+		cargar_usuarios(algogram, archivo);
+		fclose(archivo);
+		if (!algogram_terminar_carga(algogram)) {
+			fprintf(stdout, "Error: no se pudo escribir la bitacora");
+			algogram_destruir(algogram);
+			return -1;
+		}
+	}
+	/* Los usuarios ya cargados se reparten entre los hilos de una vez. Una instantanea en modo
+	 * pull no admite el reparto en paralelo. */
+	if (params.hilos && !algogram_repartir_en_paralelo(algogram, params.hilos, params.relajado)) {
+		fprintf(stdout, "Error: no se pudo repartir en paralelo");
+		algogram_destruir(algogram);
 		return -1;
 	}
-	obtener_usuarios(algogram, archivo);
-	fclose(archivo);
-	
-	/* Espero comandos por consola */
-	recibir_comandos(algogram);
-	
-	/* Destruyo la estructura de AlgoGram */
-	algogram_destruir(algogram);
-	
-	return 0;
+	// Los errores de la carga van por stdio, y las respuestas a los comandos por la salida de AlgoGram.
+	fflush(stdout);
+	return ejecutar_algogram(algogram, &params);
 }
@@ -1,67 +1,126 @@
 #include <stdlib.h>
+#include <stdint.h>
 
 #include "usuario.h"
-#include "heap.h"
+#include "cola_feed.h"
+#include "estadisticas.h"
+
+#define TAM_INICIAL_LECTURAS 8
+#define FACTOR_REDIMENSION_LECTURAS 2
+#define MULTIPLICADOR_LECTURAS 0x9E3779B97F4A7C15ULL
 
 
 /* ******************************************************************
  *                DEFINICION DE LOS TIPOS DE DATOS
  * *****************************************************************/
 
+// Posts leidos de un autor en el modo pull. Una lectura con leidos == 0 es un lugar libre.
+typedef struct lectura {
+	size_t autor;
+	size_t leidos;
+} lectura_t;
+
 struct usuario {
 	const char* nombre; 
-	heap_t* feed;
+	cola_feed_t* feed;      // Feed del modo push.
 	size_t id;
+	lectura_t* lecturas;    // Tabla abierta (de a potencias de 2) con solo los autores de los que leyo posts.
+	size_t cant_lecturas;
+	size_t tam_lecturas;
+	size_t cursor;          // Distancia minima a la que puede haber posts sin leer (modo pull).
+	size_t visto_hasta;     // Cantidad de publicaciones globales ya consideradas por el cursor.
 };
 
-typedef struct post_afinidad {
-	post_t* post;
-	size_t afinidad;
-} post_afinidad_t;
-
 
 /* *****************************************************************
  *                    FUNCIONES AUXILIARES
  * *****************************************************************/
 
-/* PRE: Recibe un post y su afinidad.
- * POST: Devuelve un struct post_afinidad que contiene dicho post y afinidad.
+/* PRE: Recibe dos IDs de usuario.
+ * POST: Devuelve la distancia entre ambos IDs, que es la afinidad entre los usuarios.
+ */
+size_t distancia_ids(size_t id_a, size_t id_b) {
+	return id_a > id_b ? id_a - id_b : id_b - id_a;
+}
+
+/* PRE: Recibe una tabla de lecturas no vacia, su tamaño y el ID de un autor.
+ * POST: Devuelve la lectura de ese autor o, si no esta, el lugar libre donde iria.
+ */
+lectura_t* buscar_lectura(lectura_t* lecturas, size_t tam, size_t autor) {
+	size_t pos = (size_t)(((uint64_t)autor * MULTIPLICADOR_LECTURAS) >> 32) & (tam - 1);
+	while (lecturas[pos].leidos && lecturas[pos].autor != autor) pos = (pos + 1) & (tam - 1);
+	return &lecturas[pos];
+}
+
+/* PRE: Recibe un usuario y el ID de un autor.
+ * POST: Devuelve la cantidad de posts de ese autor que leyo el usuario.
+ */
+size_t usuario_leidos_de_autor(const usuario_t* usuario, size_t autor) {
+	if (!usuario->tam_lecturas) return 0;
+	return buscar_lectura(usuario->lecturas, usuario->tam_lecturas, autor)->leidos;
+}
+
+/* PRE: Recibe un usuario y una cantidad de autores.
+ * POST: Devuelve true si la tabla de lecturas tiene lugar para esa cantidad de autores nuevos
+ * sin pasar 3/4 de ocupacion, agrandandola si hace falta.
  */
-post_afinidad_t* post_afinidad_crear(post_t* post, size_t afinidad) {
-	post_afinidad_t* post_afinidad = malloc(sizeof(post_afinidad_t));
-	if (!post_afinidad) return NULL;
-	post_afinidad->post = post;
-	post_afinidad->afinidad = afinidad;
-	return post_afinidad;
+bool usuario_asegurar_lecturas(usuario_t* usuario, size_t nuevos) {
+	size_t necesarios = usuario->cant_lecturas + nuevos;
+	if (necesarios * 4 <= usuario->tam_lecturas * 3) return true;
+	size_t tam_nuevo = usuario->tam_lecturas ? usuario->tam_lecturas : TAM_INICIAL_LECTURAS;
+	while (necesarios * 4 > tam_nuevo * 3) tam_nuevo *= FACTOR_REDIMENSION_LECTURAS;
+	lectura_t* lecturas = calloc(tam_nuevo, sizeof(lectura_t));
+	if (!lecturas) return false;
+	for (size_t i = 0; i < usuario->tam_lecturas; i++) {
+		if (usuario->lecturas[i].leidos) *buscar_lectura(lecturas, tam_nuevo, usuario->lecturas[i].autor) = usuario->lecturas[i];
+	}
+	free(usuario->lecturas);
+	usuario->lecturas = lecturas;
+	usuario->tam_lecturas = tam_nuevo;
+	return true;
 }
 
-/* PRE: Recibe un struct post_afinidad.
- * POST: Se destruyo el struct. 
- * (La funcion tiene un casteo para cumplir con la firma de la funcion de destruccion del heap.)
+/* PRE: Recibe un usuario con lugar para un autor nuevo (ver usuario_asegurar_lecturas) y el
+ * ID de un autor.
+ * POST: Suma un post leido de ese autor.
  */
-void post_afinidad_destruir(void* post_afinidad) {
-	post_afinidad_t* post_a_destruir= (post_afinidad_t*)post_afinidad;
-	free(post_a_destruir);
+void usuario_sumar_leido(usuario_t* usuario, size_t autor) {
+	lectura_t* lectura = buscar_lectura(usuario->lecturas, usuario->tam_lecturas, autor);
+	if (!lectura->leidos) {
+		lectura->autor = autor;
+		usuario->cant_lecturas++;
+	}
+	lectura->leidos++;
 }
 
-/* PRE: Recibe dos posts a comparar.
- * POST: Luego de comparar los dos posts, devuelve:
- *   menor a 0  si  a < b
- *       0      si  a == b
- *   mayor a 0  si  a > b
+/* PRE: Recibe un usuario y el registro global de publicaciones.
+ * POST: Baja el cursor del usuario hasta la menor distancia de los autores que publicaron
+ * desde la ultima lectura, ya que esos posts pueden estar antes que los pendientes.
  */
-int afinidad(const void* a, const void* b) {
-	post_afinidad_t* post_a = (post_afinidad_t*)a;
-	post_afinidad_t* post_b = (post_afinidad_t*)b;
-	if (post_a->afinidad > post_b->afinidad) return -1;
-	if (post_a->afinidad == post_b->afinidad) {
-		if (post_ver_id(post_a->post) > post_ver_id(post_b->post)) return -1;
-		if (post_ver_id(post_a->post) == post_ver_id(post_b->post)) return 0;
-		if (post_ver_id(post_a->post) < post_ver_id(post_b->post)) return 1;
+void usuario_actualizar_cursor(usuario_t* usuario, const feed_t* feed) {
+	size_t cant_posts = feed_cantidad_posts(feed);
+	for (size_t i = usuario->visto_hasta; i < cant_posts; i++) {
+		size_t id_autor = feed_autor_publicacion(feed, i);
+		if (id_autor == usuario->id) continue;
+		size_t distancia = distancia_ids(usuario->id, id_autor);
+		if (distancia < usuario->cursor) usuario->cursor = distancia;
 	}
-	return 1;
+	usuario->visto_hasta = cant_posts;
+}
+
+/* PRE: Recibe un usuario, el registro global y el ID de un autor.
+ * POST: Devuelve el siguiente post sin leer de ese autor, o NULL si no hay.
+ */
+post_t* usuario_siguiente_de_autor(const usuario_t* usuario, const feed_t* feed, size_t id_autor) {
+	if (id_autor == usuario->id) return NULL;
+	size_t cant_posts = feed_cantidad_posts_autor(feed, id_autor);
+	if (!cant_posts) return NULL;
+	size_t leidos = usuario_leidos_de_autor(usuario, id_autor);
+	if (leidos >= cant_posts) return NULL;
+	return feed_post_autor(feed, id_autor, leidos);
 }
 
+
 /* ******************************************************************
  *                    PRIMITIVAS DE USUARIO
  * *****************************************************************/
@@ -69,7 +128,7 @@ int afinidad(const void* a, const void* b) {
 usuario_t* usuario_crear(const char* nombre, size_t id) {
 	usuario_t* usuario = malloc(sizeof(usuario_t));
 	if (!usuario) return NULL;
-	heap_t* feed = heap_crear(afinidad);
+	cola_feed_t* feed = cola_feed_crear();
 	if (!feed) {
 		free(usuario);
 		return NULL;
@@ -77,28 +136,98 @@ usuario_t* usuario_crear(const char* nombre, size_t id) {
 	usuario->feed = feed;
 	usuario->nombre = nombre;
 	usuario->id = id;
+	usuario->lecturas = NULL;
+	usuario->cant_lecturas = 0;
+	usuario->tam_lecturas = 0;
+	usuario->cursor = 0;
+	usuario->visto_hasta = 0;
 	return usuario;
 }
 
 bool usuario_guardar_feed(usuario_t* usuario, void* post, size_t afinidad) {
-	post_afinidad_t* post_afinidad = post_afinidad_crear(post, afinidad);
-	if (!heap_encolar(usuario->feed, post_afinidad)) return false;
-	return true;
+	return cola_feed_encolar(usuario->feed, post, afinidad);
 }
 
 post_t* usuario_ver_post(usuario_t* usuario) {
-	if (heap_esta_vacio(usuario->feed)) return NULL;
-	post_afinidad_t* post_afinidad = heap_desencolar(usuario->feed);
-	post_t* post = post_afinidad->post;
-	post_afinidad_destruir(post_afinidad);
-	return post;
+	return cola_feed_desencolar(usuario->feed);
+}
+
+post_t* usuario_ver_post_desde(usuario_t* usuario, const feed_t* feed) {
+	usuario_actualizar_cursor(usuario, feed);
+	size_t cant_autores = feed_cantidad_autores(feed);
+	if (!usuario_asegurar_lecturas(usuario, 1)) return NULL;
+	size_t limite_posterior = cant_autores > usuario->id ? cant_autores - usuario->id : 0;
+	ESTADISTICA(size_t cursor_inicial = usuario->cursor);
+	// Se recorren los autores por distancia creciente; a igual distancia va el post mas antiguo.
+	for (size_t d = usuario->cursor; d <= usuario->id || d < limite_posterior; d++) {
+		post_t* anterior = d <= usuario->id ? usuario_siguiente_de_autor(usuario, feed, usuario->id - d) : NULL;
+		post_t* posterior = usuario_siguiente_de_autor(usuario, feed, usuario->id + d);
+		if (!anterior && !posterior) continue;
+		usuario->cursor = d;
+		ESTADISTICA(histograma_agregar(&estadisticas.distancias_pull, d - cursor_inicial));
+		if (!posterior || (anterior && post_ver_id(anterior) < post_ver_id(posterior))) {
+			usuario_sumar_leido(usuario, usuario->id - d);
+			return anterior;
+		}
+		usuario_sumar_leido(usuario, usuario->id + d);
+		return posterior;
+	}
+	usuario->cursor = SIZE_MAX;
+	return NULL;
+}
+
+const char* usuario_ver_nombre(usuario_t* usuario) {
+	return usuario->nombre;
 }
 
 size_t usuario_obtener_id(usuario_t* usuario) {
 	return usuario->id;
 }
 
+#ifdef ESTADISTICAS
+size_t usuario_cantidad_feed(usuario_t* usuario) {
+	return cola_feed_cantidad(usuario->feed);
+}
+#endif
+
+void usuario_volcar(usuario_t* usuario, salida_t* salida) {
+	salida_entero(salida, usuario->cursor, INSTANTANEA_TAM_U64);
+	salida_entero(salida, usuario->visto_hasta, INSTANTANEA_TAM_U64);
+	salida_entero(salida, usuario->cant_lecturas, INSTANTANEA_TAM_U64);
+	for (size_t i = 0; i < usuario->tam_lecturas; i++) {
+		if (!usuario->lecturas[i].leidos) continue;
+		salida_entero(salida, usuario->lecturas[i].autor, INSTANTANEA_TAM_U64);
+		salida_entero(salida, usuario->lecturas[i].leidos, INSTANTANEA_TAM_U64);
+	}
+	cola_feed_volcar(usuario->feed, salida);
+}
+
+bool usuario_restaurar(usuario_t* usuario, lector_instantanea_t* lector, const tabla_posts_t* posts, size_t cant_ids) {
+	uint64_t cursor, visto_hasta, cant_autores;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, &cursor)) return false;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, &visto_hasta)) return false;
+	if (!instantanea_leer_entero(lector, INSTANTANEA_TAM_U64, &cant_autores)) return false;
+	const char* pares = instantanea_leer_arreglo(lector, cant_autores, 2 * INSTANTANEA_TAM_U64);
+	if (!pares || !usuario_asegurar_lecturas(usuario, cant_autores)) return false;
+	lector_instantanea_t lector_pares = { pares, pares + cant_autores * 2 * INSTANTANEA_TAM_U64 };
+	for (uint64_t i = 0; i < cant_autores; i++) {
+		uint64_t id, leidos;
+		instantanea_leer_entero(&lector_pares, INSTANTANEA_TAM_U64, &id);
+		instantanea_leer_entero(&lector_pares, INSTANTANEA_TAM_U64, &leidos);
+		if (id >= cant_ids || !leidos) return false;
+		lectura_t* lectura = buscar_lectura(usuario->lecturas, usuario->tam_lecturas, id);
+		if (lectura->leidos) return false;
+		lectura->autor = id;
+		lectura->leidos = leidos;
+		usuario->cant_lecturas++;
+	}
+	usuario->cursor = cursor;
+	usuario->visto_hasta = visto_hasta;
+	return cola_feed_restaurar(usuario->feed, lector, posts);
+}
+
 void usuario_destruir(usuario_t* usuario) {
-	heap_destruir(usuario->feed, post_afinidad_destruir);
+	cola_feed_destruir(usuario->feed);
+	free(usuario->lecturas);
 	free(usuario);
 }
@@ -4,6 +4,8 @@
 #include <stdlib.h>
 
 #include "post.h"
+#include "feed.h"
+#include "tabla_posts.h"
 
 
 /* ******************************************************************
@@ -17,8 +19,9 @@ typedef struct usuario usuario_t;
  *                    PRIMITIVAS DE USUARIO
  * *****************************************************************/
 
-/* PRE: Recibe el nombre del usuario y su ID.
- * POST: Devuelve el usuario que fue creado con dichas caracteristicas.
+/* PRE: Recibe el nombre internado del usuario (ver nombres.h) y su ID.
+ * POST: Devuelve el usuario que fue creado con dichas caracteristicas. El usuario no es
+ * dueño del nombre.
  */
 usuario_t* usuario_crear(const char* nombre, size_t id);
 
@@ -27,16 +30,50 @@ usuario_t* usuario_crear(const char* nombre, size_t id);
  */
 post_t* usuario_ver_post(usuario_t* usuario);
 
+/* PRE: Recibe un usuario previamente creado y el registro global de publicaciones.
+ * POST: Devuelve el post que sigue en el feed del usuario, calculado al momento a partir
+ * del registro, o NULL si no hay mas para ver. El orden es el mismo que el de usuario_ver_post:
+ * primero la mayor afinidad (menor distancia entre IDs) y, a igual afinidad, el post mas antiguo.
+ */
+post_t* usuario_ver_post_desde(usuario_t* usuario, const feed_t* feed);
+
 /* PRE: Recibe un usuario previamente creado, un post y la afinidad que tiene ese usuario con el posteador.
  * POST: Devuelve true si se pudo guardar el post en el feed del usuario, en caso contrario false.
  */
 bool usuario_guardar_feed(usuario_t* usuario, void* post, size_t afinidad);
 
+/* PRE: Recibe un usuario previamente creado.
+ * POST: Devuelve el nombre internado del usuario.
+ */
+const char* usuario_ver_nombre(usuario_t* usuario);
+
 /* PRE: Recibe un usuario previamente creado.
  * POST: Devuelve el ID del post.
  */
 size_t usuario_obtener_id(usuario_t* usuario);
 
+#ifdef ESTADISTICAS
+/* PRE: Recibe un usuario previamente creado.
+ * POST: Devuelve la cantidad de posts sin leer en su feed del modo push.
+ */
+size_t usuario_cantidad_feed(usuario_t* usuario);
+#endif
+
+/* PRE: Recibe un usuario previamente creado y la salida de una instantanea.
+ * POST: Se escribio el estado del feed del usuario: cursor u64, publicaciones consideradas
+ * u64, cantidad de autores de los que leyo posts u64 y, por cada uno (en cualquier orden), su
+ * ID u64 y la cantidad de posts leidos u64, para el modo pull, y su cola para el modo push (ver
+ * cola_feed_volcar).
+ */
+void usuario_volcar(usuario_t* usuario, salida_t* salida);
+
+/* PRE: Recibe un usuario recien creado, un lector posicionado donde se escribio un usuario con
+ * usuario_volcar, la tabla con los posts ya restaurados y una cota para los IDs de usuario.
+ * POST: Devuelve true si se restauro el estado del feed del usuario, o false si la instantanea
+ * no tiene un estado valido o no hay memoria.
+ */
+bool usuario_restaurar(usuario_t* usuario, lector_instantanea_t* lector, const tabla_posts_t* posts, size_t cant_ids);
+
 /* PRE: Recibe un usuario previamente creado.
  * POST: Destruye el usuario.
  */